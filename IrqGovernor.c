@@ -0,0 +1,285 @@
+/******************************************************************************
+ *
+ * Module: IrqGovernor
+ *
+ * File Name: IrqGovernor.c
+ *
+ * Description: Source file for the interrupt load governor (throttling of
+ *              the IRQs over their time budget).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "IrqGovernor.h"
+
+#if IRQGOVERNOR_ENABLE
+
+#include "SysTick.h"
+#include "SwTimer.h"
+
+#define IRQGOVERNOR_PERMILLE_MAX             0xFFFF
+
+typedef struct
+{
+    IsrStats_VectorType vector;
+    NVIC_IRQType irq;
+    uint16 budget;
+    uint8 held;                        /* Windows masked since the last throttle */
+    IrqGovernor_SourceStatsType stats;
+} IrqGovernor_SourceEntryType;
+
+static IrqGovernor_SourceEntryType g_IrqGovernorSources[IRQGOVERNOR_MAX_SOURCES];
+static IrqGovernor_SourceType g_IrqGovernorSourceCount = 0;
+static uint64 g_IrqGovernorLastRun[ISRSTATS_MAX_VECTORS];  /* Run cycles at the last sample */
+static uint64 g_IrqGovernorLastTime = 0;
+static uint16 g_IrqGovernorRelease = 0;
+static IrqGovernor_LoadType g_IrqGovernorLoad;
+static SwTimer_IdType g_IrqGovernorTimer = SWTIMER_INVALID_ID;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Share of a window in permille, clamped to 16 bits */
+static uint16 IrqGovernor_Permille(uint64 a_Cycles, uint64 a_Window)
+{
+    uint64 permille = (a_Cycles * 1000) / a_Window;
+
+    return (permille > IRQGOVERNOR_PERMILLE_MAX) ? IRQGOVERNOR_PERMILLE_MAX : (uint16)permille;
+}
+
+/*
+ * End of a window, in SysTick interrupt context: computes the share of each
+ * vector from the run cycles added since the last sample, masks the
+ * sources over budget and releases the ones held long enough once the
+ * load is low again.
+ */
+static void IrqGovernor_Sample(void *a_Context)
+{
+    uint64 delta[ISRSTATS_MAX_VECTORS];
+    uint64 total = 0;
+    uint64 now = SysTick_GetTicks();
+    uint64 window = now - g_IrqGovernorLastTime;
+    uint64 run;
+    IsrStats_VectorType vector;
+    IrqGovernor_SourceEntryType *source;
+    IrqGovernor_SourceType index;
+    uint16 load;
+
+    (void)a_Context;
+    if (window == 0)
+    {
+        return;
+    }
+    g_IrqGovernorLastTime = now;
+
+    for (vector = 0; vector < ISRSTATS_MAX_VECTORS; vector++)
+    {
+        run = IsrStats_GetRunCycles(vector);
+        delta[vector] = run - g_IrqGovernorLastRun[vector];
+        g_IrqGovernorLastRun[vector] = run;
+        total += delta[vector];
+    }
+
+    load = IrqGovernor_Permille(total, window);
+    g_IrqGovernorLoad.load = load;
+    if (load > g_IrqGovernorLoad.peakLoad)
+    {
+        g_IrqGovernorLoad.peakLoad = load;
+    }
+    g_IrqGovernorLoad.windows++;
+
+    for (index = 0; index < g_IrqGovernorSourceCount; index++)
+    {
+        source = &g_IrqGovernorSources[index];
+        source->stats.share = IrqGovernor_Permille(delta[source->vector], window);
+        if (source->stats.share > source->stats.peakShare)
+        {
+            source->stats.peakShare = source->stats.share;
+        }
+
+        if (!source->stats.throttled)
+        {
+            if (source->stats.share > source->budget)
+            {
+                NVIC_DisableIRQ(source->irq); // Its requests stay pending until the release
+                source->stats.throttled = TRUE;
+                source->stats.throttles++;
+                source->held = 0;
+            }
+        }
+        else
+        {
+            source->stats.throttledWindows++;
+            if (source->held < IRQGOVERNOR_HOLD_WINDOWS)
+            {
+                source->held++;
+            }
+            if ((source->held >= IRQGOVERNOR_HOLD_WINDOWS) && (load <= g_IrqGovernorRelease))
+            {
+                source->stats.throttled = FALSE;
+                NVIC_EnableIRQ(source->irq);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: IrqGovernor_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_WindowTicks - Window length in SysTick ticks
+ *             a_ReleasePermille - Interrupt load at or under which the
+ *             throttled IRQs are enabled again
+ * Return Value: FALSE if no software timer is free
+ * Description: Clears the sources and the statistics and starts sampling
+ * from SysTick_Handler, after IsrStats_Init.
+ *********************************************************************/
+boolean IrqGovernor_Init(uint32 a_WindowTicks, uint16 a_ReleasePermille)
+{
+    IsrStats_VectorType vector;
+
+    g_IrqGovernorSourceCount = 0;
+    g_IrqGovernorRelease = a_ReleasePermille;
+    g_IrqGovernorLoad.load = 0;
+    g_IrqGovernorLoad.peakLoad = 0;
+    g_IrqGovernorLoad.windows = 0;
+    for (vector = 0; vector < ISRSTATS_MAX_VECTORS; vector++)
+    {
+        g_IrqGovernorLastRun[vector] = IsrStats_GetRunCycles(vector);
+    }
+    g_IrqGovernorLastTime = SysTick_GetTicks();
+
+    if (g_IrqGovernorTimer == SWTIMER_INVALID_ID)
+    {
+        g_IrqGovernorTimer = SwTimer_Create(IrqGovernor_Sample, NULL_PTR);
+        if (g_IrqGovernorTimer == SWTIMER_INVALID_ID)
+        {
+            return FALSE;
+        }
+    }
+
+    return SwTimer_Start(g_IrqGovernorTimer, a_WindowTicks, SWTIMER_PERIODIC);
+}
+
+
+/**********************************************************************
+ * Service Name: IrqGovernor_Register
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Vector - IsrStats vector of the handler of the IRQ
+ *             a_IRQ - IRQ masked when over budget
+ *             a_BudgetPermille - Largest share of a window allowed
+ * Return Value: Source number, IRQGOVERNOR_INVALID_SOURCE when the table
+ * is full
+ * Description: Puts an IRQ under the governor, at start-up. The
+ * application must not enable or disable a governed IRQ itself.
+ *********************************************************************/
+IrqGovernor_SourceType IrqGovernor_Register(IsrStats_VectorType a_Vector, NVIC_IRQType a_IRQ, uint16 a_BudgetPermille)
+{
+    IrqGovernor_SourceEntryType *source;
+
+    if ((g_IrqGovernorSourceCount >= IRQGOVERNOR_MAX_SOURCES) || (a_Vector >= ISRSTATS_MAX_VECTORS))
+    {
+        return IRQGOVERNOR_INVALID_SOURCE;
+    }
+
+    source = &g_IrqGovernorSources[g_IrqGovernorSourceCount];
+    source->vector = a_Vector;
+    source->irq = a_IRQ;
+    source->budget = a_BudgetPermille;
+    source->held = 0;
+    source->stats.share = 0;
+    source->stats.peakShare = 0;
+    source->stats.throttles = 0;
+    source->stats.throttledWindows = 0;
+    source->stats.throttled = FALSE;
+    g_IrqGovernorSourceCount++; // Sampled from the next window on
+
+    return g_IrqGovernorSourceCount - 1;
+}
+
+
+/**********************************************************************
+ * Service Name: IrqGovernor_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Stops sampling and enables the throttled IRQs again.
+ *********************************************************************/
+void IrqGovernor_Stop(void)
+{
+    IrqGovernor_SourceType index;
+    NVIC_CriticalStateType state;
+
+    if (g_IrqGovernorTimer != SWTIMER_INVALID_ID)
+    {
+        SwTimer_Stop(g_IrqGovernorTimer);
+    }
+
+    //The timer no longer runs, but a sample may have started before the stop
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    for (index = 0; index < g_IrqGovernorSourceCount; index++)
+    {
+        if (g_IrqGovernorSources[index].stats.throttled)
+        {
+            g_IrqGovernorSources[index].stats.throttled = FALSE;
+            NVIC_EnableIRQ(g_IrqGovernorSources[index].irq);
+        }
+    }
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: IrqGovernor_GetSourceStats
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Source - Source number
+ *             a_Stats - Filled with a consistent copy of the statistics
+ * Return Value: FALSE if the source is not registered
+ * Description: Returns the load statistics of one governed IRQ.
+ *********************************************************************/
+boolean IrqGovernor_GetSourceStats(IrqGovernor_SourceType a_Source, IrqGovernor_SourceStatsType *a_Stats)
+{
+    NVIC_CriticalStateType state;
+
+    if (a_Source >= g_IrqGovernorSourceCount)
+    {
+        return FALSE;
+    }
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING); // Updated by the sample in SysTick_Handler
+    *a_Stats = g_IrqGovernorSources[a_Source].stats;
+    NVIC_ExitCritical(state);
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: IrqGovernor_GetLoad
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Load - Filled with a consistent copy of the statistics
+ * Return Value: None
+ * Description: Returns the interrupt load of all the instrumented
+ * vectors. Each cycle is charged to one vector only: a handler does not
+ * count the instrumented handlers nested in it.
+ *********************************************************************/
+void IrqGovernor_GetLoad(IrqGovernor_LoadType *a_Load)
+{
+    NVIC_CriticalStateType state;
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    *a_Load = g_IrqGovernorLoad;
+    NVIC_ExitCritical(state);
+}
+
+#endif /* IRQGOVERNOR_ENABLE */
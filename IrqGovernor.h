@@ -0,0 +1,147 @@
+/******************************************************************************
+ *
+ * Module: IrqGovernor
+ *
+ * File Name: IrqGovernor.h
+ *
+ * Description: Header file for the interrupt load governor. A periodic
+ *              software timer samples the run time kept by IsrStats at the
+ *              end of each window of SysTick ticks and computes the share
+ *              of the window taken by each instrumented vector. A governed
+ *              IRQ whose share goes over its budget is masked with
+ *              NVIC_DisableIRQ, and enabled again once it has been held for
+ *              IRQGOVERNOR_HOLD_WINDOWS windows and the whole interrupt load
+ *              has fallen to the release level (hysteresis). An interrupt
+ *              storm on a low-priority source then cannot starve the main
+ *              loop for more than a window. Everything compiles out unless
+ *              IRQGOVERNOR_ENABLE is set to 1; it needs ISRSTATS_ENABLE.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef IRQGOVERNOR_H_
+#define IRQGOVERNOR_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+#include "NVIC.h"
+#include "IsrStats.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+#ifndef IRQGOVERNOR_ENABLE
+#define IRQGOVERNOR_ENABLE                   0
+#endif
+
+#if IRQGOVERNOR_ENABLE && !ISRSTATS_ENABLE
+#error "IrqGovernor: the load is measured by IsrStats, set ISRSTATS_ENABLE to 1"
+#endif
+
+/* Number of governed IRQs */
+#ifndef IRQGOVERNOR_MAX_SOURCES
+#define IRQGOVERNOR_MAX_SOURCES              8
+#endif
+
+/* Windows a throttled IRQ stays masked at least */
+#ifndef IRQGOVERNOR_HOLD_WINDOWS
+#define IRQGOVERNOR_HOLD_WINDOWS             2
+#endif
+
+#define IRQGOVERNOR_INVALID_SOURCE           0xFF
+
+#if IRQGOVERNOR_ENABLE
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 IrqGovernor_SourceType;
+
+/* Shares and loads are in permille of a window */
+typedef struct
+{
+    uint16 share;                      /* Share of the last window */
+    uint16 peakShare;
+    uint32 throttles;                  /* Times the IRQ was masked */
+    uint32 throttledWindows;           /* Windows spent masked */
+    boolean throttled;
+} IrqGovernor_SourceStatsType;
+
+typedef struct
+{
+    uint16 load;                       /* All the instrumented vectors, last window */
+    uint16 peakLoad;
+    uint32 windows;                    /* Windows sampled */
+} IrqGovernor_LoadType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: IrqGovernor_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_WindowTicks - Window length in SysTick ticks
+ *             a_ReleasePermille - Interrupt load at or under which the
+ *             throttled IRQs are enabled again
+ * Return Value: FALSE if no software timer is free
+ * Description: Clears the sources and the statistics and starts sampling
+ * from SysTick_Handler, after IsrStats_Init.
+ *********************************************************************/
+boolean IrqGovernor_Init(uint32 a_WindowTicks, uint16 a_ReleasePermille);
+
+/**********************************************************************
+ * Service Name: IrqGovernor_Register
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Vector - IsrStats vector of the handler of the IRQ
+ *             a_IRQ - IRQ masked when over budget
+ *             a_BudgetPermille - Largest share of a window allowed
+ * Return Value: Source number, IRQGOVERNOR_INVALID_SOURCE when the table
+ * is full
+ * Description: Puts an IRQ under the governor, at start-up. The
+ * application must not enable or disable a governed IRQ itself.
+ *********************************************************************/
+IrqGovernor_SourceType IrqGovernor_Register(IsrStats_VectorType a_Vector, NVIC_IRQType a_IRQ, uint16 a_BudgetPermille);
+
+/**********************************************************************
+ * Service Name: IrqGovernor_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Stops sampling and enables the throttled IRQs again.
+ *********************************************************************/
+void IrqGovernor_Stop(void);
+
+/**********************************************************************
+ * Service Name: IrqGovernor_GetSourceStats
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Source - Source number
+ *             a_Stats - Filled with a consistent copy of the statistics
+ * Return Value: FALSE if the source is not registered
+ * Description: Returns the load statistics of one governed IRQ.
+ *********************************************************************/
+boolean IrqGovernor_GetSourceStats(IrqGovernor_SourceType a_Source, IrqGovernor_SourceStatsType *a_Stats);
+
+/**********************************************************************
+ * Service Name: IrqGovernor_GetLoad
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Load - Filled with a consistent copy of the statistics
+ * Return Value: None
+ * Description: Returns the interrupt load of all the instrumented
+ * vectors. Each cycle is charged to one vector only: a handler does not
+ * count the instrumented handlers nested in it.
+ *********************************************************************/
+void IrqGovernor_GetLoad(IrqGovernor_LoadType *a_Load);
+
+#endif /* IRQGOVERNOR_ENABLE */
+
+#endif /* IRQGOVERNOR_H_ */
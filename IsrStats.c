@@ -0,0 +1,400 @@
+/******************************************************************************
+ *
+ * Module: IsrStats
+ *
+ * File Name: IsrStats.c
+ *
+ * Description: Source file for the optional interrupt instrumentation
+ *              (latency and run time statistics per vector).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "IsrStats.h"
+
+#if ISRSTATS_ENABLE
+
+#include "NVIC.h"
+#include "SysTick.h"
+#include "Mcu_Registers.h"
+
+#define DWT_CTRL_CYCCNTENA                   0x00000001
+#define CORE_DEMCR_TRCENA                    0x01000000
+
+#if ISRSTATS_USE_DWT
+#define ISRSTATS_NOW()                       ((uint32)DWT_CYCCNT_REG)
+#else
+#define ISRSTATS_NOW()                       ((uint32)SysTick_GetTicks())
+#endif
+
+typedef struct
+{
+    uint32 count;
+    uint32 latencyCount;
+    uint32 latencyMin;
+    uint32 latencyMax;
+    uint64 latencySum;
+    uint32 runCount;                /* Exits with a measured run time */
+    uint32 runMin;
+    uint32 runMax;
+    uint64 runSum;
+    uint32 histogram[ISRSTATS_HISTOGRAM_BINS];
+    uint32 requestTime;             /* Time stamp given by IsrStats_MarkRequest */
+    boolean requestMarked;
+} IsrStats_VectorStatsType;
+
+/* One frame per instrumented handler running, the innermost last */
+typedef struct
+{
+    uint32 entryTime;               /* Time stamp of the handler entry */
+    uint32 childCycles;             /* Time spent in the handlers nested in it */
+    IsrStats_VectorType vector;
+} IsrStats_FrameType;
+
+static IsrStats_VectorStatsType g_IsrStatsTable[ISRSTATS_MAX_VECTORS];
+static IsrStats_FrameType g_IsrStatsFrames[ISRSTATS_MAX_NESTING];
+static uint8 g_IsrStatsDepth = 0;   /* Handlers entered and not exited, may exceed ISRSTATS_MAX_NESTING */
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Histogram bin of a latency: number of significant bits, clamped to the last bin */
+static uint8 IsrStats_Bin(uint32 a_Cycles)
+{
+    uint8 bin = 0;
+
+    if (a_Cycles >= (1UL << 16))
+    {
+        return ISRSTATS_HISTOGRAM_BINS - 1;
+    }
+    if (a_Cycles >= (1UL << 8))
+    {
+        bin += 8;
+        a_Cycles >>= 8;
+    }
+    if (a_Cycles >= (1UL << 4))
+    {
+        bin += 4;
+        a_Cycles >>= 4;
+    }
+    if (a_Cycles >= (1UL << 2))
+    {
+        bin += 2;
+        a_Cycles >>= 2;
+    }
+    if (a_Cycles >= (1UL << 1))
+    {
+        bin += 1;
+        a_Cycles >>= 1;
+    }
+    bin += (uint8)a_Cycles;
+
+    return (bin > (ISRSTATS_HISTOGRAM_BINS - 1)) ? (ISRSTATS_HISTOGRAM_BINS - 1) : bin;
+}
+
+static void IsrStats_Clear(IsrStats_VectorStatsType *a_Stats)
+{
+    uint8 bin;
+
+    a_Stats->count = 0;
+    a_Stats->latencyCount = 0;
+    a_Stats->latencyMin = 0xFFFFFFFFUL;
+    a_Stats->latencyMax = 0;
+    a_Stats->latencySum = 0;
+    a_Stats->runCount = 0;
+    a_Stats->runMin = 0xFFFFFFFFUL;
+    a_Stats->runMax = 0;
+    a_Stats->runSum = 0;
+    for (bin = 0; bin < ISRSTATS_HISTOGRAM_BINS; bin++)
+    {
+        a_Stats->histogram[bin] = 0;
+    }
+    a_Stats->requestMarked = FALSE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: IsrStats_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Starts the DWT cycle counter (ISRSTATS_USE_DWT) and clears
+ * the statistics of every vector.
+ *********************************************************************/
+void IsrStats_Init(void)
+{
+    IsrStats_VectorType vector;
+
+#if ISRSTATS_USE_DWT
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA; // Power the DWT unit
+    DWT_CYCCNT_REG = 0;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA; // Start the cycle counter
+#endif
+
+    g_IsrStatsDepth = 0;
+    for (vector = 0; vector < ISRSTATS_MAX_VECTORS; vector++)
+    {
+        IsrStats_Reset(vector);
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_MarkRequest
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: None
+ * Description: Records now as the request time of the next interrupt of
+ * the vector, e.g. just before pending it by software. The next
+ * IsrStats_Enter without a latency uses it.
+ *********************************************************************/
+void IsrStats_MarkRequest(IsrStats_VectorType a_Vector)
+{
+    if (a_Vector < ISRSTATS_MAX_VECTORS)
+    {
+        g_IsrStatsTable[a_Vector].requestTime = ISRSTATS_NOW();
+        g_IsrStatsTable[a_Vector].requestMarked = TRUE;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_Enter
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ *             a_Latency - Cycles since the interrupt request, or
+ *             ISRSTATS_NO_LATENCY
+ * Return Value: None
+ * Description: Called first thing in the handler (ISRSTATS_ENTER).
+ *********************************************************************/
+void IsrStats_Enter(IsrStats_VectorType a_Vector, uint32 a_Latency)
+{
+    IsrStats_VectorStatsType *stats;
+    NVIC_CriticalStateType state;
+    uint32 now;
+
+    if (a_Vector >= ISRSTATS_MAX_VECTORS)
+    {
+        return;
+    }
+
+    //A handler preempting the push would land its time in the wrong frame
+    state = NVIC_EnterCritical(0);
+    now = ISRSTATS_NOW();
+    if (g_IsrStatsDepth < ISRSTATS_MAX_NESTING)
+    {
+        g_IsrStatsFrames[g_IsrStatsDepth].entryTime = now;
+        g_IsrStatsFrames[g_IsrStatsDepth].childCycles = 0;
+        g_IsrStatsFrames[g_IsrStatsDepth].vector = a_Vector;
+    }
+    g_IsrStatsDepth++;
+    NVIC_ExitCritical(state);
+
+    stats = &g_IsrStatsTable[a_Vector];
+    stats->count++;
+
+    if ((a_Latency == ISRSTATS_NO_LATENCY) && stats->requestMarked)
+    {
+        a_Latency = now - stats->requestTime;
+        stats->requestMarked = FALSE;
+    }
+    if (a_Latency != ISRSTATS_NO_LATENCY)
+    {
+        stats->latencyCount++;
+        stats->latencySum += a_Latency;
+        if (a_Latency < stats->latencyMin)
+        {
+            stats->latencyMin = a_Latency;
+        }
+        if (a_Latency > stats->latencyMax)
+        {
+            stats->latencyMax = a_Latency;
+        }
+        stats->histogram[IsrStats_Bin(a_Latency)]++;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_Exit
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: None
+ * Description: Called last thing in the handler (ISRSTATS_EXIT), records
+ * the run time since IsrStats_Enter less the time spent in the
+ * instrumented handlers nested in it.
+ *********************************************************************/
+void IsrStats_Exit(IsrStats_VectorType a_Vector)
+{
+    IsrStats_VectorStatsType *stats;
+    NVIC_CriticalStateType state;
+    IsrStats_FrameType frame;
+    uint32 elapsed;
+    uint32 run;
+
+    if ((a_Vector >= ISRSTATS_MAX_VECTORS) || (g_IsrStatsDepth == 0))
+    {
+        return;
+    }
+
+    state = NVIC_EnterCritical(0);
+    g_IsrStatsDepth--;
+    if (g_IsrStatsDepth >= ISRSTATS_MAX_NESTING)
+    {
+        NVIC_ExitCritical(state);
+        return; // Entered too deep to have a frame, its time stays in the parent
+    }
+    frame = g_IsrStatsFrames[g_IsrStatsDepth];
+    elapsed = ISRSTATS_NOW() - frame.entryTime;
+    if (g_IsrStatsDepth != 0)
+    {
+        g_IsrStatsFrames[g_IsrStatsDepth - 1].childCycles += elapsed; // Not part of the parent's run time
+    }
+    NVIC_ExitCritical(state);
+
+    if (frame.vector != a_Vector)
+    {
+        return; // Unbalanced hooks, the frame is not this handler's
+    }
+
+    stats = &g_IsrStatsTable[a_Vector];
+    run = elapsed - frame.childCycles;
+    stats->runCount++;
+    stats->runSum += run;
+    if (run < stats->runMin)
+    {
+        stats->runMin = run;
+    }
+    if (run > stats->runMax)
+    {
+        stats->runMax = run;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_GetSummary
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ *             a_Summary - Filled with a consistent copy of the statistics
+ * Return Value: FALSE if the vector is out of range
+ * Description: Returns the statistics of one vector with the means
+ * computed.
+ *********************************************************************/
+boolean IsrStats_GetSummary(IsrStats_VectorType a_Vector, IsrStats_SummaryType *a_Summary)
+{
+    IsrStats_VectorStatsType copy;
+    NVIC_CriticalStateType state;
+    uint8 bin;
+
+    if (a_Vector >= ISRSTATS_MAX_VECTORS)
+    {
+        return FALSE;
+    }
+
+    state = NVIC_EnterCritical(0); // Any instrumented handler may update the entry
+    copy = g_IsrStatsTable[a_Vector];
+    NVIC_ExitCritical(state);
+
+    a_Summary->count = copy.count;
+    a_Summary->latencyCount = copy.latencyCount;
+    a_Summary->latencyMin = (copy.latencyCount != 0) ? copy.latencyMin : 0;
+    a_Summary->latencyMax = copy.latencyMax;
+    a_Summary->latencyMean = (copy.latencyCount != 0) ? (uint32)(copy.latencySum / copy.latencyCount) : 0;
+    a_Summary->runMin = (copy.runCount != 0) ? copy.runMin : 0;
+    a_Summary->runMax = copy.runMax;
+    a_Summary->runMean = (copy.runCount != 0) ? (uint32)(copy.runSum / copy.runCount) : 0;
+    for (bin = 0; bin < ISRSTATS_HISTOGRAM_BINS; bin++)
+    {
+        a_Summary->histogram[bin] = copy.histogram[bin];
+    }
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_GetRunCycles
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: Cycles spent in the handler since the last reset (0 if
+ * the vector is out of range)
+ * Description: Total run time of a vector, the instrumented handlers
+ * nested in it left out. Two reads give the load of the vector in
+ * between.
+ *********************************************************************/
+uint64 IsrStats_GetRunCycles(IsrStats_VectorType a_Vector)
+{
+    NVIC_CriticalStateType state;
+    uint64 cycles;
+
+    if (a_Vector >= ISRSTATS_MAX_VECTORS)
+    {
+        return 0;
+    }
+
+    state = NVIC_EnterCritical(0); // The 64-bit sum is updated by the handler
+    cycles = g_IsrStatsTable[a_Vector].runSum;
+    NVIC_ExitCritical(state);
+
+    return cycles;
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_Dump
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Function called with the summary of each vector
+ *             that has been entered at least once
+ * Return Value: None
+ * Description: Walks the statistics table, to print or log it from
+ * thread code.
+ *********************************************************************/
+void IsrStats_Dump(IsrStats_DumpCallBackType Ptr2Func)
+{
+    IsrStats_SummaryType summary;
+    IsrStats_VectorType vector;
+
+    for (vector = 0; vector < ISRSTATS_MAX_VECTORS; vector++)
+    {
+        if (IsrStats_GetSummary(vector, &summary) && (summary.count != 0))
+        {
+            (*Ptr2Func)(vector, &summary);
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: IsrStats_Reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: None
+ * Description: Clears the statistics of one vector.
+ *********************************************************************/
+void IsrStats_Reset(IsrStats_VectorType a_Vector)
+{
+    NVIC_CriticalStateType state;
+
+    if (a_Vector < ISRSTATS_MAX_VECTORS)
+    {
+        state = NVIC_EnterCritical(0);
+        IsrStats_Clear(&g_IsrStatsTable[a_Vector]);
+        NVIC_ExitCritical(state);
+    }
+}
+
+#endif /* ISRSTATS_ENABLE */
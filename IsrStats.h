@@ -0,0 +1,198 @@
+/******************************************************************************
+ *
+ * Module: IsrStats
+ *
+ * File Name: IsrStats.h
+ *
+ * Description: Header file for the optional interrupt instrumentation. Each
+ *              instrumented handler records its latency (time from the
+ *              interrupt request to the handler entry) and its run time in a
+ *              fixed per-vector table. The run time of a handler leaves
+ *              out the instrumented handlers nested in it. Everything
+ *              compiles out unless ISRSTATS_ENABLE is set to 1.
+ *
+ *              Only SysTick_Handler is instrumented by the drivers.
+ *              NVIC_RegisterHandler installs the handler itself in the
+ *              vector table, without a wrapper: a registered handler that
+ *              should be measured places ISRSTATS_ENTER/ISRSTATS_EXIT
+ *              itself, with a slot of its own from 1 to
+ *              ISRSTATS_MAX_VECTORS - 1.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef ISRSTATS_H_
+#define ISRSTATS_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+#ifndef ISRSTATS_ENABLE
+#define ISRSTATS_ENABLE                      0
+#endif
+
+/* Time stamps from the DWT cycle counter (1) or from SysTick_GetTicks (0, for
+ * cores without DWT; then only handlers below SysTick are measured right) */
+#ifndef ISRSTATS_USE_DWT
+#define ISRSTATS_USE_DWT                     1
+#endif
+
+/* Number of instrumented vectors, slot 0 is SysTick_Handler */
+#ifndef ISRSTATS_MAX_VECTORS
+#define ISRSTATS_MAX_VECTORS                 8
+#endif
+
+#define ISRSTATS_SYSTICK_VECTOR              0
+
+/* Instrumented handlers nested at most; deeper ones are counted but their
+ * run time is left in the handler they preempted */
+#ifndef ISRSTATS_MAX_NESTING
+#define ISRSTATS_MAX_NESTING                 8
+#endif
+
+/* Latency histogram: bin 0 counts 0 cycles, bin k counts [2^(k-1), 2^k) cycles,
+ * the last bin takes everything above */
+#define ISRSTATS_HISTOGRAM_BINS              16
+
+/* Passed to IsrStats_Enter when the request time of the interrupt is unknown */
+#define ISRSTATS_NO_LATENCY                  0xFFFFFFFFUL
+
+/* Hooks placed at the entry and the exit of an instrumented handler */
+#if ISRSTATS_ENABLE
+#define ISRSTATS_ENTER(Vector, Latency)      IsrStats_Enter((Vector), (Latency))
+#define ISRSTATS_EXIT(Vector)                IsrStats_Exit(Vector)
+#else
+#define ISRSTATS_ENTER(Vector, Latency)
+#define ISRSTATS_EXIT(Vector)
+#endif
+
+#if ISRSTATS_ENABLE
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 IsrStats_VectorType;
+
+typedef struct
+{
+    uint32 count;                      /* Handler entries */
+    uint32 latencyCount;               /* Entries with a known request time */
+    uint32 latencyMin;
+    uint32 latencyMax;
+    uint32 latencyMean;
+    uint32 runMin;
+    uint32 runMax;
+    uint32 runMean;
+    uint32 histogram[ISRSTATS_HISTOGRAM_BINS];
+} IsrStats_SummaryType;
+
+typedef void (*IsrStats_DumpCallBackType)(IsrStats_VectorType a_Vector, const IsrStats_SummaryType *a_Summary);
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: IsrStats_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Starts the DWT cycle counter (ISRSTATS_USE_DWT) and clears
+ * the statistics of every vector.
+ *********************************************************************/
+void IsrStats_Init(void);
+
+/**********************************************************************
+ * Service Name: IsrStats_MarkRequest
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: None
+ * Description: Records now as the request time of the next interrupt of
+ * the vector, e.g. just before pending it by software. The next
+ * IsrStats_Enter without a latency uses it.
+ *********************************************************************/
+void IsrStats_MarkRequest(IsrStats_VectorType a_Vector);
+
+/**********************************************************************
+ * Service Name: IsrStats_Enter
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ *             a_Latency - Cycles since the interrupt request, or
+ *             ISRSTATS_NO_LATENCY
+ * Return Value: None
+ * Description: Called first thing in the handler (ISRSTATS_ENTER).
+ *********************************************************************/
+void IsrStats_Enter(IsrStats_VectorType a_Vector, uint32 a_Latency);
+
+/**********************************************************************
+ * Service Name: IsrStats_Exit
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: None
+ * Description: Called last thing in the handler (ISRSTATS_EXIT), records
+ * the run time since IsrStats_Enter less the time spent in the
+ * instrumented handlers nested in it.
+ *********************************************************************/
+void IsrStats_Exit(IsrStats_VectorType a_Vector);
+
+/**********************************************************************
+ * Service Name: IsrStats_GetSummary
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ *             a_Summary - Filled with a consistent copy of the statistics
+ * Return Value: FALSE if the vector is out of range
+ * Description: Returns the statistics of one vector with the means
+ * computed.
+ *********************************************************************/
+boolean IsrStats_GetSummary(IsrStats_VectorType a_Vector, IsrStats_SummaryType *a_Summary);
+
+/**********************************************************************
+ * Service Name: IsrStats_GetRunCycles
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: Cycles spent in the handler since the last reset (0 if
+ * the vector is out of range)
+ * Description: Total run time of a vector, the instrumented handlers
+ * nested in it left out. Two reads give the load of the vector in
+ * between.
+ *********************************************************************/
+uint64 IsrStats_GetRunCycles(IsrStats_VectorType a_Vector);
+
+/**********************************************************************
+ * Service Name: IsrStats_Dump
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Function called with the summary of each vector
+ *             that has been entered at least once
+ * Return Value: None
+ * Description: Walks the statistics table, to print or log it from
+ * thread code.
+ *********************************************************************/
+void IsrStats_Dump(IsrStats_DumpCallBackType Ptr2Func);
+
+/**********************************************************************
+ * Service Name: IsrStats_Reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Vector - Instrumented vector
+ * Return Value: None
+ * Description: Clears the statistics of one vector.
+ *********************************************************************/
+void IsrStats_Reset(IsrStats_VectorType a_Vector);
+
+#endif /* ISRSTATS_ENABLE */
+
+#endif /* ISRSTATS_H_ */
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ * Module: MCU Registers
+ *
+ * File Name: Mcu_Registers.h
+ *
+ * Description: Register backend selection for the NVIC and SysTick drivers.
+ *              The target build maps the registers on the TM4C123GH6PM memory
+ *              map, the host build (TM4C_HOST_SIM defined) maps them on the
+ *              simulated register file of the RegSim module.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef MCU_REGISTERS_H_
+#define MCU_REGISTERS_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+#ifdef TM4C_HOST_SIM
+#ifndef __cplusplus
+#error "The simulated register backend needs the drivers to be compiled as C++"
+#endif
+#include "RegSim.h"
+#else
+#include "tm4c123gh6pm_registers.h"
+#endif
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+#ifndef TM4C_HOST_SIM
+
+#define NVIC_EN_BASE_ADDRESS                 0xE000E100
+#define NVIC_DIS_BASE_ADDRESS                0xE000E180
+#define NVIC_PEND_BASE_ADDRESS               0xE000E200
+#define NVIC_UNPEND_BASE_ADDRESS             0xE000E280
+#define NVIC_ACTIVE_BASE_ADDRESS             0xE000E300
+#define NVIC_PRI_BASE_ADDRESS                0xE000E400
+
+/* Interrupt Control and State register (ICSR) */
+#ifndef NVIC_SYSTEM_INTCTRL
+#define NVIC_SYSTEM_INTCTRL                  (*((volatile uint32 *)0xE000ED04))
+#endif
+
+/* Vector Table Offset register (VTABLE) */
+#ifndef NVIC_VTABLE_REG
+#define NVIC_VTABLE_REG                      (*((volatile uint32 *)0xE000ED08))
+#endif
+
+/* Application Interrupt and Reset Control register (APINT) */
+#ifndef NVIC_APINT_REG
+#define NVIC_APINT_REG                       (*((volatile uint32 *)0xE000ED0C))
+#endif
+
+/* DWT cycle counter (CYCCNT counts while TRCENA and CYCCNTENA are set) */
+#ifndef DWT_CTRL_REG
+#define DWT_CTRL_REG                         (*((volatile uint32 *)0xE0001000))
+#endif
+#ifndef DWT_CYCCNT_REG
+#define DWT_CYCCNT_REG                       (*((volatile uint32 *)0xE0001004))
+#endif
+#ifndef CORE_DEMCR_REG
+#define CORE_DEMCR_REG                       (*((volatile uint32 *)0xE000EDFC))
+#endif
+
+/* Software Trigger Interrupt register (SWTRIG) */
+#ifndef NVIC_SWTRIG_REG
+#define NVIC_SWTRIG_REG                      (*((volatile uint32 *)0xE000EF00))
+#endif
+
+/* Indexed access to the NVIC register banks (n is the register number inside the bank) */
+#define NVIC_EN_REG(n)                       (*((volatile uint32 *)NVIC_EN_BASE_ADDRESS + (n)))
+#define NVIC_DIS_REG(n)                      (*((volatile uint32 *)NVIC_DIS_BASE_ADDRESS + (n)))
+#define NVIC_PEND_REG(n)                     (*((volatile uint32 *)NVIC_PEND_BASE_ADDRESS + (n)))
+#define NVIC_UNPEND_REG(n)                   (*((volatile uint32 *)NVIC_UNPEND_BASE_ADDRESS + (n)))
+#define NVIC_ACTIVE_REG(n)                   (*((volatile uint32 *)NVIC_ACTIVE_BASE_ADDRESS + (n)))
+#define NVIC_PRI_REG(n)                      (*((volatile uint32 *)NVIC_PRI_BASE_ADDRESS + (n)))
+
+/* Byte access to one priority field: the PRIn and SYSPRIn registers accept
+ * byte stores (SYSPRI1 starts at vector 4) */
+#define NVIC_PRI_BYTE_REG(IRQ_Num)           (*((volatile uint8 *)NVIC_PRI_BASE_ADDRESS + (IRQ_Num)))
+#define NVIC_SYSTEM_PRI_BYTE_REG(Vector)     (*((volatile uint8 *)0xE000ED18 + ((Vector) - 4)))
+
+#endif /* TM4C_HOST_SIM */
+
+#endif /* MCU_REGISTERS_H_ */
@@ -1,246 +1,1344 @@
-/******************************************************************************
- *
- * Module: NVIC
- *
- * File Name: NVIC.c
- *
- * Description: Source file for the ARM Cortex M4 NVIC driver
- *
- * Author: Saraa Gomaa
- *
- *******************************************************************************/
-
-#include "NVIC.h"
-#include "tm4c123gh6pm_registers.h"
-
-/*******************************************************************************
- *                           Function Definitions                              *
- *******************************************************************************/
-/**********************************************************************
- * Service Name: NVIC_EnableIRQ
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: IRQ_Num - IRQ number to be enabled
- * Return Value: None
- * Description: Function to enable the interrupt request for the specified IRQ.
- *********************************************************************/
-void NVIC_EnableIRQ(NVIC_IRQType IRQ_Num)
-{
-    if (IRQ_Num < 32)
-    {
-        NVIC_EN0_REG |= (1 << IRQ_Num); //Enable IRQ in NVIC Enable Register 0
-    }
-    else if (IRQ_Num < 64)
-    {
-        NVIC_EN1_REG |= (1 << (IRQ_Num - 32)); //Enable IRQ in NVIC Enable Register 1
-    }
-    else if (IRQ_Num < 96)
-    {
-        NVIC_EN2_REG |= (1 << (IRQ_Num - 64)); //Enable IRQ in NVIC Enable Register 2
-    }
-    else if (IRQ_Num < 128)
-    {
-        NVIC_EN3_REG |= (1 << (IRQ_Num - 96)); //Enable IRQ in NVIC Enable Register 3
-    }
-    else
-    {
-        //Handle the error or unsupported IRQ number
-    }
-}
-
-/**********************************************************************
- * Service Name: NVIC_DisableIRQ
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: IRQ_Num - IRQ number to be disabled
- * Return Value: None
- * Description: Function to disable the interrupt request for the specified IRQ.
- *********************************************************************/
-void NVIC_DisableIRQ(NVIC_IRQType IRQ_Num)
-{
-    if (IRQ_Num < 32)
-        {
-            NVIC_DIS0_REG |= (1 << IRQ_Num); //Disable IRQ in NVIC Disable Register 0
-        }
-        else if (IRQ_Num < 64)
-        {
-            NVIC_DIS1_REG |= (1 << (IRQ_Num - 32)); //Disable IRQ in NVIC Disable Register 1
-        }
-        else if (IRQ_Num < 96)
-        {
-            NVIC_DIS2_REG |= (1 << (IRQ_Num - 64)); //Disable IRQ in NVIC Disable Register 2
-        }
-        else if (IRQ_Num < 128)
-        {
-            NVIC_DIS3_REG |= (1 << (IRQ_Num - 96)); //Disable IRQ in NVIC Disable Register 3
-        }
-        else
-        {
-            //Handle the error or unsupported IRQ number
-        }
-}
-
-
-/**********************************************************************
- * Service Name: NVIC_SetPriorityIRQ
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: IRQ_Num - IRQ number for which priority is to be set
- *             IRQ_Priority - Priority level to be assigned to the specified IRQ
- * Return Value: None
- * Description: Function to set the priority level for the specified IRQ.
- *********************************************************************/
-void NVIC_SetPriorityIRQ(NVIC_IRQType IRQ_Num, NVIC_IRQPriorityType IRQ_Priority)
-{
-        //Determine which NVIC priority register to use
-        uint8 registerIndex = IRQ_Num / 4; //Each priority register handles 4 IRQs
-        uint8 irqPos = IRQ_Num % 4; //Position within the register (0 to 3)
-        //Base address of the NVIC priority registers
-        volatile uint32 *NVIC_PRI_REG = (volatile uint32 *)0xE000E400;
-        //Calculate the specific priority register address
-        volatile uint32 *targetReg = NVIC_PRI_REG + registerIndex;
-        //Determine bit offset based on IRQ position within the register
-        uint8 bitOffset = 0;
-        switch (irqPos)
-        {
-            case 0: //INTA (Bits 5 to 7)
-                bitOffset = 5;
-                break;
-            case 1: //INTB (Bits 13 to 15)
-                bitOffset = 13;
-                break;
-            case 2: //INTC (Bits 21 to 23)
-                bitOffset = 21;
-                break;
-            case 3: //INTD (Bits 29 to 31)
-                bitOffset = 29;
-                break;
-        }
-        //Mask to clear the 3 bits for the specific IRQ
-        uint32 mask = 0x7; // Mask for 3 bits of priority
-        //Clear the bits for the specific IRQ
-        *targetReg = (*targetReg & ~(mask << bitOffset));
-        //Set the new priority for the IRQ
-        *targetReg |= (IRQ_Priority << bitOffset);
-}
-
-
-/**********************************************************************
- * Service Name: NVIC_EnableException
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Exception_Num - Exception number to be enabled
- * Return Value: None
- * Description: Function to enable the specified exception in the NVIC.
- *********************************************************************/
-void NVIC_EnableException(NVIC_ExceptionType Exception_Num)
-{
-    /*
-     * Check the type of exception specified by Exception_Num.
-     * Depending on the exception type, set the corresponding bit in the
-     * System Handler Control and State Register (SYSHNDCTRL) to enable the
-     * Exception handling.
-     */
-    switch (Exception_Num)
-    {
-        case EXCEPTION_MEM_FAULT_TYPE:
-            //Enable memory management fault exception
-            NVIC_SYSTEM_SYSHNDCTRL |= MEM_FAULT_ENABLE_MASK;
-            break;
-        case EXCEPTION_BUS_FAULT_TYPE:
-            //Enable bus fault exception
-            NVIC_SYSTEM_SYSHNDCTRL |= BUS_FAULT_ENABLE_MASK;
-            break;
-        case EXCEPTION_USAGE_FAULT_TYPE:
-            //Enable usage fault exception
-            NVIC_SYSTEM_SYSHNDCTRL |= USAGE_FAULT_ENABLE_MASK;
-            break;
-        default:
-            /* Other exceptions cannot be enabled/disabled */
-            break;
-    }
-}
-
-
-/**********************************************************************
- * Service Name: NVIC_DisableException
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Exception_Num - Exception number to be disabled
- * Return Value: None
- * Description: Function to disable the specified exception in the NVIC.
- *********************************************************************/
-void NVIC_DisableException(NVIC_ExceptionType Exception_Num)
-{
-    switch (Exception_Num)
-    {
-        case EXCEPTION_MEM_FAULT_TYPE:
-            //Disable memory management fault exception
-            NVIC_SYSTEM_SYSHNDCTRL &= ~MEM_FAULT_ENABLE_MASK;
-            break;
-        case EXCEPTION_BUS_FAULT_TYPE:
-            //Disable bus fault exception
-            NVIC_SYSTEM_SYSHNDCTRL &= ~BUS_FAULT_ENABLE_MASK;
-            break;
-        case EXCEPTION_USAGE_FAULT_TYPE:
-            //Disable usage fault exception
-            NVIC_SYSTEM_SYSHNDCTRL &= ~USAGE_FAULT_ENABLE_MASK;
-            break;
-        default:
-            /* Other exceptions cannot be enabled/disabled */
-            break;
-    }
-}
-
-
-/**********************************************************************
- * Service Name: NVIC_SetPriorityException
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Exception_Num - Exception number for which priority is to be set
- *             Exception_Priority - Priority level to be assigned to the specified exception
- * Return Value: None
- * Description: Function to set the priority level for the specified exception.
- *********************************************************************/
-void NVIC_SetPriorityException(NVIC_ExceptionType Exception_Num, NVIC_ExceptionPriorityType Exception_Priority)
-{
-    /*
-     * Check the type of exception specified by Exception_Num.
-     * Depending on the exception type, set the priority by modifying
-     * The corresponding priority register.
-     */
-    switch (Exception_Num)
-    {
-        case EXCEPTION_MEM_FAULT_TYPE:
-            //Set the priority for memory management fault exception
-            NVIC_SYSTEM_PRI1_REG = (NVIC_SYSTEM_PRI1_REG & ~MEM_FAULT_PRIORITY_MASK) | (Exception_Priority << MEM_FAULT_PRIORITY_BITS_POS);
-            break;
-        case EXCEPTION_BUS_FAULT_TYPE:
-            //Set the priority for bus fault exception
-            NVIC_SYSTEM_PRI1_REG = (NVIC_SYSTEM_PRI1_REG & ~BUS_FAULT_PRIORITY_MASK) | (Exception_Priority << BUS_FAULT_PRIORITY_BITS_POS);
-            break;
-        case EXCEPTION_USAGE_FAULT_TYPE:
-            //Set the priority for usage fault exception
-            NVIC_SYSTEM_PRI1_REG = (NVIC_SYSTEM_PRI1_REG & ~USAGE_FAULT_PRIORITY_MASK) | (Exception_Priority << USAGE_FAULT_PRIORITY_BITS_POS);
-            break;
-        case EXCEPTION_SVC_TYPE:
-            //Set the priority for supervisor call (SVC) exception
-            NVIC_SYSTEM_PRI2_REG = (NVIC_SYSTEM_PRI2_REG & ~SVC_PRIORITY_MASK) | (Exception_Priority << SVC_PRIORITY_BITS_POS);
-            break;
-        case EXCEPTION_DEBUG_MONITOR_TYPE:
-            //Set the priority for debug monitor exception
-            NVIC_SYSTEM_PRI3_REG = (NVIC_SYSTEM_PRI3_REG & ~DEBUG_MONITOR_PRIORITY_MASK) | (Exception_Priority << DEBUG_MONITOR_PRIORITY_BITS_POS);
-            break;
-        case EXCEPTION_PEND_SV_TYPE:
-            //Set the priority for PendSV (pendable service call) exception
-            NVIC_SYSTEM_PRI3_REG = (NVIC_SYSTEM_PRI3_REG & ~PENDSV_PRIORITY_MASK) | (Exception_Priority << PENDSV_PRIORITY_BITS_POS);
-            break;
-        case EXCEPTION_SYSTICK_TYPE:
-            //Set the priority for SysTick timer exception
-            NVIC_SYSTEM_PRI3_REG = (NVIC_SYSTEM_PRI3_REG & ~SYSTICK_PRIORITY_MASK) | (Exception_Priority << SYSTICK_PRIORITY_BITS_POS);
-            break;
-        default:
-            /* Other exceptions cannot have their priority set */
-            break;
-    }
-}
+/******************************************************************************
+ *
+ * Module: NVIC
+ *
+ * File Name: NVIC.c
+ *
+ * Description: Source file for the ARM Cortex M4 NVIC driver
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "NVIC.h"
+#include "Mcu_Registers.h"
+
+/* BASEPRI value of a priority ceiling (3 implemented bits at the top of the byte) */
+#define NVIC_CEILING_TO_BASEPRI(Ceiling)     (((uint32)(Ceiling) & 0x7) << 5)
+
+/* APINT: writes are ignored without the key, bits 2:0 must be written 0 */
+#define NVIC_APINT_VECTKEY                   0x05FA0000
+#define NVIC_APINT_PRIGROUP_MASK             0x00000700
+#define NVIC_APINT_PRIGROUP_BITS_POS         8
+
+/* Implemented bits of the PRIn registers */
+#define NVIC_PRI_IMPLEMENTED                 NVIC_PRI_WORD(0x7, 0x7, 0x7, 0x7)
+
+/* INTCTRL: number of the exception being run, 0 in thread mode */
+#define NVIC_INTCTRL_VECACT_MASK             0x000000FF
+#define NVIC_FIRST_IRQ_VECTOR                16
+
+/* Vector number of each NVIC_ExceptionType */
+static const uint8 g_NvicExceptionVector[] = {1, 2, 3, 4, 5, 6, 11, 12, 14, 15};
+
+/* SYSPRIn register (1 to 3, 0 if the priority is fixed) and field position of each NVIC_ExceptionType */
+static const uint8 g_NvicExceptionSysPri[] = {0, 0, 0, 1, 1, 1, 2, 3, 3, 3};
+static const uint8 g_NvicExceptionBitsPos[] = {0, 0, 0,
+                                               MEM_FAULT_PRIORITY_BITS_POS, BUS_FAULT_PRIORITY_BITS_POS,
+                                               USAGE_FAULT_PRIORITY_BITS_POS, SVC_PRIORITY_BITS_POS,
+                                               DEBUG_MONITOR_PRIORITY_BITS_POS, PENDSV_PRIORITY_BITS_POS,
+                                               SYSTICK_PRIORITY_BITS_POS};
+
+/* Shadow of the Enable, PRIn and SYSPRIn registers (reset values) */
+#if NVIC_SHADOW_ENABLE
+static uint32 g_NvicShadowEnable[NVIC_IRQ_MASK_WORDS];
+static uint32 g_NvicShadowPri[NVIC_PRI_REGISTERS];
+static uint32 g_NvicShadowSysPri[3];
+
+/* Implemented bits of SYSPRI1 to SYSPRI3 */
+static const uint32 g_NvicSysPriImplemented[] = {0x00E0E0E0, 0xE0000000, 0xE0E000E0};
+
+#define NVIC_EN_VALUE(Index)                 (g_NvicShadowEnable[Index])
+#define NVIC_PRI_VALUE(Index)                (g_NvicShadowPri[Index])
+#define NVIC_SYSPRI_VALUE(Index)             (g_NvicShadowSysPri[Index])
+#else
+#define NVIC_EN_VALUE(Index)                 ((uint32)NVIC_EN_REG(Index))
+#define NVIC_PRI_VALUE(Index)                ((uint32)NVIC_PRI_REG(Index))
+#define NVIC_SYSPRI_VALUE(Index)             NVIC_ReadSysPri(Index)
+#endif
+
+/* RAM vector table, VTABLE points at it once relocated */
+#if defined(__GNUC__)
+static NVIC_HandlerType g_NvicRamVectors[NVIC_VECTOR_TABLE_ENTRIES] __attribute__((aligned(NVIC_VECTOR_TABLE_ALIGNMENT)));
+#else
+#pragma DATA_ALIGN(g_NvicRamVectors, NVIC_VECTOR_TABLE_ALIGNMENT)
+static NVIC_HandlerType g_NvicRamVectors[NVIC_VECTOR_TABLE_ENTRIES];
+#endif
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Core mask registers: set PRIMASK returning its old value, restore it, and
+ * swap BASEPRI returning its old value. Vector table base: read and write
+ * VTABLE, the write is completed before the next exception.
+ */
+#if defined(TM4C_HOST_SIM)
+
+static uint32 NVIC_DisableSave(void)
+{
+    uint32 primask = RegSim_GetPrimask() ? 1 : 0;
+
+    RegSim_SetPrimask(TRUE);
+    return primask;
+}
+
+static void NVIC_RestorePrimask(uint32 a_Primask)
+{
+    RegSim_SetPrimask((a_Primask != 0) ? TRUE : FALSE);
+}
+
+static uint32 NVIC_SwapBasepri(uint32 a_Basepri)
+{
+    uint32 basepri = RegSim_GetBasepri();
+
+    RegSim_SetBasepri(a_Basepri);
+    return basepri;
+}
+
+static NVIC_HandlerType *NVIC_GetVectorTable(void)
+{
+    return RegSim_GetVectorTable();
+}
+
+static void NVIC_SetVectorTable(NVIC_HandlerType *a_Table)
+{
+    RegSim_SetVectorTable(a_Table);
+}
+
+#elif defined(__GNUC__)
+
+static inline uint32 NVIC_DisableSave(void)
+{
+    uint32 primask;
+
+    __asm volatile (" MRS %0, PRIMASK \n CPSID I " : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline void NVIC_RestorePrimask(uint32 a_Primask)
+{
+    __asm volatile (" MSR PRIMASK, %0 " : : "r" (a_Primask) : "memory");
+}
+
+static inline uint32 NVIC_SwapBasepri(uint32 a_Basepri)
+{
+    uint32 basepri;
+
+    __asm volatile (" MRS %0, BASEPRI \n MSR BASEPRI, %1 " : "=&r" (basepri) : "r" (a_Basepri) : "memory");
+    return basepri;
+}
+
+static inline NVIC_HandlerType *NVIC_GetVectorTable(void)
+{
+    return (NVIC_HandlerType *)NVIC_VTABLE_REG;
+}
+
+static inline void NVIC_SetVectorTable(NVIC_HandlerType *a_Table)
+{
+    NVIC_VTABLE_REG = (uint32)a_Table;
+    __asm volatile (" DSB " : : : "memory");
+}
+
+#else /* TI ARM compiler intrinsics */
+
+#define NVIC_DisableSave()                   _disable_interrupts()
+#define NVIC_RestorePrimask(Primask)         _restore_interrupts(Primask)
+#define NVIC_SwapBasepri(Basepri)            _set_interrupt_priority(Basepri)
+#define NVIC_GetVectorTable()                ((NVIC_HandlerType *)NVIC_VTABLE_REG)
+
+static inline void NVIC_SetVectorTable(NVIC_HandlerType *a_Table)
+{
+    NVIC_VTABLE_REG = (uint32)a_Table;
+    __asm(" DSB");
+}
+
+#endif /* TM4C_HOST_SIM */
+
+/* SYSPRIn register by index (0 to 2 for SYSPRI1 to SYSPRI3) */
+static uint32 NVIC_ReadSysPri(uint8 a_Index)
+{
+    return (a_Index == 0) ? (uint32)NVIC_SYSTEM_PRI1_REG :
+           ((a_Index == 1) ? (uint32)NVIC_SYSTEM_PRI2_REG : (uint32)NVIC_SYSTEM_PRI3_REG);
+}
+
+static void NVIC_WriteSysPri(uint8 a_Index, uint32 a_Value)
+{
+    if (a_Index == 0)
+    {
+        NVIC_SYSTEM_PRI1_REG = a_Value;
+    }
+    else if (a_Index == 1)
+    {
+        NVIC_SYSTEM_PRI2_REG = a_Value;
+    }
+    else
+    {
+        NVIC_SYSTEM_PRI3_REG = a_Value;
+    }
+}
+
+/*
+ * Enable register updates: the Enable and Disable registers are
+ * write-1-to-set and write-1-to-clear, so a plain store leaves the other
+ * IRQs unchanged. With the shadow, the store and the shadow update are done
+ * with PRIMASK set so that two contexts cannot leave them different.
+ */
+static void NVIC_SetEnableBits(uint8 a_Index, uint32 a_Bits)
+{
+#if NVIC_SHADOW_ENABLE
+    uint32 primask = NVIC_DisableSave();
+
+    NVIC_EN_REG(a_Index) = a_Bits;
+    g_NvicShadowEnable[a_Index] |= a_Bits;
+    NVIC_RestorePrimask(primask);
+#else
+    NVIC_EN_REG(a_Index) = a_Bits;
+#endif
+}
+
+static void NVIC_ClearEnableBits(uint8 a_Index, uint32 a_Bits)
+{
+#if NVIC_SHADOW_ENABLE
+    uint32 primask = NVIC_DisableSave();
+
+    NVIC_DIS_REG(a_Index) = a_Bits;
+    g_NvicShadowEnable[a_Index] &= ~a_Bits;
+    NVIC_RestorePrimask(primask);
+#else
+    NVIC_DIS_REG(a_Index) = a_Bits;
+#endif
+}
+
+/*
+ * Priority register updates: the fields in a_Mask take a_Value, the others
+ * are kept. Without the shadow they are read from the register (unless all
+ * the implemented fields are given), with it they come from RAM and the
+ * register is only stored.
+ */
+static void NVIC_UpdatePri(uint8 a_Index, uint32 a_Mask, uint32 a_Value)
+{
+#if NVIC_SHADOW_ENABLE
+    uint32 primask = NVIC_DisableSave();
+
+    g_NvicShadowPri[a_Index] = ((g_NvicShadowPri[a_Index] & ~a_Mask) | (a_Value & a_Mask)) & NVIC_PRI_IMPLEMENTED;
+    NVIC_PRI_REG(a_Index) = g_NvicShadowPri[a_Index];
+    NVIC_RestorePrimask(primask);
+#else
+    if ((a_Mask & NVIC_PRI_IMPLEMENTED) == NVIC_PRI_IMPLEMENTED)
+    {
+        NVIC_PRI_REG(a_Index) = a_Value & a_Mask; //All 4 IRQs given, nothing to keep
+    }
+    else
+    {
+        NVIC_PRI_REG(a_Index) = (NVIC_PRI_REG(a_Index) & ~a_Mask) | (a_Value & a_Mask);
+    }
+#endif
+}
+
+static void NVIC_UpdateSysPri(uint8 a_Index, uint32 a_Mask, uint32 a_Value)
+{
+#if NVIC_SHADOW_ENABLE
+    uint32 primask = NVIC_DisableSave();
+
+    g_NvicShadowSysPri[a_Index] = ((g_NvicShadowSysPri[a_Index] & ~a_Mask) | (a_Value & a_Mask)) &
+                                  g_NvicSysPriImplemented[a_Index];
+    NVIC_WriteSysPri(a_Index, g_NvicShadowSysPri[a_Index]);
+    NVIC_RestorePrimask(primask);
+#else
+    NVIC_WriteSysPri(a_Index, (NVIC_ReadSysPri(a_Index) & ~a_Mask) | (a_Value & a_Mask));
+#endif
+}
+
+/* Checksum of a saved context, all the words before the checksum: the
+ * rotation makes swapped words count, the inversion rejects zeroed RAM */
+static uint32 NVIC_ContextChecksum(const NVIC_ContextType *a_Context)
+{
+    const uint32 *word = (const uint32 *)a_Context;
+    uint32 sum = 0;
+    uint8 index;
+
+    for (index = 0; index < ((sizeof(NVIC_ContextType) / sizeof(uint32)) - 1); index++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + word[index];
+    }
+
+    return ~sum;
+}
+
+/*******************************************************************************
+ *                           Function Definitions                              *
+ *******************************************************************************/
+/**********************************************************************
+ * Service Name: NVIC_EnableIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be enabled
+ * Return Value: None
+ * Description: Function to enable the interrupt request for the specified IRQ.
+ *********************************************************************/
+void NVIC_EnableIRQ(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        //The Enable registers are write-1-to-set: a plain store leaves the other IRQs unchanged
+        NVIC_SetEnableBits(NVIC_IRQ_MASK_WORD(IRQ_Num), NVIC_IRQ_MASK_BIT(IRQ_Num));
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+    }
+}
+
+/**********************************************************************
+ * Service Name: NVIC_DisableIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be disabled
+ * Return Value: None
+ * Description: Function to disable the interrupt request for the specified IRQ.
+ *********************************************************************/
+void NVIC_DisableIRQ(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        //The Disable registers are write-1-to-clear: a plain store leaves the other IRQs unchanged
+        NVIC_ClearEnableBits(NVIC_IRQ_MASK_WORD(IRQ_Num), NVIC_IRQ_MASK_BIT(IRQ_Num));
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_EnableIRQMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be enabled
+ * Return Value: None
+ * Description: Function to enable several IRQs at once, with one store
+ * per Enable register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_EnableIRQMask(const NVIC_IRQMaskType *IRQ_Mask)
+{
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        if (IRQ_Mask->word[registerIndex] != 0)
+        {
+            NVIC_SetEnableBits(registerIndex, IRQ_Mask->word[registerIndex]);
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_DisableIRQMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be disabled
+ * Return Value: None
+ * Description: Function to disable several IRQs at once, with one store
+ * per Disable register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_DisableIRQMask(const NVIC_IRQMaskType *IRQ_Mask)
+{
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        if (IRQ_Mask->word[registerIndex] != 0)
+        {
+            NVIC_ClearEnableBits(registerIndex, IRQ_Mask->word[registerIndex]);
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be pended
+ * Return Value: None
+ * Description: Function to set the pending state of the specified IRQ. An enabled IRQ
+ * is then taken as soon as its priority allows it, which makes it a software
+ * interrupt when no peripheral uses it.
+ *********************************************************************/
+void NVIC_SetPending(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        //The Pend registers are write-1-to-set: a plain store leaves the other IRQs unchanged
+        NVIC_PEND_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) = NVIC_IRQ_MASK_BIT(IRQ_Num);
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_ClearPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be cleared
+ * Return Value: None
+ * Description: Function to clear the pending state of the specified IRQ.
+ *********************************************************************/
+void NVIC_ClearPending(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        //The Unpend registers are write-1-to-clear: a plain store leaves the other IRQs unchanged
+        NVIC_UNPEND_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) = NVIC_IRQ_MASK_BIT(IRQ_Num);
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_IsPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: TRUE if the IRQ is pending (FALSE for an unsupported IRQ number)
+ * Description: Function to read the pending state of the specified IRQ.
+ *********************************************************************/
+boolean NVIC_IsPending(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        return ((NVIC_PEND_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) & NVIC_IRQ_MASK_BIT(IRQ_Num)) != 0) ? TRUE : FALSE;
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+        return FALSE;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_IsActive
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: TRUE if the handler of the IRQ is running or preempted
+ *               (FALSE for an unsupported IRQ number)
+ * Description: Function to read the active state of the specified IRQ.
+ *********************************************************************/
+boolean NVIC_IsActive(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        return ((NVIC_ACTIVE_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) & NVIC_IRQ_MASK_BIT(IRQ_Num)) != 0) ? TRUE : FALSE;
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+        return FALSE;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_TriggerSoftware
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be pended
+ * Return Value: None
+ * Description: Function to pend the specified IRQ through the Software Trigger
+ * register: one store of the IRQ number, no bit mask to build. Unprivileged
+ * code can use it when the USERSETMPEND bit of CFGCTRL is set.
+ *********************************************************************/
+void NVIC_TriggerSoftware(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        NVIC_SWTRIG_REG = IRQ_Num;
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPendingMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be pended
+ * Return Value: None
+ * Description: Function to pend several IRQs at once, with one store per Pend
+ * register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_SetPendingMask(const NVIC_IRQMaskType *IRQ_Mask)
+{
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        if (IRQ_Mask->word[registerIndex] != 0)
+        {
+            NVIC_PEND_REG(registerIndex) = IRQ_Mask->word[registerIndex];
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_ClearPendingMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be cleared
+ * Return Value: None
+ * Description: Function to clear the pending state of several IRQs at once, with one
+ * store per Unpend register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_ClearPendingMask(const NVIC_IRQMaskType *IRQ_Mask)
+{
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        if (IRQ_Mask->word[registerIndex] != 0)
+        {
+            NVIC_UNPEND_REG(registerIndex) = IRQ_Mask->word[registerIndex];
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_GetPendingMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Filled with the set of the pending IRQs
+ * Return Value: None
+ * Description: Function to read the pending state of all the IRQs, one read per
+ * Pend register.
+ *********************************************************************/
+void NVIC_GetPendingMask(NVIC_IRQMaskType *IRQ_Mask)
+{
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        IRQ_Mask->word[registerIndex] = NVIC_PEND_REG(registerIndex);
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_GetActiveMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Filled with the set of the active IRQs
+ * Return Value: None
+ * Description: Function to read the active state of all the IRQs, one read per
+ * Active register.
+ *********************************************************************/
+void NVIC_GetActiveMask(NVIC_IRQMaskType *IRQ_Mask)
+{
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        IRQ_Mask->word[registerIndex] = NVIC_ACTIVE_REG(registerIndex);
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number for which priority is to be set
+ *             IRQ_Priority - Priority level to be assigned to the specified IRQ
+ * Return Value: None
+ * Description: Function to set the priority level for the specified IRQ.
+ *********************************************************************/
+void NVIC_SetPriorityIRQ(NVIC_IRQType IRQ_Num, NVIC_IRQPriorityType IRQ_Priority)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        //Each priority register handles 4 IRQs, 3 bits at the top of each byte (INTA to INTD)
+        NVIC_UpdatePri(NVIC_PRI_INDEX(IRQ_Num), NVIC_PRI_FIELD(IRQ_Num, 0x7), NVIC_PRI_FIELD(IRQ_Num, IRQ_Priority));
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityIRQTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Table - Array of {IRQ, priority} pairs (any order)
+ *             Count - Number of entries in the table
+ * Return Value: None
+ * Description: Function to set the priority of several IRQs. The entries
+ * are grouped by PRI register and each touched register is written once
+ * (read first only when some of its IRQs are not in the table).
+ *********************************************************************/
+void NVIC_SetPriorityIRQTable(const NVIC_IRQPriorityConfigType *Table, uint8 Count)
+{
+    uint32 values[NVIC_PRI_REGISTERS];
+    uint32 masks[NVIC_PRI_REGISTERS];
+    uint32 touched = 0; // One bit per PRI register
+    uint8 registerIndex;
+    uint8 entry;
+
+    //Build the register values in RAM first
+    for (entry = 0; entry < Count; entry++)
+    {
+        registerIndex = NVIC_PRI_INDEX(Table[entry].irq);
+        if (registerIndex >= NVIC_PRI_REGISTERS)
+        {
+            continue; //Unsupported IRQ number
+        }
+        if ((touched & (1UL << registerIndex)) == 0)
+        {
+            touched |= (1UL << registerIndex);
+            values[registerIndex] = 0;
+            masks[registerIndex] = 0;
+        }
+        masks[registerIndex] |= NVIC_PRI_FIELD(Table[entry].irq, 0x7);
+        values[registerIndex] = (values[registerIndex] & ~NVIC_PRI_FIELD(Table[entry].irq, 0x7)) |
+                                NVIC_PRI_FIELD(Table[entry].irq, Table[entry].priority);
+    }
+
+    //Then one write per touched register
+    for (registerIndex = 0; registerIndex < NVIC_PRI_REGISTERS; registerIndex++)
+    {
+        if ((touched & (1UL << registerIndex)) == 0)
+        {
+            continue;
+        }
+        NVIC_UpdatePri(registerIndex, masks[registerIndex], values[registerIndex]);
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_WritePriorityWords
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Words - Array of whole PRI register values
+ *             Count - Number of entries in the array
+ * Return Value: None
+ * Description: Function to write PRI registers packed at compile time
+ * with NVIC_PRI_WORD: one store per register and no read.
+ *********************************************************************/
+void NVIC_WritePriorityWords(const NVIC_PriorityWordType *Words, uint8 Count)
+{
+    uint8 entry;
+
+    for (entry = 0; entry < Count; entry++)
+    {
+        if (Words[entry].registerIndex < NVIC_PRI_REGISTERS)
+        {
+            NVIC_UpdatePri(Words[entry].registerIndex, NVIC_PRI_IMPLEMENTED, Words[entry].value);
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_EnableException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number to be enabled
+ * Return Value: None
+ * Description: Function to enable the specified exception in the NVIC.
+ *********************************************************************/
+void NVIC_EnableException(NVIC_ExceptionType Exception_Num)
+{
+    /*
+     * Check the type of exception specified by Exception_Num.
+     * Depending on the exception type, set the corresponding bit in the
+     * System Handler Control and State Register (SYSHNDCTRL) to enable the
+     * Exception handling.
+     */
+    switch (Exception_Num)
+    {
+        case EXCEPTION_MEM_FAULT_TYPE:
+            //Enable memory management fault exception
+            NVIC_SYSTEM_SYSHNDCTRL |= MEM_FAULT_ENABLE_MASK;
+            break;
+        case EXCEPTION_BUS_FAULT_TYPE:
+            //Enable bus fault exception
+            NVIC_SYSTEM_SYSHNDCTRL |= BUS_FAULT_ENABLE_MASK;
+            break;
+        case EXCEPTION_USAGE_FAULT_TYPE:
+            //Enable usage fault exception
+            NVIC_SYSTEM_SYSHNDCTRL |= USAGE_FAULT_ENABLE_MASK;
+            break;
+        default:
+            /* Other exceptions cannot be enabled/disabled */
+            break;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_DisableException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number to be disabled
+ * Return Value: None
+ * Description: Function to disable the specified exception in the NVIC.
+ *********************************************************************/
+void NVIC_DisableException(NVIC_ExceptionType Exception_Num)
+{
+    switch (Exception_Num)
+    {
+        case EXCEPTION_MEM_FAULT_TYPE:
+            //Disable memory management fault exception
+            NVIC_SYSTEM_SYSHNDCTRL &= ~MEM_FAULT_ENABLE_MASK;
+            break;
+        case EXCEPTION_BUS_FAULT_TYPE:
+            //Disable bus fault exception
+            NVIC_SYSTEM_SYSHNDCTRL &= ~BUS_FAULT_ENABLE_MASK;
+            break;
+        case EXCEPTION_USAGE_FAULT_TYPE:
+            //Disable usage fault exception
+            NVIC_SYSTEM_SYSHNDCTRL &= ~USAGE_FAULT_ENABLE_MASK;
+            break;
+        default:
+            /* Other exceptions cannot be enabled/disabled */
+            break;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number for which priority is to be set
+ *             Exception_Priority - Priority level to be assigned to the specified exception
+ * Return Value: None
+ * Description: Function to set the priority level for the specified exception.
+ *********************************************************************/
+void NVIC_SetPriorityException(NVIC_ExceptionType Exception_Num, NVIC_ExceptionPriorityType Exception_Priority)
+{
+    /*
+     * Check the type of exception specified by Exception_Num.
+     * Depending on the exception type, set the priority by modifying
+     * The corresponding priority register.
+     */
+    switch (Exception_Num)
+    {
+        case EXCEPTION_MEM_FAULT_TYPE:
+            //Set the priority for memory management fault exception
+            NVIC_UpdateSysPri(0, MEM_FAULT_PRIORITY_MASK, Exception_Priority << MEM_FAULT_PRIORITY_BITS_POS);
+            break;
+        case EXCEPTION_BUS_FAULT_TYPE:
+            //Set the priority for bus fault exception
+            NVIC_UpdateSysPri(0, BUS_FAULT_PRIORITY_MASK, Exception_Priority << BUS_FAULT_PRIORITY_BITS_POS);
+            break;
+        case EXCEPTION_USAGE_FAULT_TYPE:
+            //Set the priority for usage fault exception
+            NVIC_UpdateSysPri(0, USAGE_FAULT_PRIORITY_MASK, Exception_Priority << USAGE_FAULT_PRIORITY_BITS_POS);
+            break;
+        case EXCEPTION_SVC_TYPE:
+            //Set the priority for supervisor call (SVC) exception
+            NVIC_UpdateSysPri(1, SVC_PRIORITY_MASK, Exception_Priority << SVC_PRIORITY_BITS_POS);
+            break;
+        case EXCEPTION_DEBUG_MONITOR_TYPE:
+            //Set the priority for debug monitor exception
+            NVIC_UpdateSysPri(2, DEBUG_MONITOR_PRIORITY_MASK, Exception_Priority << DEBUG_MONITOR_PRIORITY_BITS_POS);
+            break;
+        case EXCEPTION_PEND_SV_TYPE:
+            //Set the priority for PendSV (pendable service call) exception
+            NVIC_UpdateSysPri(2, PENDSV_PRIORITY_MASK, Exception_Priority << PENDSV_PRIORITY_BITS_POS);
+            break;
+        case EXCEPTION_SYSTICK_TYPE:
+            //Set the priority for SysTick timer exception
+            NVIC_UpdateSysPri(2, SYSTICK_PRIORITY_MASK, Exception_Priority << SYSTICK_PRIORITY_BITS_POS);
+            break;
+        default:
+            /* Other exceptions cannot have their priority set */
+            break;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityExceptionTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Table - Array of {exception, priority} pairs (any order)
+ *             Count - Number of entries in the table
+ * Return Value: None
+ * Description: Function to set the priority of several exceptions with
+ * one write per touched system priority register (SYSPRI1 to SYSPRI3).
+ *********************************************************************/
+void NVIC_SetPriorityExceptionTable(const NVIC_ExceptionPriorityConfigType *Table, uint8 Count)
+{
+    uint32 values[3] = {0, 0, 0};
+    uint32 masks[3] = {0, 0, 0};
+    uint8 registerIndex;
+    uint8 entry;
+
+    for (entry = 0; entry < Count; entry++)
+    {
+        if (((uint32)Table[entry].exception > EXCEPTION_SYSTICK_TYPE) || (g_NvicExceptionSysPri[Table[entry].exception] == 0))
+        {
+            continue; //Reset, NMI and Hard Fault have a fixed priority
+        }
+        registerIndex = g_NvicExceptionSysPri[Table[entry].exception] - 1;
+        masks[registerIndex] |= (0x7UL << g_NvicExceptionBitsPos[Table[entry].exception]);
+        values[registerIndex] = (values[registerIndex] & ~(0x7UL << g_NvicExceptionBitsPos[Table[entry].exception])) |
+                                (((uint32)Table[entry].priority & 0x7) << g_NvicExceptionBitsPos[Table[entry].exception]);
+    }
+
+    for (registerIndex = 0; registerIndex < 3; registerIndex++)
+    {
+        if (masks[registerIndex] != 0)
+        {
+            NVIC_UpdateSysPri(registerIndex, masks[registerIndex], values[registerIndex]);
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityGrouping
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Group - Split of the priority bits between preemption
+ *             priority and subpriority
+ * Return Value: None
+ * Description: Function to set the PRIGROUP field of the APINT register.
+ * Set it once at start-up, before the priorities are given.
+ *********************************************************************/
+void NVIC_SetPriorityGrouping(NVIC_PriorityGroupType Group)
+{
+    //Only the key and PRIGROUP are written: the other writable bits request resets
+    NVIC_APINT_REG = NVIC_APINT_VECTKEY |
+                     (((uint32)Group << NVIC_APINT_PRIGROUP_BITS_POS) & NVIC_APINT_PRIGROUP_MASK);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_GetPriorityGrouping
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Priority grouping in use
+ * Description: Function to read the PRIGROUP field of the APINT register.
+ *********************************************************************/
+NVIC_PriorityGroupType NVIC_GetPriorityGrouping(void)
+{
+    uint32 group = (NVIC_APINT_REG & NVIC_APINT_PRIGROUP_MASK) >> NVIC_APINT_PRIGROUP_BITS_POS;
+
+    //PRIGROUP 0 to 3 put the binary point below the implemented bits
+    return (group < NVIC_PRIORITY_GROUP_3_0) ? NVIC_PRIORITY_GROUP_3_0 : (NVIC_PriorityGroupType)group;
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_EncodePriority
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Group - Priority grouping
+ *             Preempt - Preemption priority (extra high bits are dropped)
+ *             Sub - Subpriority (extra high bits are dropped)
+ * Return Value: Priority value for NVIC_SetPriorityIRQ and
+ *               NVIC_SetPriorityException
+ * Description: Function to pack a {preemption priority, subpriority} pair.
+ *********************************************************************/
+NVIC_IRQPriorityType NVIC_EncodePriority(NVIC_PriorityGroupType Group, uint8 Preempt, uint8 Sub)
+{
+    return NVIC_PRIORITY_ENCODE(Group, Preempt, Sub);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_DecodePriority
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Priority - Priority value
+ *             Group - Priority grouping
+ *             Preempt - Filled with the preemption priority
+ *             Sub - Filled with the subpriority
+ * Return Value: None
+ * Description: Function to split a priority value into its
+ * {preemption priority, subpriority} pair.
+ *********************************************************************/
+void NVIC_DecodePriority(NVIC_IRQPriorityType Priority, NVIC_PriorityGroupType Group, uint8 *Preempt, uint8 *Sub)
+{
+    uint8 subBits = NVIC_PRIORITY_SUB_BITS(Group);
+
+    *Preempt = (Priority & 0x7) >> subBits;
+    *Sub = Priority & ((1 << subBits) - 1);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_GetPriorityIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: Priority level of the IRQ (0 for an unsupported IRQ number)
+ * Description: Function to read the priority level of the specified IRQ
+ * (from the shadow when NVIC_SHADOW_ENABLE is on).
+ *********************************************************************/
+NVIC_IRQPriorityType NVIC_GetPriorityIRQ(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        return (NVIC_IRQPriorityType)((NVIC_PRI_VALUE(NVIC_PRI_INDEX(IRQ_Num)) >> NVIC_PRI_BITS_POS(IRQ_Num)) & 0x7);
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+        return 0;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_GetPriorityException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number
+ * Return Value: Priority level of the exception (0 for an exception with a
+ *               fixed priority)
+ * Description: Function to read the priority level of the specified exception
+ * (from the shadow when NVIC_SHADOW_ENABLE is on).
+ *********************************************************************/
+NVIC_ExceptionPriorityType NVIC_GetPriorityException(NVIC_ExceptionType Exception_Num)
+{
+    if (((uint32)Exception_Num > EXCEPTION_SYSTICK_TYPE) || (g_NvicExceptionSysPri[Exception_Num] == 0))
+    {
+        return 0; //Reset, NMI and Hard Fault have a fixed priority
+    }
+
+    return (NVIC_ExceptionPriorityType)((NVIC_SYSPRI_VALUE(g_NvicExceptionSysPri[Exception_Num] - 1) >>
+                                         g_NvicExceptionBitsPos[Exception_Num]) & 0x7);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_IsIRQEnabled
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: TRUE if the IRQ is enabled (FALSE for an unsupported IRQ number)
+ * Description: Function to read the enable state of the specified IRQ
+ * (from the shadow when NVIC_SHADOW_ENABLE is on).
+ *********************************************************************/
+boolean NVIC_IsIRQEnabled(NVIC_IRQType IRQ_Num)
+{
+    if (IRQ_Num < NVIC_VECTOR_IRQS)
+    {
+        //The Enable registers read back the enable state
+        return ((NVIC_EN_VALUE(NVIC_IRQ_MASK_WORD(IRQ_Num)) & NVIC_IRQ_MASK_BIT(IRQ_Num)) != 0) ? TRUE : FALSE;
+    }
+    else
+    {
+        //Handle the error or unsupported IRQ number
+        return FALSE;
+    }
+}
+
+
+#if NVIC_SHADOW_ENABLE
+/**********************************************************************
+ * Service Name: NVIC_ShadowResync
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Function to load the shadow from the Enable and priority
+ * registers. The shadow starts with the reset values: call it first when
+ * code outside this driver (boot loader, start-up code) may have changed
+ * them.
+ *********************************************************************/
+void NVIC_ShadowResync(void)
+{
+    uint32 primask = NVIC_DisableSave();
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        g_NvicShadowEnable[registerIndex] = NVIC_EN_REG(registerIndex);
+    }
+    for (registerIndex = 0; registerIndex < NVIC_PRI_REGISTERS; registerIndex++)
+    {
+        g_NvicShadowPri[registerIndex] = NVIC_PRI_REG(registerIndex) & NVIC_PRI_IMPLEMENTED;
+    }
+    for (registerIndex = 0; registerIndex < 3; registerIndex++)
+    {
+        g_NvicShadowSysPri[registerIndex] = NVIC_ReadSysPri(registerIndex) & g_NvicSysPriImplemented[registerIndex];
+    }
+    NVIC_RestorePrimask(primask);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_ShadowVerify
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE if the shadow matches the registers
+ * Description: Function to compare the shadow with the Enable and priority
+ * registers (implemented bits only), for the debug builds.
+ *********************************************************************/
+boolean NVIC_ShadowVerify(void)
+{
+    uint32 primask = NVIC_DisableSave();
+    boolean match = TRUE;
+    uint8 registerIndex;
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        if (g_NvicShadowEnable[registerIndex] != NVIC_EN_REG(registerIndex))
+        {
+            match = FALSE;
+        }
+    }
+    for (registerIndex = 0; registerIndex < NVIC_PRI_REGISTERS; registerIndex++)
+    {
+        if (g_NvicShadowPri[registerIndex] != (NVIC_PRI_REG(registerIndex) & NVIC_PRI_IMPLEMENTED))
+        {
+            match = FALSE;
+        }
+    }
+    for (registerIndex = 0; registerIndex < 3; registerIndex++)
+    {
+        if (g_NvicShadowSysPri[registerIndex] != (NVIC_ReadSysPri(registerIndex) & g_NvicSysPriImplemented[registerIndex]))
+        {
+            match = FALSE;
+        }
+    }
+    NVIC_RestorePrimask(primask);
+
+    return match;
+}
+#endif /* NVIC_SHADOW_ENABLE */
+
+
+/**********************************************************************
+ * Service Name: NVIC_SaveContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Context - Filled with the configuration
+ * Return Value: None
+ * Description: Function to save the Enable, PRIn and SYSPRIn registers,
+ * the fault enables of SYSHNDCTRL and the priority grouping, e.g. before
+ * deep sleep or in a context kept in NVIC_NOINIT RAM across a warm reset.
+ * With NVIC_SHADOW_ENABLE on, the Enable and priority words are copied
+ * from RAM.
+ *********************************************************************/
+void NVIC_SaveContext(NVIC_ContextType *a_Context)
+{
+    uint8 registerIndex;
+
+    a_Context->magic = NVIC_CONTEXT_MAGIC;
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        a_Context->enable[registerIndex] = NVIC_EN_VALUE(registerIndex);
+    }
+    for (registerIndex = 0; registerIndex < NVIC_PRI_REGISTERS; registerIndex++)
+    {
+        a_Context->priority[registerIndex] = NVIC_PRI_VALUE(registerIndex) & NVIC_PRI_IMPLEMENTED;
+    }
+    for (registerIndex = 0; registerIndex < 3; registerIndex++)
+    {
+        a_Context->systemPriority[registerIndex] = NVIC_SYSPRI_VALUE(registerIndex);
+    }
+    a_Context->faultEnable = NVIC_SYSTEM_SYSHNDCTRL & NVIC_FAULT_ENABLE_MASKS;
+    a_Context->priorityGroup = NVIC_APINT_REG & NVIC_APINT_PRIGROUP_MASK;
+    a_Context->checksum = NVIC_ContextChecksum(a_Context);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_RestoreContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Context - Configuration saved by NVIC_SaveContext
+ * Return Value: FALSE if the magic or the checksum is wrong (nothing is
+ * written then)
+ * Description: Function to write a saved configuration back with word
+ * stores, with the interrupts masked: the IRQs off in the context are
+ * disabled first, the IRQs on are enabled last. SYSHNDCTRL is the only
+ * register read: its fault enables are replaced, its active and pending
+ * bits are kept, so it may be called from a handler too. The handlers of
+ * the RAM vector table are not part of the context.
+ *********************************************************************/
+boolean NVIC_RestoreContext(const NVIC_ContextType *a_Context)
+{
+    uint8 registerIndex;
+    uint32 primask;
+
+    if ((a_Context->magic != NVIC_CONTEXT_MAGIC) || (a_Context->checksum != NVIC_ContextChecksum(a_Context)))
+    {
+        return FALSE;
+    }
+
+    primask = NVIC_DisableSave(); // SYSHNDCTRL is read-modify-write, the shadow changes with the registers
+
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        NVIC_DIS_REG(registerIndex) = ~a_Context->enable[registerIndex];
+    }
+    for (registerIndex = 0; registerIndex < NVIC_PRI_REGISTERS; registerIndex++)
+    {
+        NVIC_PRI_REG(registerIndex) = a_Context->priority[registerIndex];
+    }
+    NVIC_SYSTEM_PRI1_REG = a_Context->systemPriority[0];
+    NVIC_SYSTEM_PRI2_REG = a_Context->systemPriority[1];
+    NVIC_SYSTEM_PRI3_REG = a_Context->systemPriority[2];
+    //Only the fault enables: the active and pending bits of the running handlers must be kept
+    NVIC_SYSTEM_SYSHNDCTRL = (NVIC_SYSTEM_SYSHNDCTRL & ~NVIC_FAULT_ENABLE_MASKS) | (a_Context->faultEnable & NVIC_FAULT_ENABLE_MASKS);
+    NVIC_APINT_REG = NVIC_APINT_VECTKEY | a_Context->priorityGroup;
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        NVIC_EN_REG(registerIndex) = a_Context->enable[registerIndex];
+    }
+
+#if NVIC_SHADOW_ENABLE
+    for (registerIndex = 0; registerIndex < NVIC_IRQ_MASK_WORDS; registerIndex++)
+    {
+        g_NvicShadowEnable[registerIndex] = a_Context->enable[registerIndex];
+    }
+    for (registerIndex = 0; registerIndex < NVIC_PRI_REGISTERS; registerIndex++)
+    {
+        g_NvicShadowPri[registerIndex] = a_Context->priority[registerIndex];
+    }
+    for (registerIndex = 0; registerIndex < 3; registerIndex++)
+    {
+        g_NvicShadowSysPri[registerIndex] = a_Context->systemPriority[registerIndex] & g_NvicSysPriImplemented[registerIndex];
+    }
+#endif
+    NVIC_RestorePrimask(primask);
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_RelocateVectorTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Function to copy the vector table in use into the aligned
+ * RAM table and point VTABLE at it. Does nothing once relocated.
+ *********************************************************************/
+void NVIC_RelocateVectorTable(void)
+{
+    NVIC_HandlerType *table = NVIC_GetVectorTable();
+    NVIC_CriticalStateType state;
+    uint16 vector;
+
+    if (table == g_NvicRamVectors)
+    {
+        return;
+    }
+
+    state = NVIC_EnterCritical(0); // No exception is taken while the table moves
+    for (vector = 0; vector < NVIC_VECTOR_TABLE_ENTRIES; vector++)
+    {
+        g_NvicRamVectors[vector] = table[vector];
+    }
+    NVIC_SetVectorTable(g_NvicRamVectors);
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_IsVectorTableRelocated
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE if VTABLE points at the RAM table
+ * Description: Function to check whether the vector table has been
+ * relocated (by NVIC_RelocateVectorTable or a handler registration).
+ *********************************************************************/
+boolean NVIC_IsVectorTableRelocated(void)
+{
+    return (boolean)(NVIC_GetVectorTable() == g_NvicRamVectors);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_RegisterHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number (0 to NVIC_VECTOR_IRQS - 1)
+ *             Handler - Function entered directly by the IRQ
+ * Return Value: FALSE for an unsupported IRQ number or a NULL handler
+ * Description: Function to install the handler of an IRQ in the RAM vector
+ * table (relocated first if needed). The entry is replaced by one store,
+ * so the handler can be swapped while the IRQ is enabled. The handler is
+ * not wrapped: with ISRSTATS_ENABLE it places ISRSTATS_ENTER/EXIT itself.
+ *********************************************************************/
+boolean NVIC_RegisterHandler(NVIC_IRQType IRQ_Num, NVIC_HandlerType Handler)
+{
+    if ((IRQ_Num >= NVIC_VECTOR_IRQS) || (Handler == NULL_PTR))
+    {
+        return FALSE;
+    }
+
+    NVIC_RelocateVectorTable();
+    g_NvicRamVectors[16 + IRQ_Num] = Handler;
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_RegisterExceptionHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - System exception (not the reset vector)
+ *             Handler - Function entered directly by the exception
+ * Return Value: FALSE for the reset vector or a NULL handler
+ * Description: Function to install the handler of a system exception in
+ * the RAM vector table (relocated first if needed).
+ *********************************************************************/
+boolean NVIC_RegisterExceptionHandler(NVIC_ExceptionType Exception_Num, NVIC_HandlerType Handler)
+{
+    if ((Exception_Num == EXCEPTION_RESET_TYPE) || (Exception_Num > EXCEPTION_SYSTICK_TYPE) || (Handler == NULL_PTR))
+    {
+        return FALSE; // The reset vector is only read from the boot table
+    }
+
+    NVIC_RelocateVectorTable();
+    g_NvicRamVectors[g_NvicExceptionVector[Exception_Num]] = Handler;
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_EnterCritical
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ceiling - Priority ceiling (1 to 7): the exceptions with this
+ *             priority or a lower one are masked, the higher ones stay live.
+ *             With a priority grouping only its preemption part counts.
+ *             0 masks everything (PRIMASK).
+ * Return Value: State to be given back to NVIC_ExitCritical
+ * Description: Function to enter a nestable critical section by raising
+ * BASEPRI to the ceiling (never lowering it).
+ *********************************************************************/
+NVIC_CriticalStateType NVIC_EnterCritical(NVIC_IRQPriorityType Ceiling)
+{
+    uint32 ceiling = NVIC_CEILING_TO_BASEPRI(Ceiling);
+    uint32 primask;
+    uint32 basepri;
+
+    /*
+     * BASEPRI is written with PRIMASK set: on the Cortex-M4 r0p1 an interrupt
+     * below the new level can still be taken just after the write (erratum
+     * 837070), and an enclosing higher ceiling is put back without a window.
+     */
+    primask = NVIC_DisableSave();
+    basepri = NVIC_SwapBasepri(ceiling);
+    if ((ceiling == 0) || ((basepri != 0) && (basepri < ceiling)))
+    {
+        NVIC_SwapBasepri(basepri); // The enclosing section masks more already
+    }
+    if (ceiling != 0)
+    {
+        NVIC_RestorePrimask(primask);
+    }
+
+    return (basepri & 0xFF) | ((primask & 0x1) << 8);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_ExitCritical
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: State - Value returned by the matching NVIC_EnterCritical
+ * Return Value: None
+ * Description: Function to leave a critical section, restoring the masking
+ * of the enclosing one.
+ *********************************************************************/
+void NVIC_ExitCritical(NVIC_CriticalStateType State)
+{
+    NVIC_SwapBasepri(State & 0xFF);
+    NVIC_RestorePrimask((State >> 8) & 0x1);
+}
+
+
+/**********************************************************************
+ * Service Name: NVIC_IsExceptionMasked
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - System exception to be checked
+ * Return Value: TRUE if the exception cannot be taken now
+ * Description: Function to check PRIMASK, BASEPRI and the handler being
+ * run (if any) against the priority of a system exception (its preemption
+ * part with a priority grouping). Reset, NMI and Hard Fault are never masked.
+ *********************************************************************/
+boolean NVIC_IsExceptionMasked(NVIC_ExceptionType Exception_Num)
+{
+    uint32 group = (NVIC_APINT_REG & NVIC_APINT_PRIGROUP_MASK) >> NVIC_APINT_PRIGROUP_BITS_POS;
+    uint32 preemptMask = (0xFFUL << (group + 1)) & 0xFF;
+    uint32 active = NVIC_SYSTEM_INTCTRL & NVIC_INTCTRL_VECACT_MASK;
+    uint32 priority;
+    uint32 running;
+    uint32 primask;
+    uint32 basepri;
+    uint32 type;
+
+    if (((uint32)Exception_Num > EXCEPTION_SYSTICK_TYPE) || (g_NvicExceptionSysPri[Exception_Num] == 0))
+    {
+        return FALSE; //Reset, NMI and Hard Fault have a fixed priority
+    }
+    priority = NVIC_CEILING_TO_BASEPRI(NVIC_GetPriorityException(Exception_Num)) & preemptMask;
+
+    //BASEPRI is read by swapping it out and back with PRIMASK set
+    primask = NVIC_DisableSave();
+    basepri = NVIC_SwapBasepri(0);
+    NVIC_SwapBasepri(basepri);
+    NVIC_RestorePrimask(primask);
+
+    if ((primask != 0) || ((basepri != 0) && (priority >= (basepri & preemptMask))))
+    {
+        return TRUE;
+    }
+
+    //The running handler is preempted only by a higher preemption priority
+    if (active >= NVIC_FIRST_IRQ_VECTOR)
+    {
+        running = NVIC_CEILING_TO_BASEPRI(NVIC_GetPriorityIRQ((NVIC_IRQType)(active - NVIC_FIRST_IRQ_VECTOR)));
+        return (boolean)(priority >= (running & preemptMask));
+    }
+    for (type = EXCEPTION_NMI_TYPE; (active != 0) && (type <= EXCEPTION_SYSTICK_TYPE); type++)
+    {
+        if (g_NvicExceptionVector[type] == active)
+        {
+            if (g_NvicExceptionSysPri[type] == 0)
+            {
+                return TRUE; // NMI or Hard Fault running
+            }
+            running = NVIC_CEILING_TO_BASEPRI(NVIC_GetPriorityException((NVIC_ExceptionType)type));
+            return (boolean)(priority >= (running & preemptMask));
+        }
+    }
+
+    return FALSE; // Thread mode
+}
@@ -1,152 +1,685 @@
-/******************************************************************************
- *
- * Module: NVIC
- *
- * File Name: NVIC.h
- *
- * Description: Header file for the ARM Cortex M4 NVIC driver
- *
- * Author: Mohamed Tarek (Edges For Training)
- *
- *******************************************************************************/
-
-#ifndef NVIC_H_
-#define NVIC_H_
-
-/*******************************************************************************
- *                                Inclusions                                   *
- *******************************************************************************/
-#include "std_types.h"
-
-/*******************************************************************************
- *                           Preprocessor Definitions                          *
- *******************************************************************************/
-
-#define MEM_FAULT_PRIORITY_MASK              0x000000E0
-#define MEM_FAULT_PRIORITY_BITS_POS          5
-
-#define BUS_FAULT_PRIORITY_MASK              0x0000E000
-#define BUS_FAULT_PRIORITY_BITS_POS          13
-
-#define USAGE_FAULT_PRIORITY_MASK            0x00E00000
-#define USAGE_FAULT_PRIORITY_BITS_POS        21
-
-#define SVC_PRIORITY_MASK                    0xE0000000
-#define SVC_PRIORITY_BITS_POS                29
-
-#define DEBUG_MONITOR_PRIORITY_MASK          0x000000E0
-#define DEBUG_MONITOR_PRIORITY_BITS_POS      5
-
-#define PENDSV_PRIORITY_MASK                 0x00E00000
-#define PENDSV_PRIORITY_BITS_POS             21
-
-#define SYSTICK_PRIORITY_MASK                0xE0000000
-#define SYSTICK_PRIORITY_BITS_POS            29
-
-#define MEM_FAULT_ENABLE_MASK                0x00010000
-#define BUS_FAULT_ENABLE_MASK                0x00020000
-#define USAGE_FAULT_ENABLE_MASK              0x00040000
-
-/* Enable Exceptions ... This Macro enable IRQ interrupts, Programmable Systems Exceptions and Faults by clearing the I-bit in the PRIMASK. */
-#define Enable_Exceptions()    __asm(" CPSIE I ")
-
-/* Disable Exceptions ... This Macro disable IRQ interrupts, Programmable Systems Exceptions and Faults by setting the I-bit in the PRIMASK. */
-#define Disable_Exceptions()   __asm(" CPSID I ")
-
-/* Enable Faults ... This Macro enable Faults by clearing the F-bit in the FAULTMASK */
-#define Enable_Faults()        __asm(" CPSIE F ")
-
-/* Disable Faults ... This Macro disable Faults by setting the F-bit in the FAULTMASK */
-#define Disable_Faults()       __asm(" CPSID F ")
-
-/*******************************************************************************
- *                           Data Types Declarations                           *
- *******************************************************************************/
-typedef uint8 NVIC_IRQType;
-
-typedef uint8 NVIC_IRQPriorityType;
-
-typedef enum
-{
-    EXCEPTION_RESET_TYPE,
-    EXCEPTION_NMI_TYPE,
-    EXCEPTION_HARD_FAULT_TYPE,
-    EXCEPTION_MEM_FAULT_TYPE,
-    EXCEPTION_BUS_FAULT_TYPE,
-    EXCEPTION_USAGE_FAULT_TYPE,
-    EXCEPTION_SVC_TYPE,
-    EXCEPTION_DEBUG_MONITOR_TYPE,
-    EXCEPTION_PEND_SV_TYPE,
-    EXCEPTION_SYSTICK_TYPE
-} NVIC_ExceptionType;
-
-typedef uint8 NVIC_ExceptionPriorityType;
-
-/*******************************************************************************
- *                           Function Prototypes                               *
- *******************************************************************************/
-
-/**********************************************************************
- * Service Name: NVIC_EnableIRQ
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: IRQ_Num - IRQ number to be enabled
- * Return Value: None
- * Description: Function to enable the interrupt request for the specified IRQ.
- *********************************************************************/
-void NVIC_EnableIRQ(NVIC_IRQType IRQ_Num);
-
-/**********************************************************************
- * Service Name: NVIC_DisableIRQ
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: IRQ_Num - IRQ number to be disabled
- * Return Value: None
- * Description: Function to disable the interrupt request for the specified IRQ.
- *********************************************************************/
-void NVIC_DisableIRQ(NVIC_IRQType IRQ_Num);
-
-/**********************************************************************
- * Service Name: NVIC_SetPriorityIRQ
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: IRQ_Num - IRQ number for which priority is to be set
- *             IRQ_Priority - Priority level to be assigned to the specified IRQ
- * Return Value: None
- * Description: Function to set the priority level for the specified IRQ.
- *********************************************************************/
-void NVIC_SetPriorityIRQ(NVIC_IRQType IRQ_Num, NVIC_IRQPriorityType IRQ_Priority);
-
-/**********************************************************************
- * Service Name: NVIC_EnableException
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Exception_Num - Exception number to be enabled
- * Return Value: None
- * Description: Function to enable the specified exception in the NVIC.
- *********************************************************************/
-void NVIC_EnableException(NVIC_ExceptionType Exception_Num);
-
-/**********************************************************************
- * Service Name: NVIC_DisableException
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Exception_Num - Exception number to be disabled
- * Return Value: None
- * Description: Function to disable the specified exception in the NVIC.
- *********************************************************************/
-void NVIC_DisableException(NVIC_ExceptionType Exception_Num);
-
-/**********************************************************************
- * Service Name: NVIC_SetPriorityException
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Exception_Num - Exception number for which priority is to be set
- *             Exception_Priority - Priority level to be assigned to the specified exception
- * Return Value: None
- * Description: Function to set the priority level for the specified exception.
- *********************************************************************/
-
-void NVIC_SetPriorityException(NVIC_ExceptionType Exception_Num, NVIC_ExceptionPriorityType Exception_Priority);
-
-#endif /* NVIC_H_ */
+/******************************************************************************
+ *
+ * Module: NVIC
+ *
+ * File Name: NVIC.h
+ *
+ * Description: Header file for the ARM Cortex M4 NVIC driver
+ *
+ * Author: Mohamed Tarek (Edges For Training)
+ *
+ *******************************************************************************/
+
+#ifndef NVIC_H_
+#define NVIC_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+#ifdef TM4C_HOST_SIM
+#include "RegSim.h"
+#endif
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+/* RAM copy of the Enable and priority registers kept by the driver: the
+ * getters read it and the priority updates become plain stores (no read of
+ * the register first). All the Enable and priority changes must go through
+ * this driver while it is on. */
+#ifndef NVIC_SHADOW_ENABLE
+#define NVIC_SHADOW_ENABLE                   0
+#endif
+
+#define MEM_FAULT_PRIORITY_MASK              0x000000E0
+#define MEM_FAULT_PRIORITY_BITS_POS          5
+
+#define BUS_FAULT_PRIORITY_MASK              0x0000E000
+#define BUS_FAULT_PRIORITY_BITS_POS          13
+
+#define USAGE_FAULT_PRIORITY_MASK            0x00E00000
+#define USAGE_FAULT_PRIORITY_BITS_POS        21
+
+#define SVC_PRIORITY_MASK                    0xE0000000
+#define SVC_PRIORITY_BITS_POS                29
+
+#define DEBUG_MONITOR_PRIORITY_MASK          0x000000E0
+#define DEBUG_MONITOR_PRIORITY_BITS_POS      5
+
+#define PENDSV_PRIORITY_MASK                 0x00E00000
+#define PENDSV_PRIORITY_BITS_POS             21
+
+#define SYSTICK_PRIORITY_MASK                0xE0000000
+#define SYSTICK_PRIORITY_BITS_POS            29
+
+/* Vector table of the TM4C123GH6PM: 16 system vectors then 139 IRQs. VTABLE
+ * needs the table aligned on its size rounded up to a power of two. */
+#define NVIC_VECTOR_IRQS                     139
+#define NVIC_VECTOR_TABLE_ENTRIES            (16 + NVIC_VECTOR_IRQS)
+#define NVIC_VECTOR_TABLE_ALIGNMENT          1024
+
+/* Priority grouping: number of subpriority bits among the 3 implemented ones */
+#define NVIC_PRIORITY_SUB_BITS(Group)        (((Group) > 4) ? ((Group) - 4) : 0)
+
+/* 3-bit priority value of a {preemption priority, subpriority} pair, for the
+ * priority tables built at compile time */
+#define NVIC_PRIORITY_ENCODE(Group, Preempt, Sub) \
+    ((NVIC_IRQPriorityType)(((((uint32)(Preempt)) << NVIC_PRIORITY_SUB_BITS(Group)) | \
+                             ((uint32)(Sub) & ((1UL << NVIC_PRIORITY_SUB_BITS(Group)) - 1))) & 0x7))
+
+/* IRQ sets: one bit per IRQ, IRQ n is bit (n % 32) of word (n / 32). The
+ * 5 words cover every IRQ of the vector table (EN0 to EN4, IRQ 0 to 138). */
+#define NVIC_IRQ_MASK_WORDS                  5
+#define NVIC_IRQ_MASK_WORD(IRQ_Num)          ((IRQ_Num) >> 5)
+#define NVIC_IRQ_MASK_BIT(IRQ_Num)           (1UL << ((IRQ_Num) & 31))
+
+/* Adds an IRQ to a NVIC_IRQMaskType variable */
+#define NVIC_IRQ_MASK_ADD(Mask, IRQ_Num)     ((Mask).word[NVIC_IRQ_MASK_WORD(IRQ_Num)] |= NVIC_IRQ_MASK_BIT(IRQ_Num))
+
+/* Packing of the IRQ priorities: 4 IRQs per PRIn register, 3 bits at the top
+ * of each byte (PRI0 to PRI34, IRQ 0 to 138) */
+#define NVIC_PRI_REGISTERS                   35
+#define NVIC_PRI_INDEX(IRQ_Num)              ((IRQ_Num) >> 2)
+#define NVIC_PRI_BITS_POS(IRQ_Num)           (5 + (8 * ((IRQ_Num) & 3)))
+#define NVIC_PRI_FIELD(IRQ_Num, Priority)    (((uint32)(Priority) & 0x7) << NVIC_PRI_BITS_POS(IRQ_Num))
+
+/* Whole PRIn word for NVIC_WritePriorityWords, built at compile time from the
+ * 4 IRQs n*4 to n*4+3 */
+#define NVIC_PRI_WORD(PriA, PriB, PriC, PriD) \
+    (NVIC_PRI_FIELD(0, PriA) | NVIC_PRI_FIELD(1, PriB) | NVIC_PRI_FIELD(2, PriC) | NVIC_PRI_FIELD(3, PriD))
+
+#define MEM_FAULT_ENABLE_MASK                0x00010000
+#define BUS_FAULT_ENABLE_MASK                0x00020000
+#define USAGE_FAULT_ENABLE_MASK              0x00040000
+#define NVIC_FAULT_ENABLE_MASKS              (MEM_FAULT_ENABLE_MASK | BUS_FAULT_ENABLE_MASK | USAGE_FAULT_ENABLE_MASK)
+
+/* First word of a valid NVIC_ContextType ("NVIC") */
+#define NVIC_CONTEXT_MAGIC                   0x4E564943UL
+
+/* Places a saved context in RAM the start-up code neither clears nor loads,
+ * so it survives a warm reset (the GCC linker script needs a NOLOAD .noinit
+ * output section) */
+#if defined(TM4C_HOST_SIM)
+#define NVIC_NOINIT
+#elif defined(__GNUC__)
+#define NVIC_NOINIT                          __attribute__((section(".noinit")))
+#else
+#define NVIC_NOINIT                          __attribute__((noinit))
+#endif
+
+#ifdef TM4C_HOST_SIM
+
+/* Host build: PRIMASK and WFI are modelled by the simulated core, FAULTMASK has no effect */
+#define Enable_Exceptions()    RegSim_SetPrimask(FALSE)
+#define Disable_Exceptions()   RegSim_SetPrimask(TRUE)
+#define Enable_Faults()
+#define Disable_Faults()
+#define Wait_For_Interrupt()   RegSim_WaitForInterrupt()
+
+#else
+
+/* Enable Exceptions ... This Macro enable IRQ interrupts, Programmable Systems Exceptions and Faults by clearing the I-bit in the PRIMASK. */
+#define Enable_Exceptions()    __asm(" CPSIE I ")
+
+/* Disable Exceptions ... This Macro disable IRQ interrupts, Programmable Systems Exceptions and Faults by setting the I-bit in the PRIMASK. */
+#define Disable_Exceptions()   __asm(" CPSID I ")
+
+/* Enable Faults ... This Macro enable Faults by clearing the F-bit in the FAULTMASK */
+#define Enable_Faults()        __asm(" CPSIE F ")
+
+/* Disable Faults ... This Macro disable Faults by setting the F-bit in the FAULTMASK */
+#define Disable_Faults()       __asm(" CPSID F ")
+
+/* Wait For Interrupt ... This Macro sleeps until an interrupt is pending, even a masked one */
+#define Wait_For_Interrupt()   __asm(" WFI ")
+
+#endif /* TM4C_HOST_SIM */
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 NVIC_IRQType;
+
+typedef uint8 NVIC_IRQPriorityType;
+
+typedef void (*NVIC_HandlerType)(void);
+
+typedef struct
+{
+    uint32 word[NVIC_IRQ_MASK_WORDS];
+} NVIC_IRQMaskType;
+
+typedef enum
+{
+    EXCEPTION_RESET_TYPE,
+    EXCEPTION_NMI_TYPE,
+    EXCEPTION_HARD_FAULT_TYPE,
+    EXCEPTION_MEM_FAULT_TYPE,
+    EXCEPTION_BUS_FAULT_TYPE,
+    EXCEPTION_USAGE_FAULT_TYPE,
+    EXCEPTION_SVC_TYPE,
+    EXCEPTION_DEBUG_MONITOR_TYPE,
+    EXCEPTION_PEND_SV_TYPE,
+    EXCEPTION_SYSTICK_TYPE
+} NVIC_ExceptionType;
+
+typedef uint8 NVIC_ExceptionPriorityType;
+
+/*
+ * PRIGROUP values for the 3 implemented priority bits, named after the
+ * {preemption, subpriority} bits. Only the preemption priority decides if an
+ * exception preempts another one (and is compared to BASEPRI), the
+ * subpriority only orders the pending exceptions of the same level.
+ */
+typedef enum
+{
+    NVIC_PRIORITY_GROUP_3_0 = 4, // 8 preemption levels (reset, PRIGROUP 0 to 3 act the same)
+    NVIC_PRIORITY_GROUP_2_1,     // 4 preemption levels, 2 subpriorities
+    NVIC_PRIORITY_GROUP_1_2,     // 2 preemption levels, 4 subpriorities
+    NVIC_PRIORITY_GROUP_0_3      // No preemption, 8 subpriorities
+} NVIC_PriorityGroupType;
+
+/* Saved BASEPRI (bits 7:0) and PRIMASK (bit 8) of an enclosing critical section */
+typedef uint32 NVIC_CriticalStateType;
+
+typedef struct
+{
+    NVIC_IRQType irq;
+    NVIC_IRQPriorityType priority;
+} NVIC_IRQPriorityConfigType;
+
+typedef struct
+{
+    NVIC_ExceptionType exception;
+    NVIC_ExceptionPriorityType priority;
+} NVIC_ExceptionPriorityConfigType;
+
+typedef struct
+{
+    uint8 registerIndex; /* n of the PRIn register */
+    uint32 value;        /* Built with NVIC_PRI_WORD */
+} NVIC_PriorityWordType;
+
+/* NVIC configuration saved by NVIC_SaveContext, only 32-bit words with the
+ * checksum last */
+typedef struct
+{
+    uint32 magic;                                 /* NVIC_CONTEXT_MAGIC */
+    uint32 enable[NVIC_IRQ_MASK_WORDS];           /* ENn */
+    uint32 priority[NVIC_PRI_REGISTERS];          /* PRIn */
+    uint32 systemPriority[3];                     /* SYSPRI1 to SYSPRI3 */
+    uint32 faultEnable;                           /* Fault enable bits of SYSHNDCTRL */
+    uint32 priorityGroup;                         /* PRIGROUP field of APINT */
+    uint32 checksum;
+} NVIC_ContextType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: NVIC_EnableIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be enabled
+ * Return Value: None
+ * Description: Function to enable the interrupt request for the specified IRQ.
+ *********************************************************************/
+void NVIC_EnableIRQ(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_DisableIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be disabled
+ * Return Value: None
+ * Description: Function to disable the interrupt request for the specified IRQ.
+ *********************************************************************/
+void NVIC_DisableIRQ(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_EnableIRQMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be enabled
+ * Return Value: None
+ * Description: Function to enable several IRQs at once, with one store
+ * per Enable register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_EnableIRQMask(const NVIC_IRQMaskType *IRQ_Mask);
+
+/**********************************************************************
+ * Service Name: NVIC_DisableIRQMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be disabled
+ * Return Value: None
+ * Description: Function to disable several IRQs at once, with one store
+ * per Disable register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_DisableIRQMask(const NVIC_IRQMaskType *IRQ_Mask);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be pended
+ * Return Value: None
+ * Description: Function to set the pending state of the specified IRQ. An enabled IRQ
+ * is then taken as soon as its priority allows it, which makes it a software
+ * interrupt when no peripheral uses it.
+ *********************************************************************/
+void NVIC_SetPending(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_ClearPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be cleared
+ * Return Value: None
+ * Description: Function to clear the pending state of the specified IRQ.
+ *********************************************************************/
+void NVIC_ClearPending(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_IsPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: TRUE if the IRQ is pending (FALSE for an unsupported IRQ number)
+ * Description: Function to read the pending state of the specified IRQ.
+ *********************************************************************/
+boolean NVIC_IsPending(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_IsActive
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: TRUE if the handler of the IRQ is running or preempted
+ *               (FALSE for an unsupported IRQ number)
+ * Description: Function to read the active state of the specified IRQ.
+ *********************************************************************/
+boolean NVIC_IsActive(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_TriggerSoftware
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number to be pended
+ * Return Value: None
+ * Description: Function to pend the specified IRQ through the Software Trigger
+ * register: one store of the IRQ number, no bit mask to build. Unprivileged
+ * code can use it when the USERSETMPEND bit of CFGCTRL is set.
+ *********************************************************************/
+void NVIC_TriggerSoftware(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPendingMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be pended
+ * Return Value: None
+ * Description: Function to pend several IRQs at once, with one store per Pend
+ * register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_SetPendingMask(const NVIC_IRQMaskType *IRQ_Mask);
+
+/**********************************************************************
+ * Service Name: NVIC_ClearPendingMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Set of the IRQs to be cleared
+ * Return Value: None
+ * Description: Function to clear the pending state of several IRQs at once, with one
+ * store per Unpend register holding an IRQ of the set.
+ *********************************************************************/
+void NVIC_ClearPendingMask(const NVIC_IRQMaskType *IRQ_Mask);
+
+/**********************************************************************
+ * Service Name: NVIC_GetPendingMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Filled with the set of the pending IRQs
+ * Return Value: None
+ * Description: Function to read the pending state of all the IRQs, one read per
+ * Pend register.
+ *********************************************************************/
+void NVIC_GetPendingMask(NVIC_IRQMaskType *IRQ_Mask);
+
+/**********************************************************************
+ * Service Name: NVIC_GetActiveMask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Mask - Filled with the set of the active IRQs
+ * Return Value: None
+ * Description: Function to read the active state of all the IRQs, one read per
+ * Active register.
+ *********************************************************************/
+void NVIC_GetActiveMask(NVIC_IRQMaskType *IRQ_Mask);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number for which priority is to be set
+ *             IRQ_Priority - Priority level to be assigned to the specified IRQ
+ * Return Value: None
+ * Description: Function to set the priority level for the specified IRQ.
+ *********************************************************************/
+void NVIC_SetPriorityIRQ(NVIC_IRQType IRQ_Num, NVIC_IRQPriorityType IRQ_Priority);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityIRQTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Table - Array of {IRQ, priority} pairs (any order)
+ *             Count - Number of entries in the table
+ * Return Value: None
+ * Description: Function to set the priority of several IRQs. The entries
+ * are grouped by PRI register and each touched register is written once
+ * (read first only when some of its IRQs are not in the table).
+ *********************************************************************/
+void NVIC_SetPriorityIRQTable(const NVIC_IRQPriorityConfigType *Table, uint8 Count);
+
+/**********************************************************************
+ * Service Name: NVIC_WritePriorityWords
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Words - Array of whole PRI register values
+ *             Count - Number of entries in the array
+ * Return Value: None
+ * Description: Function to write PRI registers packed at compile time
+ * with NVIC_PRI_WORD: one store per register and no read.
+ *********************************************************************/
+void NVIC_WritePriorityWords(const NVIC_PriorityWordType *Words, uint8 Count);
+
+/**********************************************************************
+ * Service Name: NVIC_EnableException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number to be enabled
+ * Return Value: None
+ * Description: Function to enable the specified exception in the NVIC.
+ *********************************************************************/
+void NVIC_EnableException(NVIC_ExceptionType Exception_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_DisableException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number to be disabled
+ * Return Value: None
+ * Description: Function to disable the specified exception in the NVIC.
+ *********************************************************************/
+void NVIC_DisableException(NVIC_ExceptionType Exception_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number for which priority is to be set
+ *             Exception_Priority - Priority level to be assigned to the specified exception
+ * Return Value: None
+ * Description: Function to set the priority level for the specified exception.
+ *********************************************************************/
+void NVIC_SetPriorityException(NVIC_ExceptionType Exception_Num, NVIC_ExceptionPriorityType Exception_Priority);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityExceptionTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Table - Array of {exception, priority} pairs (any order)
+ *             Count - Number of entries in the table
+ * Return Value: None
+ * Description: Function to set the priority of several exceptions with
+ * one write per touched system priority register (SYSPRI1 to SYSPRI3).
+ *********************************************************************/
+void NVIC_SetPriorityExceptionTable(const NVIC_ExceptionPriorityConfigType *Table, uint8 Count);
+
+/**********************************************************************
+ * Service Name: NVIC_SetPriorityGrouping
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Group - Split of the priority bits between preemption
+ *             priority and subpriority
+ * Return Value: None
+ * Description: Function to set the PRIGROUP field of the APINT register.
+ * Set it once at start-up, before the priorities are given.
+ *********************************************************************/
+void NVIC_SetPriorityGrouping(NVIC_PriorityGroupType Group);
+
+/**********************************************************************
+ * Service Name: NVIC_GetPriorityGrouping
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Priority grouping in use
+ * Description: Function to read the PRIGROUP field of the APINT register.
+ *********************************************************************/
+NVIC_PriorityGroupType NVIC_GetPriorityGrouping(void);
+
+/**********************************************************************
+ * Service Name: NVIC_EncodePriority
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Group - Priority grouping
+ *             Preempt - Preemption priority (extra high bits are dropped)
+ *             Sub - Subpriority (extra high bits are dropped)
+ * Return Value: Priority value for NVIC_SetPriorityIRQ and
+ *               NVIC_SetPriorityException
+ * Description: Function to pack a {preemption priority, subpriority} pair.
+ *********************************************************************/
+NVIC_IRQPriorityType NVIC_EncodePriority(NVIC_PriorityGroupType Group, uint8 Preempt, uint8 Sub);
+
+/**********************************************************************
+ * Service Name: NVIC_DecodePriority
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Priority - Priority value
+ *             Group - Priority grouping
+ *             Preempt - Filled with the preemption priority
+ *             Sub - Filled with the subpriority
+ * Return Value: None
+ * Description: Function to split a priority value into its
+ * {preemption priority, subpriority} pair.
+ *********************************************************************/
+void NVIC_DecodePriority(NVIC_IRQPriorityType Priority, NVIC_PriorityGroupType Group, uint8 *Preempt, uint8 *Sub);
+
+/**********************************************************************
+ * Service Name: NVIC_GetPriorityIRQ
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: Priority level of the IRQ (0 for an unsupported IRQ number)
+ * Description: Function to read the priority level of the specified IRQ
+ * (from the shadow when NVIC_SHADOW_ENABLE is on).
+ *********************************************************************/
+NVIC_IRQPriorityType NVIC_GetPriorityIRQ(NVIC_IRQType IRQ_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_GetPriorityException
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - Exception number
+ * Return Value: Priority level of the exception (0 for an exception with a
+ *               fixed priority)
+ * Description: Function to read the priority level of the specified exception
+ * (from the shadow when NVIC_SHADOW_ENABLE is on).
+ *********************************************************************/
+NVIC_ExceptionPriorityType NVIC_GetPriorityException(NVIC_ExceptionType Exception_Num);
+
+/**********************************************************************
+ * Service Name: NVIC_IsIRQEnabled
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number
+ * Return Value: TRUE if the IRQ is enabled (FALSE for an unsupported IRQ number)
+ * Description: Function to read the enable state of the specified IRQ
+ * (from the shadow when NVIC_SHADOW_ENABLE is on).
+ *********************************************************************/
+boolean NVIC_IsIRQEnabled(NVIC_IRQType IRQ_Num);
+
+#if NVIC_SHADOW_ENABLE
+/**********************************************************************
+ * Service Name: NVIC_ShadowResync
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Function to load the shadow from the Enable and priority
+ * registers. The shadow starts with the reset values: call it first when
+ * code outside this driver (boot loader, start-up code) may have changed
+ * them.
+ *********************************************************************/
+void NVIC_ShadowResync(void);
+
+/**********************************************************************
+ * Service Name: NVIC_ShadowVerify
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE if the shadow matches the registers
+ * Description: Function to compare the shadow with the Enable and priority
+ * registers (implemented bits only), for the debug builds.
+ *********************************************************************/
+boolean NVIC_ShadowVerify(void);
+#endif /* NVIC_SHADOW_ENABLE */
+
+/**********************************************************************
+ * Service Name: NVIC_SaveContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Context - Filled with the configuration
+ * Return Value: None
+ * Description: Function to save the Enable, PRIn and SYSPRIn registers,
+ * the fault enables of SYSHNDCTRL and the priority grouping, e.g. before
+ * deep sleep or in a context kept in NVIC_NOINIT RAM across a warm reset.
+ * With NVIC_SHADOW_ENABLE on, the Enable and priority words are copied
+ * from RAM.
+ *********************************************************************/
+void NVIC_SaveContext(NVIC_ContextType *a_Context);
+
+/**********************************************************************
+ * Service Name: NVIC_RestoreContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Context - Configuration saved by NVIC_SaveContext
+ * Return Value: FALSE if the magic or the checksum is wrong (nothing is
+ * written then)
+ * Description: Function to write a saved configuration back with word
+ * stores, with the interrupts masked: the IRQs off in the context are
+ * disabled first, the IRQs on are enabled last. SYSHNDCTRL is the only
+ * register read: its fault enables are replaced, its active and pending
+ * bits are kept, so it may be called from a handler too. The handlers of
+ * the RAM vector table are not part of the context.
+ *********************************************************************/
+boolean NVIC_RestoreContext(const NVIC_ContextType *a_Context);
+
+/**********************************************************************
+ * Service Name: NVIC_RelocateVectorTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Function to copy the vector table in use into the aligned
+ * RAM table and point VTABLE at it. Does nothing once relocated.
+ *********************************************************************/
+void NVIC_RelocateVectorTable(void);
+
+/**********************************************************************
+ * Service Name: NVIC_IsVectorTableRelocated
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE if VTABLE points at the RAM table
+ * Description: Function to check whether the vector table has been
+ * relocated (by NVIC_RelocateVectorTable or a handler registration).
+ *********************************************************************/
+boolean NVIC_IsVectorTableRelocated(void);
+
+/**********************************************************************
+ * Service Name: NVIC_RegisterHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: IRQ_Num - IRQ number (0 to NVIC_VECTOR_IRQS - 1)
+ *             Handler - Function entered directly by the IRQ
+ * Return Value: FALSE for an unsupported IRQ number or a NULL handler
+ * Description: Function to install the handler of an IRQ in the RAM vector
+ * table (relocated first if needed). The entry is replaced by one store,
+ * so the handler can be swapped while the IRQ is enabled. The handler is
+ * not wrapped: with ISRSTATS_ENABLE it places ISRSTATS_ENTER/EXIT itself.
+ *********************************************************************/
+boolean NVIC_RegisterHandler(NVIC_IRQType IRQ_Num, NVIC_HandlerType Handler);
+
+/**********************************************************************
+ * Service Name: NVIC_RegisterExceptionHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - System exception (not the reset vector)
+ *             Handler - Function entered directly by the exception
+ * Return Value: FALSE for the reset vector or a NULL handler
+ * Description: Function to install the handler of a system exception in
+ * the RAM vector table (relocated first if needed).
+ *********************************************************************/
+boolean NVIC_RegisterExceptionHandler(NVIC_ExceptionType Exception_Num, NVIC_HandlerType Handler);
+
+/**********************************************************************
+ * Service Name: NVIC_EnterCritical
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ceiling - Priority ceiling (1 to 7): the exceptions with this
+ *             priority or a lower one are masked, the higher ones stay live.
+ *             With a priority grouping only its preemption part counts.
+ *             0 masks everything (PRIMASK).
+ * Return Value: State to be given back to NVIC_ExitCritical
+ * Description: Function to enter a nestable critical section by raising
+ * BASEPRI to the ceiling (never lowering it).
+ *********************************************************************/
+NVIC_CriticalStateType NVIC_EnterCritical(NVIC_IRQPriorityType Ceiling);
+
+/**********************************************************************
+ * Service Name: NVIC_ExitCritical
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: State - Value returned by the matching NVIC_EnterCritical
+ * Return Value: None
+ * Description: Function to leave a critical section, restoring the masking
+ * of the enclosing one.
+ *********************************************************************/
+void NVIC_ExitCritical(NVIC_CriticalStateType State);
+
+/**********************************************************************
+ * Service Name: NVIC_IsExceptionMasked
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Exception_Num - System exception to be checked
+ * Return Value: TRUE if the exception cannot be taken now
+ * Description: Function to check PRIMASK, BASEPRI and the handler being
+ * run (if any) against the priority of a system exception (its preemption
+ * part with a priority grouping). Reset, NMI and Hard Fault are never masked.
+ *********************************************************************/
+boolean NVIC_IsExceptionMasked(NVIC_ExceptionType Exception_Num);
+
+#ifdef __cplusplus
+
+/* Scoped critical section: entered by the constructor, left by the destructor */
+class NVIC_CriticalSection
+{
+public:
+    explicit NVIC_CriticalSection(NVIC_IRQPriorityType Ceiling) : m_State(NVIC_EnterCritical(Ceiling)) {}
+    ~NVIC_CriticalSection() { NVIC_ExitCritical(m_State); }
+
+private:
+    NVIC_CriticalSection(const NVIC_CriticalSection &);
+    NVIC_CriticalSection &operator=(const NVIC_CriticalSection &);
+
+    NVIC_CriticalStateType m_State;
+};
+
+#endif /* __cplusplus */
+
+#endif /* NVIC_H_ */
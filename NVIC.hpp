@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * Module: NVIC
+ *
+ * File Name: NVIC.hpp
+ *
+ * Description: Header-only C++ front-end of the NVIC driver for IRQ numbers
+ *              and priorities known at compile time. The register, bit and
+ *              shift are template constants, so each call is one store
+ *              (one load for the queries) with no range check left at run
+ *              time: an out of range IRQ or priority does not compile. The
+ *              priorities are written with byte stores, so no read is needed.
+ *              Use the C API of NVIC.h for values known at run time only.
+ *
+ *              With NVIC_SHADOW_ENABLE on, enable, disable and the priority
+ *              updates go through the C API, which keeps the shadow.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef NVIC_HPP_
+#define NVIC_HPP_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "NVIC.h"
+#include "Mcu_Registers.h"
+
+/*******************************************************************************
+ *                           Template Definitions                              *
+ *******************************************************************************/
+namespace Nvic
+{
+
+/* IRQs of the vector table, all reached through the register banks of the driver */
+static const uint8 MAX_IRQS = NVIC_VECTOR_IRQS;
+
+/* Vector number of a system exception with a programmable priority, 0 otherwise */
+constexpr uint8 exceptionVector(NVIC_ExceptionType Exception_Num)
+{
+    return (Exception_Num == EXCEPTION_MEM_FAULT_TYPE) ? 4 :
+           (Exception_Num == EXCEPTION_BUS_FAULT_TYPE) ? 5 :
+           (Exception_Num == EXCEPTION_USAGE_FAULT_TYPE) ? 6 :
+           (Exception_Num == EXCEPTION_SVC_TYPE) ? 11 :
+           (Exception_Num == EXCEPTION_DEBUG_MONITOR_TYPE) ? 12 :
+           (Exception_Num == EXCEPTION_PEND_SV_TYPE) ? 14 :
+           (Exception_Num == EXCEPTION_SYSTICK_TYPE) ? 15 : 0;
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline void enable()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+#if NVIC_SHADOW_ENABLE
+    NVIC_EnableIRQ(IRQ_Num);
+#else
+    NVIC_EN_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) = NVIC_IRQ_MASK_BIT(IRQ_Num); // Write 1 to set
+#endif
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline void disable()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+#if NVIC_SHADOW_ENABLE
+    NVIC_DisableIRQ(IRQ_Num);
+#else
+    NVIC_DIS_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) = NVIC_IRQ_MASK_BIT(IRQ_Num); // Write 1 to clear
+#endif
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline boolean isEnabled()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+#if NVIC_SHADOW_ENABLE
+    return NVIC_IsIRQEnabled(IRQ_Num);
+#else
+    return ((NVIC_EN_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) & NVIC_IRQ_MASK_BIT(IRQ_Num)) != 0) ? TRUE : FALSE;
+#endif
+}
+
+template <NVIC_IRQType IRQ_Num, NVIC_IRQPriorityType IRQ_Priority>
+inline void setPriority()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+    static_assert(IRQ_Priority <= 7, "Nvic: the TM4C123 implements 3 priority bits (0 to 7)");
+#if NVIC_SHADOW_ENABLE
+    NVIC_SetPriorityIRQ(IRQ_Num, IRQ_Priority);
+#else
+    NVIC_PRI_BYTE_REG(IRQ_Num) = (uint8)(IRQ_Priority << 5); // Byte store, the other IRQs are not touched
+#endif
+}
+
+template <NVIC_ExceptionType Exception_Num, NVIC_ExceptionPriorityType Exception_Priority>
+inline void setExceptionPriority()
+{
+    static_assert(exceptionVector(Exception_Num) != 0, "Nvic: reset, NMI and hard fault have a fixed priority");
+    static_assert(Exception_Priority <= 7, "Nvic: the TM4C123 implements 3 priority bits (0 to 7)");
+#if NVIC_SHADOW_ENABLE
+    NVIC_SetPriorityException(Exception_Num, Exception_Priority);
+#else
+    NVIC_SYSTEM_PRI_BYTE_REG(exceptionVector(Exception_Num)) = (uint8)(Exception_Priority << 5);
+#endif
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline void setPending()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+    NVIC_PEND_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) = NVIC_IRQ_MASK_BIT(IRQ_Num); // Write 1 to set
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline void clearPending()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+    NVIC_UNPEND_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) = NVIC_IRQ_MASK_BIT(IRQ_Num); // Write 1 to clear
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline boolean isPending()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+    return ((NVIC_PEND_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) & NVIC_IRQ_MASK_BIT(IRQ_Num)) != 0) ? TRUE : FALSE;
+}
+
+template <NVIC_IRQType IRQ_Num>
+inline boolean isActive()
+{
+    static_assert(IRQ_Num < MAX_IRQS, "Nvic: unsupported IRQ number");
+    return ((NVIC_ACTIVE_REG(NVIC_IRQ_MASK_WORD(IRQ_Num)) & NVIC_IRQ_MASK_BIT(IRQ_Num)) != 0) ? TRUE : FALSE;
+}
+
+} /* namespace Nvic */
+
+#endif /* NVIC_HPP_ */
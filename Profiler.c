@@ -0,0 +1,254 @@
+/******************************************************************************
+ *
+ * Module: Profiler
+ *
+ * File Name: Profiler.c
+ *
+ * Description: Source file for the stopwatch profiler (cycle statistics per
+ *              code section).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "Profiler.h"
+
+#if PROFILER_ENABLE
+
+#include "NVIC.h"
+#include "SysTick.h"
+#include "Mcu_Registers.h"
+
+#define DWT_CTRL_CYCCNTENA                   0x00000001
+#define CORE_DEMCR_TRCENA                    0x01000000
+
+#if PROFILER_USE_DWT
+#define PROFILER_NOW()                       ((Profiler_TimeType)DWT_CYCCNT_REG)
+#else
+#define PROFILER_NOW()                       ((Profiler_TimeType)SysTick_GetTicks())
+#endif
+
+/* Empty sections timed by Profiler_Init, the shortest one is the overhead */
+#define PROFILER_CALIBRATION_RUNS            8
+
+typedef struct
+{
+    const char *name;
+    uint32 count;
+    uint64 total;
+    uint32 min;
+    uint32 max;
+} Profiler_SiteStatsType;
+
+static Profiler_SiteStatsType g_ProfilerSites[PROFILER_MAX_SITES];
+static Profiler_SiteType g_ProfilerSiteCount = 0;
+static uint32 g_ProfilerOverhead = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void Profiler_Clear(Profiler_SiteStatsType *a_Stats)
+{
+    a_Stats->count = 0;
+    a_Stats->total = 0;
+    a_Stats->min = 0xFFFFFFFFUL;
+    a_Stats->max = 0;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Profiler_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Starts the DWT cycle counter (PROFILER_USE_DWT), empties
+ * the site table and measures the cost of an empty section, which is
+ * taken off every measurement. SysTick must run for the SysTick time
+ * stamps.
+ *********************************************************************/
+void Profiler_Init(void)
+{
+    Profiler_TimeType start;
+    uint32 elapsed;
+    uint8 run;
+
+#if PROFILER_USE_DWT
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA; // Power the DWT unit
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA; // Start the cycle counter
+#endif
+
+    g_ProfilerSiteCount = 0;
+    g_ProfilerOverhead = 0xFFFFFFFFUL;
+    for (run = 0; run < PROFILER_CALIBRATION_RUNS; run++)
+    {
+        start = Profiler_Start();
+        elapsed = PROFILER_NOW() - start;
+        if (elapsed < g_ProfilerOverhead)
+        {
+            g_ProfilerOverhead = elapsed; // An interrupt may lengthen some runs
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: Profiler_Register
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Name - Name of the site (kept, not copied)
+ * Return Value: Site number, PROFILER_INVALID_SITE when the table is full
+ * Description: Adds a site to the table, at start-up.
+ *********************************************************************/
+Profiler_SiteType Profiler_Register(const char *a_Name)
+{
+    Profiler_SiteType site;
+
+    if (g_ProfilerSiteCount >= PROFILER_MAX_SITES)
+    {
+        return PROFILER_INVALID_SITE;
+    }
+
+    site = g_ProfilerSiteCount;
+    g_ProfilerSites[site].name = a_Name;
+    Profiler_Clear(&g_ProfilerSites[site]);
+    g_ProfilerSiteCount++;
+
+    return site;
+}
+
+
+/**********************************************************************
+ * Service Name: Profiler_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Start stamp, to be given to Profiler_Stop
+ * Description: Takes the start time stamp of a section (PROFILER_START).
+ *********************************************************************/
+Profiler_TimeType Profiler_Start(void)
+{
+    return PROFILER_NOW();
+}
+
+
+/**********************************************************************
+ * Service Name: Profiler_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant for different sites
+ * Parameters: a_Site - Site of the section
+ *             a_Start - Stamp returned by Profiler_Start
+ * Return Value: Cycles of the section
+ * Description: Ends a section (PROFILER_STOP) and adds it to the site
+ * statistics. A site is stopped from one priority level; the times include
+ * the interrupts taken during the section.
+ *********************************************************************/
+uint32 Profiler_Stop(Profiler_SiteType a_Site, Profiler_TimeType a_Start)
+{
+    Profiler_SiteStatsType *stats;
+    uint32 elapsed = PROFILER_NOW() - a_Start; // Modulo 2^32: the stamp wrapping in between is harmless
+
+    elapsed = (elapsed > g_ProfilerOverhead) ? (elapsed - g_ProfilerOverhead) : 0;
+    if (a_Site < g_ProfilerSiteCount)
+    {
+        stats = &g_ProfilerSites[a_Site];
+        stats->count++;
+        stats->total += elapsed;
+        if (elapsed < stats->min)
+        {
+            stats->min = elapsed;
+        }
+        if (elapsed > stats->max)
+        {
+            stats->max = elapsed;
+        }
+    }
+
+    return elapsed;
+}
+
+
+/**********************************************************************
+ * Service Name: Profiler_GetSummary
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Site - Site number
+ *             a_Summary - Filled with a consistent copy of the statistics
+ * Return Value: FALSE if the site is not registered
+ * Description: Returns the statistics of one site with the mean computed.
+ *********************************************************************/
+boolean Profiler_GetSummary(Profiler_SiteType a_Site, Profiler_SummaryType *a_Summary)
+{
+    Profiler_SiteStatsType copy;
+    NVIC_CriticalStateType state;
+
+    if (a_Site >= g_ProfilerSiteCount)
+    {
+        return FALSE;
+    }
+
+    state = NVIC_EnterCritical(0); // Sections may be stopped in any handler
+    copy = g_ProfilerSites[a_Site];
+    NVIC_ExitCritical(state);
+
+    a_Summary->name = copy.name;
+    a_Summary->count = copy.count;
+    a_Summary->total = copy.total;
+    a_Summary->min = (copy.count != 0) ? copy.min : 0;
+    a_Summary->max = copy.max;
+    a_Summary->mean = (copy.count != 0) ? (uint32)(copy.total / copy.count) : 0;
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: Profiler_Dump
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Function called with the summary of each site
+ *             timed at least once
+ * Return Value: None
+ * Description: Walks the site table, to print or log it from thread code.
+ * Each site is copied with the interrupts masked for a few cycles only.
+ *********************************************************************/
+void Profiler_Dump(Profiler_DumpCallBackType Ptr2Func)
+{
+    Profiler_SummaryType summary;
+    Profiler_SiteType site;
+
+    for (site = 0; site < g_ProfilerSiteCount; site++)
+    {
+        if (Profiler_GetSummary(site, &summary) && (summary.count != 0))
+        {
+            (*Ptr2Func)(site, &summary);
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: Profiler_Reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Site - Site number
+ * Return Value: None
+ * Description: Clears the statistics of one site, its name is kept.
+ *********************************************************************/
+void Profiler_Reset(Profiler_SiteType a_Site)
+{
+    NVIC_CriticalStateType state;
+
+    if (a_Site < g_ProfilerSiteCount)
+    {
+        state = NVIC_EnterCritical(0);
+        Profiler_Clear(&g_ProfilerSites[a_Site]);
+        NVIC_ExitCritical(state);
+    }
+}
+
+#endif /* PROFILER_ENABLE */
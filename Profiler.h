@@ -0,0 +1,184 @@
+/******************************************************************************
+ *
+ * Module: Profiler
+ *
+ * File Name: Profiler.h
+ *
+ * Description: Header file for the stopwatch profiler. Code sections
+ *              (sites) are timed from a start stamp kept by the caller to a
+ *              stop that adds the elapsed cycles to the site statistics
+ *              (count, total, min, max) in a fixed table. The start stamp
+ *              lives on the caller's stack, so sections nest freely and a
+ *              site can be timed from several places. Everything compiles
+ *              out unless PROFILER_ENABLE is set to 1.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE                      0
+#endif
+
+/* Time stamps from the DWT cycle counter (1: a single register read,
+ * sections up to 2^32 cycles) or from SysTick_GetTicks (0, for cores
+ * without DWT: the down-counter and the driver time base, any number of
+ * wraps and reload changes, much slower to take) */
+#ifndef PROFILER_USE_DWT
+#define PROFILER_USE_DWT                     1
+#endif
+
+/* Number of sites in the table */
+#ifndef PROFILER_MAX_SITES
+#define PROFILER_MAX_SITES                   16
+#endif
+
+#define PROFILER_INVALID_SITE                0xFF
+
+/* Hooks placed around a profiled section */
+#if PROFILER_ENABLE
+#define PROFILER_START(Stamp)                Profiler_TimeType Stamp = Profiler_Start()
+#define PROFILER_STOP(Site, Stamp)           Profiler_Stop((Site), (Stamp))
+#else
+#define PROFILER_START(Stamp)
+#define PROFILER_STOP(Site, Stamp)
+#endif
+
+#if PROFILER_ENABLE
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 Profiler_SiteType;
+
+typedef uint32 Profiler_TimeType;
+
+typedef struct
+{
+    const char *name;
+    uint32 count;                      /* Sections timed */
+    uint64 total;                      /* Cycles, overhead of the stopwatch removed */
+    uint32 min;
+    uint32 max;
+    uint32 mean;
+} Profiler_SummaryType;
+
+typedef void (*Profiler_DumpCallBackType)(Profiler_SiteType a_Site, const Profiler_SummaryType *a_Summary);
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Profiler_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Starts the DWT cycle counter (PROFILER_USE_DWT), empties
+ * the site table and measures the cost of an empty section, which is
+ * taken off every measurement. SysTick must run for the SysTick time
+ * stamps.
+ *********************************************************************/
+void Profiler_Init(void);
+
+/**********************************************************************
+ * Service Name: Profiler_Register
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Name - Name of the site (kept, not copied)
+ * Return Value: Site number, PROFILER_INVALID_SITE when the table is full
+ * Description: Adds a site to the table, at start-up.
+ *********************************************************************/
+Profiler_SiteType Profiler_Register(const char *a_Name);
+
+/**********************************************************************
+ * Service Name: Profiler_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Start stamp, to be given to Profiler_Stop
+ * Description: Takes the start time stamp of a section (PROFILER_START).
+ *********************************************************************/
+Profiler_TimeType Profiler_Start(void);
+
+/**********************************************************************
+ * Service Name: Profiler_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant for different sites
+ * Parameters: a_Site - Site of the section
+ *             a_Start - Stamp returned by Profiler_Start
+ * Return Value: Cycles of the section
+ * Description: Ends a section (PROFILER_STOP) and adds it to the site
+ * statistics. A site is stopped from one priority level; the times include
+ * the interrupts taken during the section.
+ *********************************************************************/
+uint32 Profiler_Stop(Profiler_SiteType a_Site, Profiler_TimeType a_Start);
+
+/**********************************************************************
+ * Service Name: Profiler_GetSummary
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Site - Site number
+ *             a_Summary - Filled with a consistent copy of the statistics
+ * Return Value: FALSE if the site is not registered
+ * Description: Returns the statistics of one site with the mean computed.
+ *********************************************************************/
+boolean Profiler_GetSummary(Profiler_SiteType a_Site, Profiler_SummaryType *a_Summary);
+
+/**********************************************************************
+ * Service Name: Profiler_Dump
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Function called with the summary of each site
+ *             timed at least once
+ * Return Value: None
+ * Description: Walks the site table, to print or log it from thread code.
+ * Each site is copied with the interrupts masked for a few cycles only.
+ *********************************************************************/
+void Profiler_Dump(Profiler_DumpCallBackType Ptr2Func);
+
+/**********************************************************************
+ * Service Name: Profiler_Reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Site - Site number
+ * Return Value: None
+ * Description: Clears the statistics of one site, its name is kept.
+ *********************************************************************/
+void Profiler_Reset(Profiler_SiteType a_Site);
+
+#ifdef __cplusplus
+
+/* Scoped section: started by the constructor, stopped by the destructor */
+class Profiler_Scope
+{
+public:
+    explicit Profiler_Scope(Profiler_SiteType a_Site) : m_Site(a_Site), m_Start(Profiler_Start()) {}
+    ~Profiler_Scope() { (void)Profiler_Stop(m_Site, m_Start); }
+
+private:
+    Profiler_Scope(const Profiler_Scope &);
+    Profiler_Scope &operator=(const Profiler_Scope &);
+
+    Profiler_SiteType m_Site;
+    Profiler_TimeType m_Start;
+};
+
+#endif /* __cplusplus */
+
+#endif /* PROFILER_ENABLE */
+
+#endif /* PROFILER_H_ */
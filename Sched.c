@@ -0,0 +1,341 @@
+/******************************************************************************
+ *
+ * Module: Sched
+ *
+ * File Name: Sched.c
+ *
+ * Description: Source file for the preemptive run-to-completion scheduler.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "Sched.h"
+#include "SwTimer.h"
+#include "NVIC.h"
+#include "Mcu_Registers.h"
+
+#define NVIC_INTCTRL_PENDSVSET               0x10000000
+
+/* Most activations a task can have pending */
+#define SCHED_MAX_ACTIVATIONS                0xFF
+
+/* Compile-time check: one bit of the ready set per priority level */
+typedef char Sched_PriorityFitsReadySet[((SCHED_MAX_PRIORITY >= 1) && (SCHED_MAX_PRIORITY <= 32)) ? 1 : -1];
+
+/* Ready set bit of a priority level (bit 0 is priority 1) */
+#define SCHED_READY_BIT(Priority)            (1UL << ((Priority) - 1))
+
+/* Highest priority of a non-empty ready set, with count leading zeros */
+#if defined(__GNUC__)
+#define SCHED_HIGHEST_READY(Ready)           ((Sched_PriorityType)(32 - __builtin_clz(Ready)))
+#else
+#define SCHED_HIGHEST_READY(Ready)           ((Sched_PriorityType)(32 - _norm(Ready)))
+#endif
+
+typedef struct
+{
+    Sched_TaskFunctionType function;
+    void *context;
+    uint8 activations;              /* Activations not run yet */
+    SwTimer_IdType timer;           /* Periodic activation timer */
+} Sched_TaskType;
+
+static Sched_TaskType g_SchedTasks[SCHED_MAX_PRIORITY];
+static volatile uint32 g_SchedReady = 0;
+static volatile Sched_PriorityType g_SchedCurrent = SCHED_IDLE_PRIORITY;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Runs the ready tasks above the priority found on entry, highest first,
+ * then gives that priority back. A task activated above the running one
+ * pends PendSV again, which nests a new dispatch on top of the running task.
+ */
+#if defined(__GNUC__) && !defined(TM4C_HOST_SIM)
+__attribute__((used))
+#endif
+static void Sched_RunReady(void)
+{
+    NVIC_CriticalStateType state;
+    Sched_PriorityType preempted;
+    Sched_PriorityType priority;
+    Sched_TaskType *task;
+
+    state = NVIC_EnterCritical(SCHED_CRITICAL_CEILING);
+    preempted = g_SchedCurrent;
+    while ((g_SchedReady != 0) && ((priority = SCHED_HIGHEST_READY(g_SchedReady)) > preempted))
+    {
+        task = &g_SchedTasks[priority - 1];
+        task->activations--;
+        if (task->activations == 0)
+        {
+            g_SchedReady &= ~SCHED_READY_BIT(priority);
+        }
+        g_SchedCurrent = priority;
+        NVIC_ExitCritical(state);
+
+        (*task->function)(task->context);
+
+        state = NVIC_EnterCritical(SCHED_CRITICAL_CEILING);
+    }
+    g_SchedCurrent = preempted;
+    NVIC_ExitCritical(state);
+}
+
+/* Periodic timer expiry, in SysTick interrupt context */
+static void Sched_TimerExpired(void *a_Context)
+{
+    Sched_TaskType *task = (Sched_TaskType *)a_Context;
+
+    (void)Sched_Activate((Sched_PriorityType)(task - g_SchedTasks) + 1);
+}
+
+/*
+ * Exception glue. On the target PendSV cannot run the tasks itself (they
+ * could not be preempted by the IRQs at its level and below), so it builds
+ * an exception frame returning to Sched_DispatchThread in thread mode. The
+ * dispatch ends with SVC, whose handler drops its own frame and returns to
+ * the code preempted by PendSV with the EXC_RETURN saved on entry. Thread
+ * code must run on the main stack.
+ */
+#if defined(TM4C_HOST_SIM)
+
+void PendSV_Handler(void)
+{
+    Sched_RunReady(); // The simulated PendSV is taken from thread code already
+}
+
+#elif defined(__GNUC__)
+
+__attribute__((naked, used))
+static void Sched_DispatchThread(void)
+{
+    __asm volatile (
+        " BL    Sched_RunReady      \n"
+        " MRS   r0, CONTROL         \n" // Clear FPCA: the tasks may have used the FPU,
+        " BIC   r0, r0, #4          \n" // the SVC frame must be a basic frame
+        " MSR   CONTROL, r0         \n"
+        " ISB                       \n"
+        " SVC   #0                  \n"
+        " B     .                   \n"
+    );
+}
+
+__attribute__((naked))
+void PendSV_Handler(void)
+{
+    __asm volatile (
+        " PUSH  {r0, lr}            \n" // EXC_RETURN of the preempted code, r0 keeps 8-byte alignment
+        " SUB   sp, sp, #32         \n" // Basic frame: r0-r3, r12, lr, pc, xPSR
+        " MOV   r0, #0x01000000     \n" // xPSR: Thumb state
+        " STR   r0, [sp, #28]       \n"
+        " MOVW  r0, #:lower16:Sched_DispatchThread \n"
+        " MOVT  r0, #:upper16:Sched_DispatchThread \n"
+        " BIC   r0, r0, #1          \n" // Return address without the Thumb bit
+        " STR   r0, [sp, #24]       \n"
+        " MVN   lr, #6              \n" // 0xFFFFFFF9: thread mode, main stack, basic frame
+        " BX    lr                  \n"
+    );
+}
+
+__attribute__((naked))
+void SVC_Handler(void)
+{
+    __asm volatile (
+        " ADD   sp, sp, #32         \n" // Drop the SVC frame of Sched_DispatchThread
+        " POP   {r0, pc}            \n" // Exception return to the code preempted by PendSV
+    );
+}
+
+#else
+#error "Sched: the PendSV/SVC glue needs a GCC compatible compiler (arm-none-eabi-gcc, tiarmclang)"
+#endif /* TM4C_HOST_SIM */
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Sched_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Clears the task table and the ready set, sets PendSV to
+ * the lowest exception priority and installs the PendSV and SVC handlers
+ * in the RAM vector table.
+ *********************************************************************/
+void Sched_Init(void)
+{
+    Sched_PriorityType index;
+
+    for (index = 0; index < SCHED_MAX_PRIORITY; index++)
+    {
+        g_SchedTasks[index].function = NULL_PTR;
+        g_SchedTasks[index].context = NULL_PTR;
+        g_SchedTasks[index].activations = 0;
+        g_SchedTasks[index].timer = SWTIMER_INVALID_ID;
+    }
+    g_SchedReady = 0;
+    g_SchedCurrent = SCHED_IDLE_PRIORITY;
+
+    NVIC_SetPriorityException(EXCEPTION_PEND_SV_TYPE, SCHED_PENDSV_PRIORITY);
+    (void)NVIC_RegisterExceptionHandler(EXCEPTION_PEND_SV_TYPE, PendSV_Handler);
+#ifndef TM4C_HOST_SIM
+    (void)NVIC_RegisterExceptionHandler(EXCEPTION_SVC_TYPE, SVC_Handler);
+#endif
+}
+
+
+/**********************************************************************
+ * Service Name: Sched_CreateTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Priority - Priority level of the task (1 to SCHED_MAX_PRIORITY)
+ *             Ptr2Func - Task function, runs to completion on each activation
+ *             a_Context - Argument given to the task function
+ * Return Value: FALSE if the priority is out of range or already used
+ * Description: Installs a task on a free priority level.
+ *********************************************************************/
+boolean Sched_CreateTask(Sched_PriorityType a_Priority, Sched_TaskFunctionType Ptr2Func, void *a_Context)
+{
+    Sched_TaskType *task;
+
+    if ((a_Priority == SCHED_IDLE_PRIORITY) || (a_Priority > SCHED_MAX_PRIORITY) || (Ptr2Func == NULL_PTR))
+    {
+        return FALSE;
+    }
+
+    task = &g_SchedTasks[a_Priority - 1];
+    if (task->function != NULL_PTR)
+    {
+        return FALSE;
+    }
+    task->context = a_Context;
+    task->activations = 0;
+    task->function = Ptr2Func;
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: Sched_Activate
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Priority - Priority level of the task to be run
+ * Return Value: FALSE if there is no task at this level or its activation
+ *               count is saturated
+ * Description: Makes the task ready (once more if it is already ready) and
+ * pends PendSV when it is above the running priority. Callable from
+ * interrupts at or below SCHED_CRITICAL_CEILING, from tasks and from the
+ * main loop.
+ *********************************************************************/
+boolean Sched_Activate(Sched_PriorityType a_Priority)
+{
+    NVIC_CriticalStateType state;
+    Sched_TaskType *task;
+    boolean activated = FALSE;
+
+    if ((a_Priority == SCHED_IDLE_PRIORITY) || (a_Priority > SCHED_MAX_PRIORITY))
+    {
+        return FALSE;
+    }
+
+    task = &g_SchedTasks[a_Priority - 1];
+    state = NVIC_EnterCritical(SCHED_CRITICAL_CEILING);
+    if ((task->function != NULL_PTR) && (task->activations < SCHED_MAX_ACTIVATIONS))
+    {
+        task->activations++;
+        g_SchedReady |= SCHED_READY_BIT(a_Priority);
+        if (a_Priority > g_SchedCurrent)
+        {
+            NVIC_SYSTEM_INTCTRL = NVIC_INTCTRL_PENDSVSET; // Taken once no interrupt is active
+        }
+        activated = TRUE;
+    }
+    NVIC_ExitCritical(state);
+
+    return activated;
+}
+
+
+/**********************************************************************
+ * Service Name: Sched_StartPeriodic
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Priority - Priority level of the task
+ *             a_Ticks - Activation period in software timer ticks
+ * Return Value: FALSE if there is no task at this level or no free timer
+ * Description: Activates the task from SysTick_Handler every a_Ticks ticks,
+ * with a periodic software timer.
+ *********************************************************************/
+boolean Sched_StartPeriodic(Sched_PriorityType a_Priority, uint32 a_Ticks)
+{
+    Sched_TaskType *task;
+
+    if ((a_Priority == SCHED_IDLE_PRIORITY) || (a_Priority > SCHED_MAX_PRIORITY))
+    {
+        return FALSE;
+    }
+
+    task = &g_SchedTasks[a_Priority - 1];
+    if (task->function == NULL_PTR)
+    {
+        return FALSE;
+    }
+    if (task->timer == SWTIMER_INVALID_ID)
+    {
+        task->timer = SwTimer_Create(Sched_TimerExpired, task);
+        if (task->timer == SWTIMER_INVALID_ID)
+        {
+            return FALSE;
+        }
+    }
+
+    return SwTimer_Start(task->timer, a_Ticks, SWTIMER_PERIODIC);
+}
+
+
+/**********************************************************************
+ * Service Name: Sched_StopPeriodic
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Priority - Priority level of the task
+ * Return Value: None
+ * Description: Stops the periodic activation and returns its timer.
+ *********************************************************************/
+void Sched_StopPeriodic(Sched_PriorityType a_Priority)
+{
+    Sched_TaskType *task;
+
+    if ((a_Priority == SCHED_IDLE_PRIORITY) || (a_Priority > SCHED_MAX_PRIORITY))
+    {
+        return;
+    }
+
+    task = &g_SchedTasks[a_Priority - 1];
+    if (task->timer != SWTIMER_INVALID_ID)
+    {
+        SwTimer_Delete(task->timer); // Also stops it
+        task->timer = SWTIMER_INVALID_ID;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: Sched_GetCurrentPriority
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Priority of the running task, SCHED_IDLE_PRIORITY outside
+ *               of the tasks
+ * Description: Returns the priority level being run.
+ *********************************************************************/
+Sched_PriorityType Sched_GetCurrentPriority(void)
+{
+    return g_SchedCurrent;
+}
@@ -0,0 +1,155 @@
+/******************************************************************************
+ *
+ * Module: Sched
+ *
+ * File Name: Sched.h
+ *
+ * Description: Header file for the preemptive run-to-completion scheduler.
+ *              Each task owns a priority level (1 is the lowest, the main
+ *              loop runs at 0). Tasks are made ready by interrupts or by the
+ *              SysTick software timers, and PendSV (the lowest exception
+ *              priority) runs the highest ready task, which preempts any
+ *              lower task still running. Tasks run to completion on the main
+ *              stack, so no task stacks and no dynamic allocation are needed.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+/* Number of task priority levels (1 to 32, one task per level) */
+#ifndef SCHED_MAX_PRIORITY
+#define SCHED_MAX_PRIORITY                   8
+#endif
+
+/* Priority ceiling of the critical sections protecting the ready set: the
+ * highest priority of the interrupts calling Sched_Activate (0 = PRIMASK) */
+#ifndef SCHED_CRITICAL_CEILING
+#define SCHED_CRITICAL_CEILING               0
+#endif
+
+/* Exception priority of PendSV, the lowest one so tasks never delay an IRQ */
+#define SCHED_PENDSV_PRIORITY                7
+
+/* Priority of the code that is not a task (main loop) */
+#define SCHED_IDLE_PRIORITY                  0
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 Sched_PriorityType;
+
+typedef void (*Sched_TaskFunctionType)(void *a_Context);
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Sched_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Clears the task table and the ready set, sets PendSV to
+ * the lowest exception priority and installs the PendSV and SVC handlers
+ * in the RAM vector table.
+ *********************************************************************/
+void Sched_Init(void);
+
+/**********************************************************************
+ * Service Name: Sched_CreateTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Priority - Priority level of the task (1 to SCHED_MAX_PRIORITY)
+ *             Ptr2Func - Task function, runs to completion on each activation
+ *             a_Context - Argument given to the task function
+ * Return Value: FALSE if the priority is out of range or already used
+ * Description: Installs a task on a free priority level.
+ *********************************************************************/
+boolean Sched_CreateTask(Sched_PriorityType a_Priority, Sched_TaskFunctionType Ptr2Func, void *a_Context);
+
+/**********************************************************************
+ * Service Name: Sched_Activate
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Priority - Priority level of the task to be run
+ * Return Value: FALSE if there is no task at this level or its activation
+ *               count is saturated
+ * Description: Makes the task ready (once more if it is already ready) and
+ * pends PendSV when it is above the running priority. Callable from
+ * interrupts at or below SCHED_CRITICAL_CEILING, from tasks and from the
+ * main loop.
+ *********************************************************************/
+boolean Sched_Activate(Sched_PriorityType a_Priority);
+
+/**********************************************************************
+ * Service Name: Sched_StartPeriodic
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Priority - Priority level of the task
+ *             a_Ticks - Activation period in software timer ticks
+ * Return Value: FALSE if there is no task at this level or no free timer
+ * Description: Activates the task from SysTick_Handler every a_Ticks ticks,
+ * with a periodic software timer.
+ *********************************************************************/
+boolean Sched_StartPeriodic(Sched_PriorityType a_Priority, uint32 a_Ticks);
+
+/**********************************************************************
+ * Service Name: Sched_StopPeriodic
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Priority - Priority level of the task
+ * Return Value: None
+ * Description: Stops the periodic activation and returns its timer.
+ *********************************************************************/
+void Sched_StopPeriodic(Sched_PriorityType a_Priority);
+
+/**********************************************************************
+ * Service Name: Sched_GetCurrentPriority
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Priority of the running task, SCHED_IDLE_PRIORITY outside
+ *               of the tasks
+ * Description: Returns the priority level being run.
+ *********************************************************************/
+Sched_PriorityType Sched_GetCurrentPriority(void);
+
+/**********************************************************************
+ * Service Name: PendSV_Handler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Dispatcher: runs the ready tasks above the preempted
+ * priority, highest first. On the target it returns to thread mode to run
+ * them and comes back through SVC_Handler.
+ *********************************************************************/
+void PendSV_Handler(void);
+
+#ifndef TM4C_HOST_SIM
+/**********************************************************************
+ * Service Name: SVC_Handler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Returns from the dispatch to the code preempted by PendSV.
+ * Owned by the scheduler, SVC is not available to the application.
+ *********************************************************************/
+void SVC_Handler(void);
+#endif
+
+#endif /* SCHED_H_ */
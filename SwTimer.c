@@ -0,0 +1,611 @@
+/******************************************************************************
+ *
+ * Module: SwTimer
+ *
+ * File Name: SwTimer.c
+ *
+ * Description: Source file for the software timers driven by the SysTick
+ *              interrupt (hierarchical timing wheel).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "SwTimer.h"
+#include "SysTick.h"
+#include "NVIC.h"
+
+/* Longest distance a timer can be placed at, farther timers are cascaded again */
+#define SWTIMER_MAX_DELTA                    ((1UL << (SWTIMER_WHEEL_LEVELS * SWTIMER_SLOT_BITS)) - 1)
+
+#define SWTIMER_NO_SLOT                      0xFFFF
+
+typedef struct SwTimer_Node
+{
+    struct SwTimer_Node *next;
+    struct SwTimer_Node **pprev;    /* Link pointing to this node, NULL_PTR when not in a list */
+    uint32 expiry;                  /* Absolute tick of the next expiry */
+    uint32 period;                  /* Re-arm interval, 0 for a one-shot timer */
+    SwTimer_CallBackType callback;
+    void *context;
+    uint16 slot;                    /* Wheel slot holding the node, SWTIMER_NO_SLOT otherwise */
+    boolean used;
+} SwTimer_NodeType;
+
+static SwTimer_NodeType g_SwTimerPool[SWTIMER_MAX_TIMERS];
+static SwTimer_NodeType *g_SwTimerFreeList = NULL_PTR;
+static boolean g_SwTimerPoolReady = FALSE;   /* Free list built, by SwTimer_Init or the first SwTimer_Create */
+
+/* One list head per slot, level after level */
+static SwTimer_NodeType *g_SwTimerWheel[SWTIMER_WHEEL_LEVELS * SWTIMER_SLOTS_PER_LEVEL];
+
+/* Non-empty slots of each level (bit n of word n / 32), used to find the next wake-up in O(1) */
+static uint32 g_SwTimerOccupied[SWTIMER_WHEEL_LEVELS][SWTIMER_SLOTS_PER_LEVEL / 32];
+
+/* Index of the lowest set bit from the isolated bit (de Bruijn sequence 0x077CB531) */
+static const uint8 g_SwTimerBitIndex[32] =
+{
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+static volatile uint32 g_SwTimerNow = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void SwTimer_Unlink(SwTimer_NodeType *a_Timer)
+{
+    uint16 slot = a_Timer->slot;
+
+    if (a_Timer->pprev != NULL_PTR)
+    {
+        *a_Timer->pprev = a_Timer->next;
+        if (a_Timer->next != NULL_PTR)
+        {
+            a_Timer->next->pprev = a_Timer->pprev;
+        }
+        a_Timer->pprev = NULL_PTR;
+    }
+
+    if ((slot != SWTIMER_NO_SLOT) && (g_SwTimerWheel[slot] == NULL_PTR))
+    {
+        g_SwTimerOccupied[slot / SWTIMER_SLOTS_PER_LEVEL][(slot % SWTIMER_SLOTS_PER_LEVEL) / 32] &= ~(1UL << (slot % 32));
+    }
+    a_Timer->slot = SWTIMER_NO_SLOT;
+}
+
+static void SwTimer_PushFront(SwTimer_NodeType **a_Head, SwTimer_NodeType *a_Timer)
+{
+    a_Timer->next = *a_Head;
+    if (a_Timer->next != NULL_PTR)
+    {
+        a_Timer->next->pprev = &a_Timer->next;
+    }
+    *a_Head = a_Timer;
+    a_Timer->pprev = a_Head;
+}
+
+/* Puts the timer in the slot of the lowest level that can hold its distance */
+static void SwTimer_Link(SwTimer_NodeType *a_Timer)
+{
+    uint32 delta = a_Timer->expiry - g_SwTimerNow;
+    uint32 when = a_Timer->expiry;
+    uint16 slot;
+    uint8 level;
+
+    for (level = 0; level < (SWTIMER_WHEEL_LEVELS - 1); level++)
+    {
+        if (delta < (1UL << ((level + 1) * SWTIMER_SLOT_BITS)))
+        {
+            break;
+        }
+    }
+    if (delta > SWTIMER_MAX_DELTA)
+    {
+        when = g_SwTimerNow + SWTIMER_MAX_DELTA;
+    }
+
+    slot = (uint16)((level * SWTIMER_SLOTS_PER_LEVEL) + ((when >> (level * SWTIMER_SLOT_BITS)) & SWTIMER_SLOT_MASK));
+    SwTimer_PushFront(&g_SwTimerWheel[slot], a_Timer);
+    a_Timer->slot = slot;
+    g_SwTimerOccupied[level][(slot % SWTIMER_SLOTS_PER_LEVEL) / 32] |= (1UL << (slot % 32));
+}
+
+/* Moves the timers of one upper level slot down to the levels matching their distance */
+static void SwTimer_Cascade(uint8 a_Level)
+{
+    SwTimer_NodeType **head = &g_SwTimerWheel[(a_Level * SWTIMER_SLOTS_PER_LEVEL) +
+                                              ((g_SwTimerNow >> (a_Level * SWTIMER_SLOT_BITS)) & SWTIMER_SLOT_MASK)];
+    SwTimer_NodeType *timer;
+
+    while (*head != NULL_PTR)
+    {
+        timer = *head;
+        SwTimer_Unlink(timer);
+        SwTimer_Link(timer);
+    }
+}
+
+/* Index of the lowest set bit of a non-zero 64-bit mask */
+static uint8 SwTimer_LowestBit(uint64 a_Mask)
+{
+    uint32 word = (uint32)a_Mask;
+    uint8 offset = 0;
+
+    if (word == 0)
+    {
+        word = (uint32)(a_Mask >> 32);
+        offset = 32;
+    }
+    return (uint8)(offset + g_SwTimerBitIndex[(uint32)((word & (0UL - word)) * 0x077CB531UL) >> 27]);
+}
+
+/*
+ * Nearest wake-up of one level. Slot s of level L is processed at the first
+ * tick T > now where the L*6 low bits of T are zero and the next 6 bits
+ * equal s, so the slots are visited in order starting right after the slot
+ * of the current time.
+ */
+static uint32 SwTimer_LevelNextWake(uint8 a_Level)
+{
+    uint8 shift = (uint8)(a_Level * SWTIMER_SLOT_BITS);
+    uint32 base = (g_SwTimerNow >> shift) + 1;
+    uint64 occupied = ((uint64)g_SwTimerOccupied[a_Level][1] << 32) | g_SwTimerOccupied[a_Level][0];
+    uint8 rotate = (uint8)(base & SWTIMER_SLOT_MASK);
+
+    if (occupied == 0)
+    {
+        return SWTIMER_NO_EXPIRY;
+    }
+
+    //Bit k of the rotated mask is the slot visited k steps after the next one
+    if (rotate != 0)
+    {
+        occupied = (occupied >> rotate) | (occupied << (SWTIMER_SLOTS_PER_LEVEL - rotate));
+    }
+
+    return ((base + SwTimer_LowestBit(occupied)) << shift) - g_SwTimerNow;
+}
+
+/*
+ * Nearest deadline of one level after a_AfterTicks, if nearer than a_Best.
+ * The slot visited at tick T holds the expiries of [T, T + 64^L), so the
+ * search starts at the slot holding a_AfterTicks and stops at the first
+ * slot starting past the best deadline: only the timers of a few slots are
+ * read, however many are running.
+ */
+static uint32 SwTimer_LevelNextDeadline(uint8 a_Level, uint32 a_AfterTicks, uint32 a_Best)
+{
+    uint8 shift = (uint8)(a_Level * SWTIMER_SLOT_BITS);
+    uint32 base = (g_SwTimerNow >> shift) + 1;
+    uint32 skip = ((g_SwTimerNow + a_AfterTicks) >> shift) - (g_SwTimerNow >> shift);
+    uint64 occupied = ((uint64)g_SwTimerOccupied[a_Level][1] << 32) | g_SwTimerOccupied[a_Level][0];
+    uint8 rotate = (uint8)(base & SWTIMER_SLOT_MASK);
+    SwTimer_NodeType *timer;
+    uint32 distance;
+    uint8 step;
+
+    skip = (skip == 0) ? 0 : (skip - 1); // The slot of a_AfterTicks may hold later expiries
+    if ((occupied == 0) || (skip >= SWTIMER_SLOTS_PER_LEVEL))
+    {
+        return a_Best;
+    }
+
+    //Bit k of the rotated mask is the slot visited k steps after the next one
+    if (rotate != 0)
+    {
+        occupied = (occupied >> rotate) | (occupied << (SWTIMER_SLOTS_PER_LEVEL - rotate));
+    }
+    occupied &= ~((1ULL << skip) - 1);
+
+    while (occupied != 0)
+    {
+        step = SwTimer_LowestBit(occupied);
+        if ((((base + step) << shift) - g_SwTimerNow) > a_Best)
+        {
+            break; // This slot and the ones after it only hold later expiries
+        }
+
+        timer = g_SwTimerWheel[(a_Level * SWTIMER_SLOTS_PER_LEVEL) + ((base + step) & SWTIMER_SLOT_MASK)];
+        for (; timer != NULL_PTR; timer = timer->next)
+        {
+            distance = timer->expiry - g_SwTimerNow;
+            if ((distance == a_AfterTicks) && (timer->period != 0))
+            {
+                distance += timer->period; // Due exactly at a_AfterTicks, comes back one period later
+            }
+            if ((distance > a_AfterTicks) && (distance < a_Best))
+            {
+                a_Best = distance;
+            }
+        }
+        occupied &= occupied - 1;
+    }
+
+    return a_Best;
+}
+
+/* Nearest tick at which the wheel has work to do: an expiry, or a cascade
+ * of a far timer which is never later than its expiry */
+static uint32 SwTimer_NextWork(void)
+{
+    uint32 next = SWTIMER_NO_EXPIRY;
+    uint32 wake;
+    uint8 level;
+
+    for (level = 0; level < SWTIMER_WHEEL_LEVELS; level++)
+    {
+        wake = SwTimer_LevelNextWake(level);
+        if (wake < next)
+        {
+            next = wake;
+        }
+    }
+
+    return next;
+}
+
+/* Chains every timer of the pool into the free list */
+static void SwTimer_FillPool(void)
+{
+    uint16 i;
+
+    g_SwTimerFreeList = NULL_PTR;
+    for (i = SWTIMER_MAX_TIMERS; i > 0; i--)
+    {
+        g_SwTimerPool[i - 1].pprev = NULL_PTR;
+        g_SwTimerPool[i - 1].slot = SWTIMER_NO_SLOT;
+        g_SwTimerPool[i - 1].used = FALSE;
+        g_SwTimerPool[i - 1].next = g_SwTimerFreeList;
+        g_SwTimerFreeList = &g_SwTimerPool[i - 1];
+    }
+    g_SwTimerPoolReady = TRUE;
+}
+
+static boolean SwTimer_IsValid(SwTimer_IdType a_Id)
+{
+    return (boolean)((a_Id < SWTIMER_MAX_TIMERS) && g_SwTimerPool[a_Id].used);
+}
+
+/*******************************************************************************
+ *                           Function Definitions                              *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: SwTimer_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Empties the timing wheel, returns every timer to the pool
+ * and resets the tick count. Optional at start-up: the first
+ * SwTimer_Create builds the pool itself.
+ *********************************************************************/
+void SwTimer_Init(void)
+{
+    uint16 i;
+    NVIC_CriticalStateType state;
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    for (i = 0; i < (SWTIMER_WHEEL_LEVELS * SWTIMER_SLOTS_PER_LEVEL); i++)
+    {
+        g_SwTimerWheel[i] = NULL_PTR;
+    }
+    for (i = 0; i < (SWTIMER_WHEEL_LEVELS * SWTIMER_SLOTS_PER_LEVEL / 32); i++)
+    {
+        g_SwTimerOccupied[i / (SWTIMER_SLOTS_PER_LEVEL / 32)][i % (SWTIMER_SLOTS_PER_LEVEL / 32)] = 0;
+    }
+
+    SwTimer_FillPool();
+    g_SwTimerNow = 0;
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_Create
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Function called on expiry (in SysTick interrupt context)
+ *             a_Context - Pointer passed back to the function
+ * Return Value: Timer ID, SWTIMER_INVALID_ID if the pool is exhausted
+ * Description: Takes a stopped timer from the static pool, which is
+ * built on the first call if SwTimer_Init was not called.
+ *********************************************************************/
+SwTimer_IdType SwTimer_Create(SwTimer_CallBackType Ptr2Func, void *a_Context)
+{
+    SwTimer_NodeType *timer;
+    SwTimer_IdType id = SWTIMER_INVALID_ID;
+    NVIC_CriticalStateType state;
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    if (!g_SwTimerPoolReady)
+    {
+        SwTimer_FillPool(); // First use without SwTimer_Init, the wheel starts empty
+    }
+    timer = g_SwTimerFreeList;
+    if (timer != NULL_PTR)
+    {
+        g_SwTimerFreeList = timer->next;
+        timer->next = NULL_PTR;
+        timer->pprev = NULL_PTR;
+        timer->slot = SWTIMER_NO_SLOT;
+        timer->period = 0;
+        timer->callback = Ptr2Func;
+        timer->context = a_Context;
+        timer->used = TRUE;
+        id = (SwTimer_IdType)(timer - g_SwTimerPool);
+    }
+    NVIC_ExitCritical(state);
+
+    return id;
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_Delete
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be released
+ * Return Value: None
+ * Description: Stops the timer and gives it back to the pool.
+ *********************************************************************/
+void SwTimer_Delete(SwTimer_IdType a_Id)
+{
+    SwTimer_NodeType *timer;
+    NVIC_CriticalStateType state;
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    if (SwTimer_IsValid(a_Id))
+    {
+        timer = &g_SwTimerPool[a_Id];
+        SwTimer_Unlink(timer);
+        timer->used = FALSE;
+        timer->next = g_SwTimerFreeList;
+        g_SwTimerFreeList = timer;
+    }
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be armed
+ *             a_Ticks - Interval in SysTick periods (at least 1)
+ *             a_Mode - One-shot or periodic
+ * Return Value: TRUE if the timer is armed, FALSE on invalid arguments
+ * Description: Arms (or re-arms) the timer to expire a_Ticks ticks from
+ * now. A periodic timer is re-armed from its previous deadline so it
+ * does not drift.
+ *********************************************************************/
+boolean SwTimer_Start(SwTimer_IdType a_Id, uint32 a_Ticks, SwTimer_ModeType a_Mode)
+{
+    SwTimer_NodeType *timer;
+    boolean armed = FALSE;
+    NVIC_CriticalStateType state;
+
+    if (a_Ticks == 0)
+    {
+        return FALSE;
+    }
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    if (SwTimer_IsValid(a_Id))
+    {
+        timer = &g_SwTimerPool[a_Id];
+        SwTimer_Unlink(timer);
+        //In tickless mode the wheel time lags behind the current sleep
+        timer->expiry = g_SwTimerNow + SysTick_GetUnannouncedTicks() + a_Ticks;
+        timer->period = (a_Mode == SWTIMER_PERIODIC) ? a_Ticks : 0;
+        SwTimer_Link(timer);
+        armed = TRUE;
+    }
+    NVIC_ExitCritical(state);
+
+    SysTick_Reschedule(); // The new deadline may come before the programmed tickless wake-up
+
+    return armed;
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be cancelled
+ * Return Value: None
+ * Description: Cancels the timer if it is running.
+ *********************************************************************/
+void SwTimer_Stop(SwTimer_IdType a_Id)
+{
+    NVIC_CriticalStateType state;
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    if (SwTimer_IsValid(a_Id))
+    {
+        SwTimer_Unlink(&g_SwTimerPool[a_Id]);
+    }
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_IsRunning
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be checked
+ * Return Value: TRUE if the timer is armed
+ * Description: Tells whether the timer is waiting for its expiry.
+ *********************************************************************/
+boolean SwTimer_IsRunning(SwTimer_IdType a_Id)
+{
+    return (boolean)(SwTimer_IsValid(a_Id) && (g_SwTimerPool[a_Id].pprev != NULL_PTR));
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_GetRemaining
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be checked
+ * Return Value: Ticks left before the expiry, 0 if the timer is not running
+ * Description: Counts from the current tick, the part of a tickless sleep
+ * already elapsed included. A running timer whose expiry is being
+ * processed reports 1 tick.
+ *********************************************************************/
+uint32 SwTimer_GetRemaining(SwTimer_IdType a_Id)
+{
+    uint32 remaining = 0;
+    uint32 distance;
+    uint32 elapsed;
+    NVIC_CriticalStateType state;
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    if (SwTimer_IsRunning(a_Id))
+    {
+        distance = g_SwTimerPool[a_Id].expiry - g_SwTimerNow;
+        elapsed = SysTick_GetUnannouncedTicks(); // In tickless mode the wheel time lags behind the current sleep
+        remaining = (distance > elapsed) ? (distance - elapsed) : 1;
+    }
+    NVIC_ExitCritical(state);
+
+    return remaining;
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_GetTickCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of ticks processed since SwTimer_Init
+ * Description: Returns the timer wheel time (wraps around after 2^32 ticks).
+ *********************************************************************/
+uint32 SwTimer_GetTickCount(void)
+{
+    return g_SwTimerNow;
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_GetNextExpiry
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_AfterTicks - Only the wake-ups after this many ticks from
+ *             now are considered
+ * Return Value: Distance in ticks from now, SWTIMER_NO_EXPIRY if none
+ * Description: Returns the nearest timer deadline after a_AfterTicks
+ * (less than 2^24 ticks). A periodic timer expiring exactly at
+ * a_AfterTicks is accounted with its next period. The cascades of far
+ * timers are not wake-ups: SwTimer_Advance runs them when it catches up.
+ * Used by the tickless SysTick mode to program the next wake-ups; must be
+ * called with the SysTick interrupt masked or from its handler.
+ *********************************************************************/
+uint32 SwTimer_GetNextExpiry(uint32 a_AfterTicks)
+{
+    uint32 next = SWTIMER_NO_EXPIRY;
+    uint8 level;
+
+    for (level = 0; level < SWTIMER_WHEEL_LEVELS; level++)
+    {
+        next = SwTimer_LevelNextDeadline(level, a_AfterTicks, next);
+    }
+
+    return next;
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_Advance
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Ticks - Number of elapsed ticks
+ * Return Value: None
+ * Description: Advances the wheel by several ticks at once, running the
+ * expired timers in deadline order. Ticks without work are skipped in
+ * O(1). Called from SysTick_Handler in tickless mode.
+ *********************************************************************/
+void SwTimer_Advance(uint32 a_Ticks)
+{
+    uint32 next;
+
+    while (a_Ticks != 0)
+    {
+        next = SwTimer_NextWork();
+        if (next > a_Ticks)
+        {
+            g_SwTimerNow += a_Ticks; // Nothing is due in between, jump over the idle ticks
+            break;
+        }
+        g_SwTimerNow += next - 1;
+        SwTimer_Tick();
+        a_Ticks -= next;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: SwTimer_Tick
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Advances the wheel by one tick and runs the callbacks of
+ * the expired timers. Called from SysTick_Handler.
+ *********************************************************************/
+void SwTimer_Tick(void)
+{
+    SwTimer_NodeType **slot;
+    SwTimer_NodeType *expired = NULL_PTR;
+    SwTimer_NodeType *timer;
+    uint8 level;
+
+    g_SwTimerNow++;
+
+    /*
+     * When the lower bits of the time wrap, the matching slot of the upper
+     * level is due: its timers are redistributed before the expiry check so
+     * the ones due at this very tick land in the current level 0 slot.
+     */
+    for (level = 1; level < SWTIMER_WHEEL_LEVELS; level++)
+    {
+        if ((g_SwTimerNow & ((1UL << (level * SWTIMER_SLOT_BITS)) - 1)) != 0)
+        {
+            break;
+        }
+        SwTimer_Cascade(level);
+    }
+
+    //Detach the due slot so callbacks can start or stop any timer meanwhile
+    slot = &g_SwTimerWheel[g_SwTimerNow & SWTIMER_SLOT_MASK];
+    if (*slot != NULL_PTR)
+    {
+        expired = *slot;
+        expired->pprev = &expired;
+        *slot = NULL_PTR;
+        g_SwTimerOccupied[0][(g_SwTimerNow & SWTIMER_SLOT_MASK) / 32] &= ~(1UL << (g_SwTimerNow % 32));
+        for (timer = expired; timer != NULL_PTR; timer = timer->next)
+        {
+            timer->slot = SWTIMER_NO_SLOT;
+        }
+    }
+
+    while (expired != NULL_PTR)
+    {
+        timer = expired;
+        SwTimer_Unlink(timer);
+        if (timer->period != 0)
+        {
+            timer->expiry += timer->period;
+            SwTimer_Link(timer);
+        }
+        if (timer->callback != NULL_PTR)
+        {
+            timer->callback(timer->context);
+        }
+    }
+}
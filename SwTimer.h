@@ -0,0 +1,191 @@
+/******************************************************************************
+ *
+ * Module: SwTimer
+ *
+ * File Name: SwTimer.h
+ *
+ * Description: Header file for the software timers driven by the SysTick
+ *              interrupt. The timers are kept in a hierarchical timing wheel
+ *              so that start, stop and expiry are O(1) whatever the number
+ *              of running timers.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+/* Size of the static timer pool (at most 255 timers) */
+#ifndef SWTIMER_MAX_TIMERS
+#define SWTIMER_MAX_TIMERS                   64
+#endif
+
+/* Wheel geometry: 4 levels of 64 slots cover 2^24 ticks, longer intervals are
+ * parked in the last level and cascaded again until they fall in range */
+#define SWTIMER_WHEEL_LEVELS                 4
+#define SWTIMER_SLOT_BITS                    6
+#define SWTIMER_SLOTS_PER_LEVEL              (1 << SWTIMER_SLOT_BITS)
+#define SWTIMER_SLOT_MASK                    (SWTIMER_SLOTS_PER_LEVEL - 1)
+
+#define SWTIMER_INVALID_ID                   0xFF
+
+/* Returned by SwTimer_GetNextExpiry when no timer is running */
+#define SWTIMER_NO_EXPIRY                    0xFFFFFFFFUL
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 SwTimer_IdType;
+
+typedef void (*SwTimer_CallBackType)(void *a_Context);
+
+typedef enum
+{
+    SWTIMER_ONE_SHOT,
+    SWTIMER_PERIODIC
+} SwTimer_ModeType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: SwTimer_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Empties the timing wheel, returns every timer to the pool
+ * and resets the tick count. Optional at start-up: the first
+ * SwTimer_Create builds the pool itself.
+ *********************************************************************/
+void SwTimer_Init(void);
+
+/**********************************************************************
+ * Service Name: SwTimer_Create
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Function called on expiry (in SysTick interrupt context)
+ *             a_Context - Pointer passed back to the function
+ * Return Value: Timer ID, SWTIMER_INVALID_ID if the pool is exhausted
+ * Description: Takes a stopped timer from the static pool, which is
+ * built on the first call if SwTimer_Init was not called.
+ *********************************************************************/
+SwTimer_IdType SwTimer_Create(SwTimer_CallBackType Ptr2Func, void *a_Context);
+
+/**********************************************************************
+ * Service Name: SwTimer_Delete
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be released
+ * Return Value: None
+ * Description: Stops the timer and gives it back to the pool.
+ *********************************************************************/
+void SwTimer_Delete(SwTimer_IdType a_Id);
+
+/**********************************************************************
+ * Service Name: SwTimer_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be armed
+ *             a_Ticks - Interval in SysTick periods (at least 1)
+ *             a_Mode - One-shot or periodic
+ * Return Value: TRUE if the timer is armed, FALSE on invalid arguments
+ * Description: Arms (or re-arms) the timer to expire a_Ticks ticks from
+ * now. A periodic timer is re-armed from its previous deadline so it
+ * does not drift.
+ *********************************************************************/
+boolean SwTimer_Start(SwTimer_IdType a_Id, uint32 a_Ticks, SwTimer_ModeType a_Mode);
+
+/**********************************************************************
+ * Service Name: SwTimer_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be cancelled
+ * Return Value: None
+ * Description: Cancels the timer if it is running.
+ *********************************************************************/
+void SwTimer_Stop(SwTimer_IdType a_Id);
+
+/**********************************************************************
+ * Service Name: SwTimer_IsRunning
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be checked
+ * Return Value: TRUE if the timer is armed
+ * Description: Tells whether the timer is waiting for its expiry.
+ *********************************************************************/
+boolean SwTimer_IsRunning(SwTimer_IdType a_Id);
+
+/**********************************************************************
+ * Service Name: SwTimer_GetRemaining
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Id - Timer to be checked
+ * Return Value: Ticks left before the expiry, 0 if the timer is not running
+ * Description: Counts from the current tick, the part of a tickless sleep
+ * already elapsed included. A running timer whose expiry is being
+ * processed reports 1 tick.
+ *********************************************************************/
+uint32 SwTimer_GetRemaining(SwTimer_IdType a_Id);
+
+/**********************************************************************
+ * Service Name: SwTimer_GetTickCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of ticks processed since SwTimer_Init
+ * Description: Returns the timer wheel time (wraps around after 2^32 ticks).
+ *********************************************************************/
+uint32 SwTimer_GetTickCount(void);
+
+/**********************************************************************
+ * Service Name: SwTimer_GetNextExpiry
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_AfterTicks - Only the wake-ups after this many ticks from
+ *             now are considered
+ * Return Value: Distance in ticks from now, SWTIMER_NO_EXPIRY if none
+ * Description: Returns the nearest timer deadline after a_AfterTicks
+ * (less than 2^24 ticks). A periodic timer expiring exactly at
+ * a_AfterTicks is accounted with its next period. The cascades of far
+ * timers are not wake-ups: SwTimer_Advance runs them when it catches up.
+ * Used by the tickless SysTick mode to program the next wake-ups; must be
+ * called with the SysTick interrupt masked or from its handler.
+ *********************************************************************/
+uint32 SwTimer_GetNextExpiry(uint32 a_AfterTicks);
+
+/**********************************************************************
+ * Service Name: SwTimer_Advance
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Ticks - Number of elapsed ticks
+ * Return Value: None
+ * Description: Advances the wheel by several ticks at once, running the
+ * expired timers in deadline order. Ticks without work are skipped in
+ * O(1). Called from SysTick_Handler in tickless mode.
+ *********************************************************************/
+void SwTimer_Advance(uint32 a_Ticks);
+
+/**********************************************************************
+ * Service Name: SwTimer_Tick
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Advances the wheel by one tick and runs the callbacks of
+ * the expired timers. Called from SysTick_Handler.
+ *********************************************************************/
+void SwTimer_Tick(void);
+
+#endif /* SWTIMER_H_ */
@@ -1,141 +1,1236 @@
-/******************************************************************************
- *
- * Module: SysTick
- *
- * File Name: SysTick.c
- *
- * Description: Source file for the ARM Cortex M4 SysTick driver
- *
- * Author: Saraa Gomaa
- *
- *******************************************************************************/
-
-#include "SysTick.h"
-#include "tm4c123gh6pm_registers.h"
-
-/* Global variable to hold the call back function */
-static volatile void (*g_SysTickCallBackPtr)(void) = NULL_PTR;
-
-/*******************************************************************************
- *                       Function Definitions                                  *
- *******************************************************************************/
-
-/**********************************************************************
- * Service Name: SysTick_Init
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: ConfigPtr - Pointer to configuration structure
- * Return Value: None
- * Description: Initializes the SysTick timer with the specified value
- *********************************************************************/
-void SysTick_Init(uint16 a_TimeInMilliSeconds)
-{
-    uint32 ticks = (a_TimeInMilliSeconds * 16000) - 1; // Assuming 16MHz clock
-
-    SYSTICK_CTRL_REG  = 0; // Disable SysTick during setup
-    SYSTICK_RELOAD_REG = ticks; // Set reload register
-    SYSTICK_CURRENT_REG = 0; // Clear current register
-    SYSTICK_CTRL_REG = 0x07; // Enable SysTick with system clock and interrupts
-}
-
-
-/**********************************************************************
- * Service Name: SysTick_StartBusyWait
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: a_TimeInMilliseconds - Time interval in millisecond
- * Return Value: None
- * Description: Initializes the SysTick timer to use polling (busy wait)
- * for the specified time in millisecond. The function exits when the
- * time elapses and stops the timer.
- *********************************************************************/
-void SysTick_StartBusyWait(uint16 a_TimeInMilliSeconds)
-{
-    uint32 ticks = (a_TimeInMilliSeconds * 16000) - 1; // Assuming 16MHz clock
-
-    SYSTICK_CTRL_REG  = 0; // Disable SysTick during setup
-    SYSTICK_RELOAD_REG = ticks; // Set reload register
-    SYSTICK_CURRENT_REG = 0; // Clear current register
-    SYSTICK_CTRL_REG = 0x05; // Enable SysTick with system clock without interrupts
-
-    while((SYSTICK_CTRL_REG & 0x00010000) == 0); // Wait for count flag to be set
-
-    SYSTICK_CTRL_REG = 0; // Disable SysTick
-}
-
-
-/**********************************************************************
- * Service Name: SysTick_Handler
- * Sync/Async: Asynchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: Interrupt handler for SysTick timer, used to call the
- * callback function
- *********************************************************************/
-void SysTick_Handler(void)
-{
-    if (g_SysTickCallBackPtr != NULL_PTR)
-    {
-        (*g_SysTickCallBackPtr)();
-    }
-}
-
-
-/**********************************************************************
- * Service Name: SysTick_SetCallBack
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Ptr2Func - Pointer to the callback function
- * Return Value: None
- * Description: Sets up the SysTick timer callback to be executed in the
- * SysTick Handler
- *********************************************************************/
-void SysTick_SetCallBack(volatile void (*Ptr2Func)(void))
-{
-    g_SysTickCallBackPtr = Ptr2Func;
-}
-
-
-/**********************************************************************
- * Service Name: SysTick_Stop
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: Stops the SysTick timer
- *********************************************************************/
-void SysTick_Stop(void)
-{
-    SYSTICK_CTRL_REG &= ~0x01; // Clear enable bit to stop SysTick
-}
-
-
-/**********************************************************************
- * Service Name: SysTick_Start
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: Starts or resume the SysTick timer
- *********************************************************************/
-void SysTick_Start(void)
-{
-    SYSTICK_CTRL_REG |= 0x01; // Set enable bit to start SysTick
-}
-
-
-/**********************************************************************
- * Service Name: SysTick_DeInit
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: De-initializes the SysTick timer
- *********************************************************************/
-void SysTick_DeInit(void)
-{
-    SYSTICK_CTRL_REG = 0; // Disable SysTick
-    SYSTICK_RELOAD_REG = 0; // Clear reload register
-    SYSTICK_CURRENT_REG = 0; // Clear current register
-}
+/******************************************************************************
+ *
+ * Module: SysTick
+ *
+ * File Name: SysTick.c
+ *
+ * Description: Source file for the ARM Cortex M4 SysTick driver
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "SysTick.h"
+#include "SwTimer.h"
+#include "NVIC.h"
+#include "Mcu_Registers.h"
+#include "IsrStats.h"
+#include "Trace.h"
+
+#define SYSTICK_CTRL_ENABLE                  0x00000001
+#define SYSTICK_CTRL_INTEN                   0x00000002
+#define SYSTICK_CTRL_COUNT_FLAG              0x00010000
+#define NVIC_INTCTRL_PENDSTSET               0x04000000
+
+/* The 24-bit counter runs at most 2^24 cycles per period */
+#define SYSTICK_MAX_LOAD                     0x01000000UL
+
+/* Shortest period programmed in tickless mode, keeps the next interrupt
+ * out of the current handler */
+#ifndef SYSTICK_MIN_LOAD_CYCLES
+#define SYSTICK_MIN_LOAD_CYCLES              256
+#endif
+
+/* Cycles between the CURRENT read and the counter restart in
+ * SysTick_Restart (measure with the DWT cycle counter for a new toolchain) */
+#ifndef SYSTICK_RESTART_CYCLES
+#define SYSTICK_RESTART_CYCLES               8
+#endif
+
+/* Core clocks accepted: a whole number of MHz */
+#define SYSTICK_CLOCK_VALID(Hz)              (((Hz) >= 1000000UL) && (((Hz) % 1000000UL) == 0))
+
+/* One cycle in the 32.32 fixed point of the trim */
+#define SYSTICK_TRIM_ONE                     4294967296LL
+#define SYSTICK_PPB_ONE                      1000000000LL
+
+/* Driver modes in a saved context */
+#define SYSTICK_CONTEXT_OFF                  0
+#define SYSTICK_CONTEXT_PERIODIC             1
+#define SYSTICK_CONTEXT_TICKLESS             2
+#define SYSTICK_CONTEXT_FRACTIONAL           3
+
+/* Global variable to hold the call back function */
+static void (*volatile g_SysTickCallBackPtr)(void) = NULL_PTR;
+
+/* Function posted to the SysTick work queue on each interrupt */
+static volatile WorkQueue_FunctionType g_SysTickDeferredPtr = NULL_PTR;
+static void * volatile g_SysTickDeferredArgument = NULL_PTR;
+
+static uint32 g_SysTickCoreClockHz = SYSTICK_CORE_CLOCK_HZ;
+static uint32 g_SysTickCyclesPerMicro = SYSTICK_CORE_CLOCK_HZ / 1000000UL;
+
+/*
+ * Time base bookkeeping. The hardware runs the period loaded at the last
+ * wrap while RELOAD already holds the length of the following one, so the
+ * handler folds the ended period and shifts the pipeline by one.
+ */
+static volatile uint32 g_SysTickCyclesPerTick = 0;
+static volatile uint64 g_SysTickCycleCount = 0;      /* Cycles up to the start of the running period */
+static volatile uint64 g_SysTickAnnouncedCycles = 0; /* Cycles already turned into timer ticks */
+static volatile uint64 g_SysTickMicroCount = 0;      /* Whole microseconds in g_SysTickCycleCount */
+static volatile uint32 g_SysTickMicroRemainder = 0;  /* Cycles of g_SysTickCycleCount left out of the microseconds */
+static volatile uint32 g_SysTickActiveLoad = 0;      /* Length of the running period in cycles */
+static volatile uint32 g_SysTickNextLoad = 0;        /* Length programmed in RELOAD for the next period */
+static volatile boolean g_SysTickTickless = FALSE;
+static volatile boolean g_SysTickInHandler = FALSE;
+
+/* Periodic mode beyond the 24-bit counter: the period is run as a chain of segments */
+static volatile uint64 g_SysTickPeriodCycles = 0;
+static volatile uint64 g_SysTickPeriodLeft = 0;      /* Cycles of the period not folded yet */
+
+/*
+ * Fractional periodic mode: the period is Base + Remainder / Denominator
+ * cycles, plus the trim step in 2^-32 cycles. What a reload leaves out of
+ * both fractions is kept in the two errors and added to the next reloads.
+ */
+static volatile boolean g_SysTickFractional = FALSE;
+static uint32 g_SysTickFracBase = 0;
+static uint32 g_SysTickFracRemainder = 0;
+static uint32 g_SysTickFracDenominator = 1;
+static uint32 g_SysTickFracError = 0;              /* 0 to Denominator - 1 */
+static sint32 g_SysTickTrimPpb = 0;
+static sint64 g_SysTickTrimStep = 0;               /* Trim of one period in 2^-32 cycles */
+static sint64 g_SysTickTrimError = 0;              /* 0 to 2^32 - 1 */
+
+/*
+ * Copy of the time base for the lock-free readers. The writers fill the
+ * copy the readers are not using then bump the sequence, whose low bit
+ * selects the copy; a reader retries when the sequence moved under it.
+ */
+typedef struct
+{
+    uint64 cycleCount;
+    uint64 microCount;
+    uint32 microRemainder;
+    uint32 activeLoad;
+    uint32 nextLoad;
+} SysTick_TimeStampType;
+
+static volatile SysTick_TimeStampType g_SysTickTimeStamp[2];
+static volatile uint32 g_SysTickTimeStampSeq = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Writer side of the time stamp, called after every change of the time base */
+static void SysTick_PublishTimeBase(void)
+{
+    uint32 seq = g_SysTickTimeStampSeq + 1;
+    volatile SysTick_TimeStampType *copy = &g_SysTickTimeStamp[seq & 1];
+
+    copy->cycleCount = g_SysTickCycleCount;
+    copy->microCount = g_SysTickMicroCount;
+    copy->microRemainder = g_SysTickMicroRemainder;
+    copy->activeLoad = g_SysTickActiveLoad;
+    copy->nextLoad = g_SysTickNextLoad;
+    g_SysTickTimeStampSeq = seq; // Switch the readers to the new copy
+}
+
+static void SysTick_AddCycles(uint32 a_Cycles)
+{
+    uint32 remainder = g_SysTickMicroRemainder + a_Cycles;
+
+    g_SysTickCycleCount += a_Cycles;
+    g_SysTickMicroCount += remainder / g_SysTickCyclesPerMicro;
+    g_SysTickMicroRemainder = remainder % g_SysTickCyclesPerMicro;
+}
+
+/*
+ * Reader side of the time stamp: takes a consistent copy of the time base
+ * and the cycles elapsed since its running period started. A wrap not
+ * folded yet by the handler is detected with the pending bit.
+ */
+static uint32 SysTick_ReadTimeStamp(SysTick_TimeStampType *a_TimeStamp)
+{
+    const volatile SysTick_TimeStampType *copy;
+    uint32 seq;
+    uint32 current;
+    uint32 elapsed;
+
+    do
+    {
+        seq = g_SysTickTimeStampSeq;
+        copy = &g_SysTickTimeStamp[seq & 1];
+        a_TimeStamp->cycleCount = copy->cycleCount;
+        a_TimeStamp->microCount = copy->microCount;
+        a_TimeStamp->microRemainder = copy->microRemainder;
+        a_TimeStamp->activeLoad = copy->activeLoad;
+        a_TimeStamp->nextLoad = copy->nextLoad;
+
+        current = SYSTICK_CURRENT_REG;
+        if (a_TimeStamp->activeLoad == 0)
+        {
+            elapsed = 0; // The time base is not running
+        }
+        else if ((NVIC_SYSTEM_INTCTRL & NVIC_INTCTRL_PENDSTSET) != 0)
+        {
+            //Read again: the wrap may have happened after the first read
+            current = SYSTICK_CURRENT_REG;
+            elapsed = a_TimeStamp->activeLoad + ((a_TimeStamp->nextLoad - 1) - current);
+        }
+        else
+        {
+            elapsed = (a_TimeStamp->activeLoad - 1) - current;
+        }
+    } while (seq != g_SysTickTimeStampSeq);
+
+    return elapsed;
+}
+
+static void SysTick_ResetTimeBase(uint32 a_CyclesPerTick, uint32 a_Load, boolean a_Tickless)
+{
+    g_SysTickCyclesPerTick = a_CyclesPerTick;
+    g_SysTickCycleCount = 0;
+    g_SysTickAnnouncedCycles = 0;
+    g_SysTickMicroCount = 0;
+    g_SysTickMicroRemainder = 0;
+    g_SysTickActiveLoad = a_Load;
+    g_SysTickNextLoad = a_Load;
+    g_SysTickTickless = a_Tickless;
+    g_SysTickFractional = FALSE;
+    SysTick_PublishTimeBase();
+}
+
+/* Trim of one fractional period in 2^-32 cycles: period * ppb / 10^9. The
+ * whole cycles and the fraction of the period are scaled apart to stay
+ * within 64 bits. */
+static sint64 SysTick_TrimStep(sint32 a_PartsPerBillion)
+{
+    sint64 whole = (sint64)g_SysTickFracBase * a_PartsPerBillion;
+    sint64 fraction = (sint64)((((uint64)g_SysTickFracRemainder) << 32) / g_SysTickFracDenominator) * a_PartsPerBillion;
+
+    return ((whole / SYSTICK_PPB_ONE) * SYSTICK_TRIM_ONE) +
+           (((whole % SYSTICK_PPB_ONE) * SYSTICK_TRIM_ONE) / SYSTICK_PPB_ONE) + (fraction / SYSTICK_PPB_ONE);
+}
+
+/* Length of the next fractional period: the base plus the whole cycles
+ * gathered by the remainder and by the trim (error diffusion) */
+static uint32 SysTick_FractionalLoad(void)
+{
+    uint32 load = g_SysTickFracBase;
+    uint32 carry = g_SysTickFracDenominator - g_SysTickFracRemainder;
+    sint64 whole;
+
+    if (g_SysTickFracError >= carry)
+    {
+        g_SysTickFracError -= carry; // The fractions make one more cycle
+        load++;
+    }
+    else
+    {
+        g_SysTickFracError += g_SysTickFracRemainder;
+    }
+
+    g_SysTickTrimError += g_SysTickTrimStep;
+    whole = g_SysTickTrimError / SYSTICK_TRIM_ONE;
+    if ((whole * SYSTICK_TRIM_ONE) > g_SysTickTrimError)
+    {
+        whole--; // Rounded down, the error stays positive for a negative trim
+    }
+    g_SysTickTrimError -= whole * SYSTICK_TRIM_ONE;
+
+    return (uint32)((sint64)load + whole);
+}
+
+/* Checksum of a saved context, same rotate-and-add as NVIC_ContextType */
+static uint32 SysTick_ContextChecksum(const SysTick_ContextType *a_Context)
+{
+    const uint32 *word = (const uint32 *)a_Context;
+    uint32 sum = 0;
+    uint8 index;
+
+    for (index = 0; index < ((sizeof(SysTick_ContextType) / sizeof(uint32)) - 1); index++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + word[index];
+    }
+
+    return ~sum;
+}
+
+/* Next segment of a_Cycles: the remaining cycles are split evenly so no
+ * segment is shorter than half the counter range */
+static uint32 SysTick_SegmentLoad(uint64 a_Cycles)
+{
+    uint32 segments = (uint32)((a_Cycles + (SYSTICK_MAX_LOAD - 1)) >> 24);
+
+    if (segments <= 1)
+    {
+        return (uint32)a_Cycles;
+    }
+    return (uint32)(a_Cycles / segments);
+}
+
+/* First segment of a period started with the counter: the hardware runs it
+ * twice, as RELOAD is only reprogrammed from the first interrupt on, so the
+ * cycles left after the two of them must not make a segment too short
+ * (an odd period of two segments gets three) */
+static uint32 SysTick_FirstSegmentLoad(uint64 a_Cycles)
+{
+    uint32 load = SysTick_SegmentLoad(a_Cycles);
+    uint64 rest;
+
+    if (a_Cycles > SYSTICK_MAX_LOAD)
+    {
+        rest = a_Cycles - (2 * (uint64)load);
+        if ((rest != 0) && (rest < SYSTICK_MIN_LOAD_CYCLES))
+        {
+            load = (uint32)(a_Cycles / 3);
+        }
+    }
+    return load;
+}
+
+/*
+ * Periodic mode beyond the 24-bit counter, called on each segment end.
+ * Returns TRUE when the whole period is over.
+ */
+static boolean SysTick_NextSegment(uint32 a_EndedLoad)
+{
+    boolean periodEnd = FALSE;
+    uint64 after;
+
+    g_SysTickPeriodLeft -= a_EndedLoad;
+    if (g_SysTickPeriodLeft == 0)
+    {
+        g_SysTickPeriodLeft = g_SysTickPeriodCycles;
+        periodEnd = TRUE;
+    }
+
+    //The running segment is already loaded, program the one after it
+    after = g_SysTickPeriodLeft - g_SysTickActiveLoad;
+    if (after == 0)
+    {
+        after = g_SysTickPeriodCycles;
+    }
+    g_SysTickNextLoad = SysTick_SegmentLoad(after);
+    SYSTICK_RELOAD_REG = g_SysTickNextLoad - 1;
+    SysTick_PublishTimeBase();
+
+    return periodEnd;
+}
+
+static uint32 SysTick_ClampLoad(uint64 a_Cycles)
+{
+    if (a_Cycles < SYSTICK_MIN_LOAD_CYCLES)
+    {
+        return SYSTICK_MIN_LOAD_CYCLES;
+    }
+    if (a_Cycles > SYSTICK_MAX_LOAD)
+    {
+        return SYSTICK_MAX_LOAD;
+    }
+    return (uint32)a_Cycles;
+}
+
+/* Tickless period reaching a deadline a_Cycles ahead: split evenly like
+ * the long periodic periods when it does not fit the counter, so that the
+ * last segment ends exactly on the deadline */
+static uint32 SysTick_WakeLoad(uint64 a_Cycles)
+{
+    return SysTick_ClampLoad(SysTick_SegmentLoad(a_Cycles));
+}
+
+/* First tickless period: the hardware runs it twice, as RELOAD is only
+ * reprogrammed from the first interrupt on, so it is the whole way to the
+ * first deadline only if the second deadline is not nearer than twice that
+ * far. Otherwise both runs end by the first deadline. */
+static uint32 SysTick_FirstWakeLoad(uint32 a_CyclesPerTick)
+{
+    uint32 wake = SwTimer_GetNextExpiry(0);
+    uint32 after;
+    uint64 cycles;
+    uint32 load;
+
+    if (wake == SWTIMER_NO_EXPIRY)
+    {
+        return SYSTICK_MAX_LOAD;
+    }
+
+    cycles = (uint64)wake * a_CyclesPerTick;
+    after = SwTimer_GetNextExpiry(wake);
+    if (cycles > SYSTICK_MAX_LOAD)
+    {
+        return SysTick_FirstSegmentLoad(cycles);
+    }
+    if ((after == SWTIMER_NO_EXPIRY) || (((uint64)after * a_CyclesPerTick) >= (2 * cycles)))
+    {
+        return SysTick_ClampLoad(cycles);
+    }
+
+    load = (uint32)(cycles / 2);
+    if ((cycles & 1) != 0)
+    {
+        load = (uint32)(cycles / 3); // The cycle left after the two runs would be too short a period
+    }
+    return SysTick_ClampLoad(load);
+}
+
+/*
+ * Cuts the running period short so the counter reaches zero at a_WakeTicks
+ * (ticks from the wheel time). The cycles already counted are folded into
+ * the time base, only the restart latency is an estimate, so restarts are
+ * kept for timers armed nearer than the programmed wake-up: the handler
+ * programs the periods that follow a deadline without restarting.
+ */
+static void SysTick_Restart(uint32 a_WakeTicks)
+{
+    uint32 unannounced = (uint32)(g_SysTickCycleCount - g_SysTickAnnouncedCycles);
+    uint64 target = ((uint64)a_WakeTicks * g_SysTickCyclesPerTick);
+    uint64 done;
+    uint32 elapsed;
+    uint32 load;
+    NVIC_CriticalStateType state;
+
+    //Nothing may preempt between the CURRENT read and the restart, the latency is a constant
+    state = NVIC_EnterCritical(0);
+    elapsed = (g_SysTickActiveLoad - 1) - SYSTICK_CURRENT_REG;
+    done = (uint64)unannounced + elapsed + SYSTICK_RESTART_CYCLES;
+    load = SysTick_ClampLoad((target > done) ? (target - done) : 0);
+
+    //A wrap after the CURRENT read is not folded yet, the handler will program the wake-up
+    if ((NVIC_SYSTEM_INTCTRL & NVIC_INTCTRL_PENDSTSET) != 0)
+    {
+        NVIC_ExitCritical(state);
+        return;
+    }
+
+    SYSTICK_RELOAD_REG = load - 1;
+    SYSTICK_CURRENT_REG = 0; // Restart the count from the new reload value
+    NVIC_ExitCritical(state);
+
+    SysTick_AddCycles(elapsed + SYSTICK_RESTART_CYCLES);
+    g_SysTickActiveLoad = load;
+    g_SysTickNextLoad = load;
+    SysTick_PublishTimeBase();
+}
+
+/* Handler side of the tickless mode: keeps the wake-ups on the timer deadlines */
+static void SysTick_ProgramNextWake(void)
+{
+    uint32 cyclesPerTick = g_SysTickCyclesPerTick;
+    uint64 runEnd = (g_SysTickCycleCount - g_SysTickAnnouncedCycles) + g_SysTickActiveLoad;
+    uint32 wake = SwTimer_GetNextExpiry(0);
+    uint32 load;
+
+    if ((wake != SWTIMER_NO_EXPIRY) && (((uint64)wake * cyclesPerTick) < runEnd))
+    {
+        SysTick_Restart(wake); // A callback armed a timer before the end of the running period
+        return;
+    }
+
+    //The running period ends on the deadline: the next one must reach the deadline after
+    //it, periodic timers due at the first one included, so no restart is needed then
+    if ((wake != SWTIMER_NO_EXPIRY) && (((uint64)wake * cyclesPerTick) == runEnd))
+    {
+        wake = SwTimer_GetNextExpiry(wake);
+    }
+
+    if (wake == SWTIMER_NO_EXPIRY)
+    {
+        load = SYSTICK_MAX_LOAD;
+    }
+    else
+    {
+        load = SysTick_WakeLoad(((uint64)wake * cyclesPerTick) - runEnd);
+    }
+
+    SYSTICK_RELOAD_REG = load - 1; // Taken by the hardware when the running period ends
+    g_SysTickNextLoad = load;
+    SysTick_PublishTimeBase();
+}
+
+/* Entered directly from a relocated vector table, which is not moved here */
+static void SysTick_RefreshHandler(void)
+{
+    if (NVIC_IsVectorTableRelocated())
+    {
+        (void)NVIC_RegisterExceptionHandler(EXCEPTION_SYSTICK_TYPE, SysTick_Handler);
+    }
+}
+
+/*
+ * Waits a_Cycles core cycles on the running counter, leaving its setup
+ * untouched. When the interrupt can be taken the time base of the handler
+ * covers any reload length (segments, tickless). Otherwise (interrupt
+ * disabled, masked by PRIMASK/BASEPRI or by the handler being run, or no
+ * period running) the time base stops, so the counter is polled: the reload
+ * value cannot change meanwhile, and a wrap adds the rest of the period to
+ * the elapsed count. A masked wrap stays pending and is folded by the
+ * handler once unmasked. A stopped SysTick is run free for the wait only,
+ * its control and reload registers are put back at the end.
+ */
+static void SysTick_Wait(uint64 a_Cycles, boolean a_Sleep)
+{
+    NVIC_CriticalStateType state;
+    uint64 start;
+    uint64 elapsed = 0;
+    uint32 previous;
+    uint32 current;
+    uint32 stoppedControl = SYSTICK_CTRL_REG;
+    uint32 stoppedReload = 0;
+
+    if ((stoppedControl & SYSTICK_CTRL_ENABLE) == 0)
+    {
+        //Stopped: start it free running (no interrupt) with the longest period
+        stoppedReload = SYSTICK_RELOAD_REG;
+        SYSTICK_RELOAD_REG = SYSTICK_MAX_LOAD - 1;
+        SYSTICK_CURRENT_REG = 0;
+        SYSTICK_CTRL_REG = 0x05;
+    }
+
+    if (((SYSTICK_CTRL_REG & SYSTICK_CTRL_INTEN) != 0) && (g_SysTickActiveLoad != 0) &&
+        !NVIC_IsExceptionMasked(EXCEPTION_SYSTICK_TYPE))
+    {
+        start = SysTick_GetTicks();
+        while ((elapsed = SysTick_GetTicks() - start) < a_Cycles)
+        {
+            if (a_Sleep)
+            {
+                //Sleep while the next interrupt comes before the end, the wrap
+                //happening before WFI leaves the interrupt pending so WFI returns
+                state = NVIC_EnterCritical(0);
+                if ((a_Cycles - elapsed) > SYSTICK_CURRENT_REG)
+                {
+                    Wait_For_Interrupt();
+                }
+                NVIC_ExitCritical(state);
+            }
+        }
+    }
+    else
+    {
+        previous = SYSTICK_CURRENT_REG;
+        while (elapsed < a_Cycles)
+        {
+            current = SYSTICK_CURRENT_REG;
+            elapsed += (current <= previous) ? (previous - current) : (previous + (SYSTICK_RELOAD_REG + 1) - current);
+            previous = current;
+        }
+    }
+
+    if ((stoppedControl & SYSTICK_CTRL_ENABLE) == 0)
+    {
+        //Stop it again as it was found, the counter and its COUNT flag cleared
+        SYSTICK_CTRL_REG = stoppedControl & ~SYSTICK_CTRL_COUNT_FLAG;
+        SYSTICK_RELOAD_REG = stoppedReload;
+        SYSTICK_CURRENT_REG = 0;
+    }
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: SysTick_SetCoreClock
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_ClockHz - Core clock frequency in Hz (whole MHz)
+ * Return Value: FALSE if the clock is not a whole number of MHz (the
+ * previous clock is kept then)
+ * Description: Sets the clock used to convert times into SysTick cycles.
+ * Call it after every clock change, before SysTick_Init.
+ *********************************************************************/
+boolean SysTick_SetCoreClock(uint32 a_ClockHz)
+{
+    if (!SYSTICK_CLOCK_VALID(a_ClockHz))
+    {
+        return FALSE; // The handler divides by the cycles per microsecond
+    }
+
+    g_SysTickCoreClockHz = a_ClockHz;
+    g_SysTickCyclesPerMicro = a_ClockHz / 1000000UL;
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_InstallHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Installs SysTick_Handler in the RAM vector table, which is
+ * relocated first if needed. Only for startup files that do not name
+ * SysTick_Handler: the init functions install it themselves only once the
+ * table has been relocated, and never relocate it.
+ *********************************************************************/
+void SysTick_InstallHandler(void)
+{
+    (void)NVIC_RegisterExceptionHandler(EXCEPTION_SYSTICK_TYPE, SysTick_Handler);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_TimeInMilliSeconds - Interrupt period in millisecond
+ * Return Value: None
+ * Description: Initializes the SysTick timer with the specified period.
+ * Periods longer than the 24-bit counter are split into chained reload
+ * segments, the software timers and the callback only see the end of
+ * the whole period.
+ *********************************************************************/
+void SysTick_Init(uint32 a_TimeInMilliSeconds)
+{
+    SysTick_InitCycles(((uint64)a_TimeInMilliSeconds * g_SysTickCoreClockHz) / 1000);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_InitCycles
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Interrupt period in core clock cycles
+ * Return Value: None
+ * Description: Same as SysTick_Init with the period in cycles, to be used
+ * with SYSTICK_MS_TO_CYCLES so the conversion is done at compile time.
+ * Both update the SysTick_Handler entry of a relocated vector table (see
+ * SysTick_InstallHandler). A period shorter
+ * than SYSTICK_MIN_LOAD_CYCLES is rejected, SysTick is left as it was.
+ *********************************************************************/
+void SysTick_InitCycles(uint64 a_Cycles)
+{
+    uint32 load = SysTick_FirstSegmentLoad(a_Cycles);
+
+    if (load < SYSTICK_MIN_LOAD_CYCLES)
+    {
+        return; // Shorter than the handler itself
+    }
+
+    SYSTICK_CTRL_REG  = 0; // Disable SysTick during setup
+    g_SysTickPeriodCycles = a_Cycles;
+    g_SysTickPeriodLeft = a_Cycles;
+    SysTick_ResetTimeBase(0, load, FALSE); // No tick length in periodic mode
+    SysTick_RefreshHandler();
+    SYSTICK_RELOAD_REG = load - 1; // Set reload register
+    SYSTICK_CURRENT_REG = 0; // Clear current register
+    SYSTICK_CTRL_REG = 0x07; // Enable SysTick with system clock and interrupts
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_InitFractional
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_PeriodNumerator - Interrupt period in seconds, numerator
+ *             a_PeriodDenominator - Interrupt period in seconds, denominator
+ * Return Value: FALSE if the period is not between SYSTICK_MIN_LOAD_CYCLES
+ * and the 24-bit counter range (trim margin included)
+ * Description: Periodic mode for a period that is not a whole number of
+ * cycles, e.g. 1/60 s or 1/3 ms. Each reload is the whole part of the
+ * period, plus one cycle whenever the fractions left over add up to a
+ * cycle, so the mean period is exact and the error never exceeds one
+ * cycle. The trim of SysTick_SetTrim is carried in the same way.
+ *********************************************************************/
+boolean SysTick_InitFractional(uint32 a_PeriodNumerator, uint32 a_PeriodDenominator)
+{
+    uint64 cycles = (uint64)g_SysTickCoreClockHz * a_PeriodNumerator;
+    uint64 base;
+    uint32 load;
+
+    if (a_PeriodDenominator == 0)
+    {
+        return FALSE;
+    }
+
+    //The trimmed reloads must fit the counter too
+    base = cycles / a_PeriodDenominator;
+    if ((base < SYSTICK_MIN_LOAD_CYCLES) ||
+        ((base + ((base * SYSTICK_MAX_TRIM_PPB) / SYSTICK_PPB_ONE) + 2) > SYSTICK_MAX_LOAD))
+    {
+        return FALSE;
+    }
+
+    SYSTICK_CTRL_REG  = 0; // Disable SysTick during setup
+    g_SysTickFracBase = (uint32)base;
+    g_SysTickFracRemainder = (uint32)(cycles % a_PeriodDenominator);
+    g_SysTickFracDenominator = a_PeriodDenominator;
+    g_SysTickFracError = 0;
+    g_SysTickTrimStep = SysTick_TrimStep(g_SysTickTrimPpb);
+    g_SysTickTrimError = 0;
+
+    load = SysTick_FractionalLoad();
+    g_SysTickPeriodCycles = load; // Never split into segments
+    g_SysTickPeriodLeft = load;
+    SysTick_ResetTimeBase(0, load, FALSE); // No tick length in periodic mode
+    g_SysTickFractional = TRUE;
+    SysTick_RefreshHandler();
+    SYSTICK_RELOAD_REG = load - 1; // First period, the handler programs the following ones
+    SYSTICK_CURRENT_REG = 0; // Clear current register
+    SYSTICK_CTRL_REG = 0x07; // Enable SysTick with system clock and interrupts
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_SetTrim
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_PartsPerBillion - Core clock error against a reference,
+ *             positive when the core clock runs fast (1000 = 1 ppm)
+ * Return Value: None
+ * Description: Lengthens (or shortens) the fractional periods by the
+ * clock error, so the ticks keep the reference time. Clamped to
+ * SYSTICK_MAX_TRIM_PPB, applied from the second period on. May be called
+ * again at run time as the reference is measured.
+ *********************************************************************/
+void SysTick_SetTrim(sint32 a_PartsPerBillion)
+{
+    NVIC_CriticalStateType state;
+    sint64 step;
+
+    if (a_PartsPerBillion > SYSTICK_MAX_TRIM_PPB)
+    {
+        a_PartsPerBillion = SYSTICK_MAX_TRIM_PPB;
+    }
+    else if (a_PartsPerBillion < -SYSTICK_MAX_TRIM_PPB)
+    {
+        a_PartsPerBillion = -SYSTICK_MAX_TRIM_PPB;
+    }
+
+    step = SysTick_TrimStep(a_PartsPerBillion);
+
+    //The handler reads the 64-bit step, the carried error is kept
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    g_SysTickTrimPpb = a_PartsPerBillion;
+    g_SysTickTrimStep = step;
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_InitTickless
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_TickInMilliSeconds - Length of one software timer tick
+ * Return Value: None
+ * Description: Initializes the SysTick timer in tickless mode: instead of
+ * an interrupt every tick, the reload value is programmed for the nearest
+ * software timer deadline (up to the 24-bit limit) and the elapsed ticks
+ * are folded back into the timer time on each interrupt.
+ *********************************************************************/
+void SysTick_InitTickless(uint16 a_TickInMilliSeconds)
+{
+    uint32 cyclesPerTick = (uint32)(((uint64)a_TickInMilliSeconds * g_SysTickCoreClockHz) / 1000);
+    uint32 load;
+
+    SYSTICK_CTRL_REG  = 0; // Disable SysTick during setup
+    load = SysTick_FirstWakeLoad(cyclesPerTick);
+    SysTick_ResetTimeBase(cyclesPerTick, load, TRUE);
+    SysTick_RefreshHandler();
+    SYSTICK_RELOAD_REG = load - 1; // First wake-up on the nearest deadline
+    SYSTICK_CURRENT_REG = 0; // Clear current register
+    SYSTICK_CTRL_REG = 0x07; // Enable SysTick with system clock and interrupts
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_StartBusyWait
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_TimeInMilliseconds - Time interval in millisecond
+ * Return Value: None
+ * Description: Initializes the SysTick timer to use polling (busy wait)
+ * for the specified time in millisecond. The function exits when the
+ * time elapses and stops the timer. Any uint32 time is supported.
+ * Use SysTick_DelayMs to wait without stopping a running SysTick.
+ *********************************************************************/
+void SysTick_StartBusyWait(uint32 a_TimeInMilliSeconds)
+{
+    uint64 left = ((uint64)a_TimeInMilliSeconds * g_SysTickCoreClockHz) / 1000;
+    uint32 load = SysTick_SegmentLoad(left);
+
+    left -= load;
+    SYSTICK_CTRL_REG  = 0; // Disable SysTick during setup
+    SYSTICK_RELOAD_REG = load - 1; // Set reload register
+    SYSTICK_CURRENT_REG = 0; // Clear current register
+    SYSTICK_CTRL_REG = 0x05; // Enable SysTick with system clock without interrupts
+
+    while (TRUE)
+    {
+        if (left != 0)
+        {
+            load = SysTick_SegmentLoad(left);
+            SYSTICK_RELOAD_REG = load - 1; // Taken when the running segment ends
+        }
+
+        while((SYSTICK_CTRL_REG & 0x00010000) == 0); // Wait for count flag to be set
+
+        if (left == 0)
+        {
+            break;
+        }
+        left -= load;
+    }
+
+    SYSTICK_CTRL_REG = 0; // Disable SysTick
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_DelayCycles
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Cycles - Time to wait in core clock cycles
+ * Return Value: None
+ * Description: Busy waits on the SysTick counter without changing its
+ * setup, so a periodic or tickless SysTick keeps running (a stopped
+ * SysTick runs free for the wait and is stopped again). With the SysTick interrupt masked, the
+ * counter is polled directly, so the wait may be of any length.
+ *********************************************************************/
+void SysTick_DelayCycles(uint64 a_Cycles)
+{
+    SysTick_Wait(a_Cycles, FALSE);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_DelayUs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMicroSeconds - Time to wait in microseconds
+ * Return Value: None
+ * Description: SysTick_DelayCycles in microseconds (one core cycle
+ * resolution).
+ *********************************************************************/
+void SysTick_DelayUs(uint32 a_TimeInMicroSeconds)
+{
+    SysTick_Wait((uint64)a_TimeInMicroSeconds * g_SysTickCyclesPerMicro, FALSE);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_DelayMs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMilliSeconds - Time to wait in milliseconds
+ * Return Value: None
+ * Description: SysTick_DelayCycles in milliseconds.
+ *********************************************************************/
+void SysTick_DelayMs(uint32 a_TimeInMilliSeconds)
+{
+    SysTick_Wait(((uint64)a_TimeInMilliSeconds * g_SysTickCoreClockHz) / 1000, FALSE);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_SleepUs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMicroSeconds - Time to wait in microseconds
+ * Return Value: None
+ * Description: Same as SysTick_DelayUs, sleeping (WFI) until the SysTick
+ * interrupts that come before the end and spinning the last part only.
+ * Without the SysTick interrupt it busy waits.
+ *********************************************************************/
+void SysTick_SleepUs(uint32 a_TimeInMicroSeconds)
+{
+    SysTick_Wait((uint64)a_TimeInMicroSeconds * g_SysTickCyclesPerMicro, TRUE);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_SleepMs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMilliSeconds - Time to wait in milliseconds
+ * Return Value: None
+ * Description: SysTick_SleepUs in milliseconds.
+ *********************************************************************/
+void SysTick_SleepMs(uint32 a_TimeInMilliSeconds)
+{
+    SysTick_Wait(((uint64)a_TimeInMilliSeconds * g_SysTickCoreClockHz) / 1000, TRUE);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_Handler
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Interrupt handler for SysTick timer, used to advance the
+ * software timers and to call the callback function (once per interrupt,
+ * i.e. once per wake-up in tickless mode)
+ *********************************************************************/
+void SysTick_Handler(void)
+{
+    uint32 ticks;
+    uint32 endedLoad = g_SysTickActiveLoad;
+
+    g_SysTickInHandler = TRUE;
+
+    //Fold the period that just ended, the hardware is already counting the next one
+    SysTick_AddCycles(endedLoad);
+    g_SysTickActiveLoad = g_SysTickNextLoad;
+    if (g_SysTickFractional)
+    {
+        //The running period is already loaded, program the one after it
+        g_SysTickNextLoad = SysTick_FractionalLoad();
+        SYSTICK_RELOAD_REG = g_SysTickNextLoad - 1;
+    }
+    SysTick_PublishTimeBase();
+
+    //Stamped once the time base is folded: the pending bit is already cleared on
+    //entry, so SysTick_GetTicks (the time source without DWT) would read a
+    //period behind before. The latency is the cycles since the wrap.
+    ISRSTATS_ENTER(ISRSTATS_SYSTICK_VECTOR, (g_SysTickActiveLoad - 1) - SYSTICK_CURRENT_REG);
+    TRACE_ISR_ENTER(TRACE_SYSTICK_VECTOR);
+
+    if (!g_SysTickTickless && (g_SysTickPeriodCycles > SYSTICK_MAX_LOAD) && !SysTick_NextSegment(endedLoad))
+    {
+        g_SysTickInHandler = FALSE;
+        TRACE_ISR_EXIT(TRACE_SYSTICK_VECTOR);
+        ISRSTATS_EXIT(ISRSTATS_SYSTICK_VECTOR);
+        return; // Only a segment of a long period ended
+    }
+
+    if (g_SysTickTickless)
+    {
+        ticks = (uint32)(g_SysTickCycleCount - g_SysTickAnnouncedCycles) / g_SysTickCyclesPerTick;
+        g_SysTickAnnouncedCycles += ticks * g_SysTickCyclesPerTick;
+        TRACE_TICK(ticks);
+        SwTimer_Advance(ticks); // Expire the software timers due in the elapsed ticks
+        SysTick_ProgramNextWake();
+    }
+    else
+    {
+        g_SysTickAnnouncedCycles = g_SysTickCycleCount;
+        TRACE_TICK(1);
+        SwTimer_Tick(); // Expire the software timers due at this tick
+    }
+
+    g_SysTickInHandler = FALSE;
+
+    if (g_SysTickCallBackPtr != NULL_PTR)
+    {
+        (*g_SysTickCallBackPtr)();
+    }
+
+    if (g_SysTickDeferredPtr != NULL_PTR)
+    {
+        (void)WorkQueue_Post(WORKQUEUE_SYSTICK_QUEUE, g_SysTickDeferredPtr, g_SysTickDeferredArgument);
+    }
+
+    TRACE_ISR_EXIT(TRACE_SYSTICK_VECTOR);
+    ISRSTATS_EXIT(ISRSTATS_SYSTICK_VECTOR);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_SetCallBack
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Pointer to the callback function
+ * Return Value: None
+ * Description: Sets up the SysTick timer callback to be executed in the
+ * SysTick Handler
+ *********************************************************************/
+void SysTick_SetCallBack(void (*Ptr2Func)(void))
+{
+    g_SysTickCallBackPtr = Ptr2Func;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_SetDeferredCallBack
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Ptr2Func - Function run from the main loop after each SysTick
+ *             interrupt (NULL_PTR to stop)
+ *             a_Argument - Argument passed to the function
+ * Return Value: None
+ * Description: The handler only posts the function to the SysTick work
+ * queue (WORKQUEUE_SYSTICK_QUEUE), it runs when the main loop calls
+ * WorkQueue_Drain, outside of the interrupt priority.
+ *********************************************************************/
+void SysTick_SetDeferredCallBack(WorkQueue_FunctionType Ptr2Func, void *a_Argument)
+{
+    g_SysTickDeferredPtr = NULL_PTR; // The handler never sees the new function with the old argument
+    g_SysTickDeferredArgument = a_Argument;
+    g_SysTickDeferredPtr = Ptr2Func;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Stops the SysTick timer
+ *********************************************************************/
+void SysTick_Stop(void)
+{
+    SYSTICK_CTRL_REG &= ~0x01; // Clear enable bit to stop SysTick
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Starts or resume the SysTick timer
+ *********************************************************************/
+void SysTick_Start(void)
+{
+    SYSTICK_CTRL_REG |= 0x01; // Set enable bit to start SysTick
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_DeInit
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: De-initializes the SysTick timer
+ *********************************************************************/
+void SysTick_DeInit(void)
+{
+    SYSTICK_CTRL_REG = 0; // Disable SysTick
+    g_SysTickTickless = FALSE;
+    g_SysTickFractional = FALSE;
+    g_SysTickActiveLoad = 0; // Freeze the time stamps
+    SysTick_PublishTimeBase();
+    SYSTICK_RELOAD_REG = 0; // Clear reload register
+    SYSTICK_CURRENT_REG = 0; // Clear current register
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_SaveContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Context - Filled with the configuration
+ * Return Value: None
+ * Description: Saves the mode, the period and the control bits set by the
+ * last SysTick_Init, SysTick_InitCycles, SysTick_InitFractional or
+ * SysTick_InitTickless call, and the core clock and trim they used.
+ *********************************************************************/
+void SysTick_SaveContext(SysTick_ContextType *a_Context)
+{
+    NVIC_CriticalStateType state;
+
+    //The trim step is 64-bit and may be changed by SysTick_SetTrim in a handler
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    a_Context->magic = SYSTICK_CONTEXT_MAGIC;
+    a_Context->control = SYSTICK_CTRL_REG & 0x07;
+    a_Context->coreClockHz = g_SysTickCoreClockHz;
+    a_Context->periodLow = 0; // Only the fields of the saved mode are kept
+    a_Context->periodHigh = 0;
+    a_Context->cyclesPerTick = 0;
+    a_Context->fracBase = 0;
+    a_Context->fracRemainder = 0;
+    a_Context->fracDenominator = 0;
+    if (g_SysTickActiveLoad == 0)
+    {
+        a_Context->mode = SYSTICK_CONTEXT_OFF; // Never started or SysTick_DeInit
+    }
+    else if (g_SysTickTickless)
+    {
+        a_Context->mode = SYSTICK_CONTEXT_TICKLESS;
+        a_Context->cyclesPerTick = g_SysTickCyclesPerTick;
+    }
+    else if (g_SysTickFractional)
+    {
+        a_Context->mode = SYSTICK_CONTEXT_FRACTIONAL;
+        a_Context->fracBase = g_SysTickFracBase;
+        a_Context->fracRemainder = g_SysTickFracRemainder;
+        a_Context->fracDenominator = g_SysTickFracDenominator;
+    }
+    else
+    {
+        a_Context->mode = SYSTICK_CONTEXT_PERIODIC;
+        a_Context->periodLow = (uint32)g_SysTickPeriodCycles;
+        a_Context->periodHigh = (uint32)(g_SysTickPeriodCycles >> 32);
+    }
+    a_Context->trimPpb = (uint32)g_SysTickTrimPpb;
+    a_Context->trimStepLow = (uint32)g_SysTickTrimStep;
+    a_Context->trimStepHigh = (uint32)((uint64)g_SysTickTrimStep >> 32);
+    NVIC_ExitCritical(state);
+
+    a_Context->checksum = SysTick_ContextChecksum(a_Context);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_RestoreContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Context - Configuration saved by SysTick_SaveContext
+ * Return Value: FALSE if the magic, the checksum or the clock is wrong
+ * (nothing is changed then)
+ * Description: Starts SysTick again as the saved init call did, without
+ * recomputing the reloads from milliseconds and without reading the
+ * SysTick registers. The time stamps restart from 0 and the software
+ * timers go on from where they stopped.
+ *********************************************************************/
+boolean SysTick_RestoreContext(const SysTick_ContextType *a_Context)
+{
+    uint32 load;
+
+    if ((a_Context->magic != SYSTICK_CONTEXT_MAGIC) || (a_Context->checksum != SysTick_ContextChecksum(a_Context)) ||
+        !SYSTICK_CLOCK_VALID(a_Context->coreClockHz))
+    {
+        return FALSE;
+    }
+
+    SYSTICK_CTRL_REG = 0; // Disable SysTick during setup
+    g_SysTickCoreClockHz = a_Context->coreClockHz;
+    g_SysTickCyclesPerMicro = a_Context->coreClockHz / 1000000UL;
+    g_SysTickTrimPpb = (sint32)a_Context->trimPpb;
+    g_SysTickTrimStep = (sint64)(((uint64)a_Context->trimStepHigh << 32) | a_Context->trimStepLow);
+
+    switch (a_Context->mode)
+    {
+    case SYSTICK_CONTEXT_TICKLESS:
+        load = SysTick_FirstWakeLoad(a_Context->cyclesPerTick);
+        SysTick_ResetTimeBase(a_Context->cyclesPerTick, load, TRUE);
+        break;
+    case SYSTICK_CONTEXT_FRACTIONAL:
+        g_SysTickFracBase = a_Context->fracBase;
+        g_SysTickFracRemainder = a_Context->fracRemainder;
+        g_SysTickFracDenominator = a_Context->fracDenominator;
+        g_SysTickFracError = 0;
+        g_SysTickTrimError = 0;
+        load = SysTick_FractionalLoad();
+        g_SysTickPeriodCycles = load; // Never split into segments
+        g_SysTickPeriodLeft = load;
+        SysTick_ResetTimeBase(0, load, FALSE);
+        g_SysTickFractional = TRUE;
+        break;
+    case SYSTICK_CONTEXT_PERIODIC:
+        g_SysTickPeriodCycles = ((uint64)a_Context->periodHigh << 32) | a_Context->periodLow;
+        g_SysTickPeriodLeft = g_SysTickPeriodCycles;
+        load = SysTick_FirstSegmentLoad(g_SysTickPeriodCycles);
+        SysTick_ResetTimeBase(0, load, FALSE);
+        break;
+    default:
+        SysTick_DeInit(); // Saved while off
+        return TRUE;
+    }
+
+    SysTick_RefreshHandler();
+    SYSTICK_RELOAD_REG = load - 1;
+    SYSTICK_CURRENT_REG = 0; // Clear current register
+    SYSTICK_CTRL_REG = a_Context->control; // Running or stopped, as saved
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_Reschedule
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Tickless mode only: brings the next SysTick interrupt
+ * forward when a software timer was armed before the programmed wake-up.
+ * Called by SwTimer_Start, does nothing in periodic mode.
+ *********************************************************************/
+void SysTick_Reschedule(void)
+{
+    uint32 wake;
+    NVIC_CriticalStateType state;
+
+    if (!g_SysTickTickless || g_SysTickInHandler)
+    {
+        return; // The handler programs the next wake-up when it returns
+    }
+
+    state = NVIC_EnterCritical(SYSTICK_CRITICAL_CEILING);
+    wake = SwTimer_GetNextExpiry(0);
+    if ((wake != SWTIMER_NO_EXPIRY) &&
+        (((uint64)wake * g_SysTickCyclesPerTick) <
+         ((g_SysTickCycleCount - g_SysTickAnnouncedCycles) + g_SysTickActiveLoad)))
+    {
+        SysTick_Restart(wake);
+    }
+    NVIC_ExitCritical(state);
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_GetUnannouncedTicks
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: Whole ticks elapsed since the software timers were advanced
+ * Description: Tickless mode only (0 in periodic mode or inside the
+ * handler): the software timer time only moves on SysTick interrupts, so
+ * this gives the part of the current sleep already elapsed. Must be
+ * called inside a SYSTICK_CRITICAL_CEILING critical section.
+ *********************************************************************/
+uint32 SysTick_GetUnannouncedTicks(void)
+{
+    uint32 cycles = (uint32)(g_SysTickCycleCount - g_SysTickAnnouncedCycles);
+    uint32 current;
+
+    if (!g_SysTickTickless || g_SysTickInHandler)
+    {
+        return 0;
+    }
+
+    current = SYSTICK_CURRENT_REG;
+    if ((NVIC_SYSTEM_INTCTRL & NVIC_INTCTRL_PENDSTSET) != 0)
+    {
+        //The running period ended but is not folded yet, the counter is in the next one
+        current = SYSTICK_CURRENT_REG;
+        cycles += g_SysTickActiveLoad + ((g_SysTickNextLoad - 1) - current);
+    }
+    else
+    {
+        cycles += (g_SysTickActiveLoad - 1) - current;
+    }
+
+    return cycles / g_SysTickCyclesPerTick;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_GetTicks
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Core clock cycles counted by SysTick since its init
+ * Description: Monotonic 64-bit time stamp made of the time base kept by
+ * the handler and the live counter. Lock-free: the interrupts stay
+ * enabled, a reader interrupted by the handler simply reads again. Safe
+ * in thread mode and in any interrupt that cannot preempt SysTick_Handler.
+ *********************************************************************/
+uint64 SysTick_GetTicks(void)
+{
+    SysTick_TimeStampType timeStamp;
+    uint32 elapsed = SysTick_ReadTimeStamp(&timeStamp);
+
+    return timeStamp.cycleCount + elapsed;
+}
+
+
+/**********************************************************************
+ * Service Name: SysTick_GetMicros
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Microseconds counted by SysTick since its init
+ * Description: Same time stamp as SysTick_GetTicks in microseconds. The
+ * time base keeps the whole microseconds, so the read path only needs a
+ * 32-bit division.
+ *********************************************************************/
+uint64 SysTick_GetMicros(void)
+{
+    SysTick_TimeStampType timeStamp;
+    uint32 elapsed = SysTick_ReadTimeStamp(&timeStamp);
+
+    return timeStamp.microCount + ((timeStamp.microRemainder + elapsed) / g_SysTickCyclesPerMicro);
+}
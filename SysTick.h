@@ -1,105 +1,411 @@
-/******************************************************************************
- *
- * Module: SysTick
- *
- * File Name: SysTick.h
- *
- * Description: Header file for the ARM Cortex M4 SysTick driver
- *
- * Author: Saraa Gomaa
- *
- *******************************************************************************/
-
-#ifndef SYSTICK_H_
-#define SYSTICK_H_
-
-/*******************************************************************************
- *                                Inclusions                                   *
- *******************************************************************************/
-#include "std_types.h"
-
-/*******************************************************************************
- *                           Function Prototypes                               *
- *******************************************************************************/
-
-/**********************************************************************
- * Service Name: SysTick_Init
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: ConfigPtr - Pointer to configuration structure
- * Return Value: None
- * Description: Initializes the SysTick timer with the specified value
- *********************************************************************/
-void SysTick_Init(uint16 a_TimeInMilliSeconds);
-
-
-/**********************************************************************
- * Service Name: SysTick_StartBusyWait
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: a_TimeInMilliseconds - Time interval in millisecond
- * Return Value: None
- * Description: Initializes the SysTick timer to use polling (busy wait)
- * for the specified time in millisecond. The function exits when the
- * time elapses and stops the timer.
- *********************************************************************/
-void SysTick_StartBusyWait(uint16 a_TimeInMilliSeconds);
-
-
-/**********************************************************************
- * Service Name: SysTick_Handler
- * Sync/Async: Asynchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: Interrupt handler for SysTick timer, used to call the
- * callback function
- *********************************************************************/
-void SysTick_Handler(void);
-
-
-/**********************************************************************
- * Service Name: SysTick_SetCallBack
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters: Ptr2Func - Pointer to the callback function
- * Return Value: None
- * Description: Sets up the SysTick timer callback to be executed in the
- * SysTick Handler
- *********************************************************************/
-void SysTick_SetCallBack(volatile void (*Ptr2Func) (void));
-
-
-/**********************************************************************
- * Service Name: SysTick_Stop
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: Stops the SysTick timer
- *********************************************************************/
-void SysTick_Stop(void);
-
-
-/**********************************************************************
- * Service Name: SysTick_Start
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: Starts or resume the SysTick timer
- *********************************************************************/
-void SysTick_Start(void);
-
-
-/**********************************************************************
- * Service Name: SysTick_DeInit
- * Sync/Async: Synchronous
- * Reentrancy: Non-Reentrant
- * Parameters: None
- * Return Value: None
- * Description: De-initializes the SysTick timer
- *********************************************************************/
-void SysTick_DeInit(void);
-
-#endif /* SYSTICK_H_ */
+/******************************************************************************
+ *
+ * Module: SysTick
+ *
+ * File Name: SysTick.h
+ *
+ * Description: Header file for the ARM Cortex M4 SysTick driver
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef SYSTICK_H_
+#define SYSTICK_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+#include "WorkQueue.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+/* Core clock counted by SysTick at reset (16MHz PIOSC), changed at run time
+ * with SysTick_SetCoreClock after switching to the PLL */
+#ifndef SYSTICK_CORE_CLOCK_HZ
+#define SYSTICK_CORE_CLOCK_HZ                16000000UL
+#endif
+
+/* Priority ceiling of the critical sections protecting the state shared with
+ * SysTick_Handler: set it to the SysTick priority so the IRQs above it stay
+ * live. 0 masks every interrupt (PRIMASK). */
+#ifndef SYSTICK_CRITICAL_CEILING
+#define SYSTICK_CRITICAL_CEILING             0
+#endif
+
+/* Largest clock trim accepted by SysTick_SetTrim, in parts per billion */
+#ifndef SYSTICK_MAX_TRIM_PPB
+#define SYSTICK_MAX_TRIM_PPB                 1000000L
+#endif
+
+/* Compile-time conversions for SysTick_InitCycles (with SYSTICK_CORE_CLOCK_HZ) */
+#define SYSTICK_MS_TO_CYCLES(ms)             ((uint64)(ms) * (SYSTICK_CORE_CLOCK_HZ / 1000UL))
+#define SYSTICK_US_TO_CYCLES(us)             ((uint64)(us) * (SYSTICK_CORE_CLOCK_HZ / 1000000UL))
+
+/* First word of a valid SysTick_ContextType ("STCK") */
+#define SYSTICK_CONTEXT_MAGIC                0x5354434BUL
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+
+/* SysTick configuration saved by SysTick_SaveContext, only 32-bit words
+ * with the checksum last */
+typedef struct
+{
+    uint32 magic;                      /* SYSTICK_CONTEXT_MAGIC */
+    uint32 control;                    /* ENABLE, INTEN and CLK_SRC bits of CTRL */
+    uint32 coreClockHz;
+    uint32 mode;                       /* Off, periodic, tickless or fractional */
+    uint32 periodLow;                  /* Periodic: period in cycles */
+    uint32 periodHigh;
+    uint32 cyclesPerTick;              /* Tickless: length of one timer tick */
+    uint32 fracBase;                   /* Fractional: period of the reloads */
+    uint32 fracRemainder;
+    uint32 fracDenominator;
+    uint32 trimPpb;                    /* SysTick_SetTrim value */
+    uint32 trimStepLow;                /* Trim of one period, kept to skip the divisions */
+    uint32 trimStepHigh;
+    uint32 checksum;
+} SysTick_ContextType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: SysTick_SetCoreClock
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_ClockHz - Core clock frequency in Hz (whole MHz)
+ * Return Value: FALSE if the clock is not a whole number of MHz (the
+ * previous clock is kept then)
+ * Description: Sets the clock used to convert times into SysTick cycles.
+ * Call it after every clock change, before SysTick_Init.
+ *********************************************************************/
+boolean SysTick_SetCoreClock(uint32 a_ClockHz);
+
+
+/**********************************************************************
+ * Service Name: SysTick_InstallHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Installs SysTick_Handler in the RAM vector table, which is
+ * relocated first if needed. Only for startup files that do not name
+ * SysTick_Handler: the init functions install it themselves only once the
+ * table has been relocated, and never relocate it.
+ *********************************************************************/
+void SysTick_InstallHandler(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_TimeInMilliSeconds - Interrupt period in millisecond
+ * Return Value: None
+ * Description: Initializes the SysTick timer with the specified period.
+ * Periods longer than the 24-bit counter are split into chained reload
+ * segments, the software timers and the callback only see the end of
+ * the whole period.
+ *********************************************************************/
+void SysTick_Init(uint32 a_TimeInMilliSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_InitCycles
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Interrupt period in core clock cycles
+ * Return Value: None
+ * Description: Same as SysTick_Init with the period in cycles, to be used
+ * with SYSTICK_MS_TO_CYCLES so the conversion is done at compile time.
+ * Both update the SysTick_Handler entry of a relocated vector table (see
+ * SysTick_InstallHandler). A period shorter
+ * than SYSTICK_MIN_LOAD_CYCLES is rejected, SysTick is left as it was.
+ *********************************************************************/
+void SysTick_InitCycles(uint64 a_Cycles);
+
+
+/**********************************************************************
+ * Service Name: SysTick_InitFractional
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_PeriodNumerator - Interrupt period in seconds, numerator
+ *             a_PeriodDenominator - Interrupt period in seconds, denominator
+ * Return Value: FALSE if the period is not between SYSTICK_MIN_LOAD_CYCLES
+ * and the 24-bit counter range (trim margin included)
+ * Description: Periodic mode for a period that is not a whole number of
+ * cycles, e.g. 1/60 s or 1/3 ms. Each reload is the whole part of the
+ * period, plus one cycle whenever the fractions left over add up to a
+ * cycle, so the mean period is exact and the error never exceeds one
+ * cycle. The trim of SysTick_SetTrim is carried in the same way.
+ *********************************************************************/
+boolean SysTick_InitFractional(uint32 a_PeriodNumerator, uint32 a_PeriodDenominator);
+
+
+/**********************************************************************
+ * Service Name: SysTick_SetTrim
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_PartsPerBillion - Core clock error against a reference,
+ *             positive when the core clock runs fast (1000 = 1 ppm)
+ * Return Value: None
+ * Description: Lengthens (or shortens) the fractional periods by the
+ * clock error, so the ticks keep the reference time. Clamped to
+ * SYSTICK_MAX_TRIM_PPB, applied from the second period on. May be called
+ * again at run time as the reference is measured.
+ *********************************************************************/
+void SysTick_SetTrim(sint32 a_PartsPerBillion);
+
+
+/**********************************************************************
+ * Service Name: SysTick_InitTickless
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_TickInMilliSeconds - Length of one software timer tick
+ * Return Value: None
+ * Description: Initializes the SysTick timer in tickless mode: instead of
+ * an interrupt every tick, the reload value is programmed for the nearest
+ * software timer deadline (up to the 24-bit limit) and the elapsed ticks
+ * are folded back into the timer time on each interrupt. The tick must
+ * be shorter than 2^32 cycles.
+ *********************************************************************/
+void SysTick_InitTickless(uint16 a_TickInMilliSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_StartBusyWait
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_TimeInMilliseconds - Time interval in millisecond
+ * Return Value: None
+ * Description: Initializes the SysTick timer to use polling (busy wait)
+ * for the specified time in millisecond. The function exits when the
+ * time elapses and stops the timer. Any uint32 time is supported.
+ * Use SysTick_DelayMs to wait without stopping a running SysTick.
+ *********************************************************************/
+void SysTick_StartBusyWait(uint32 a_TimeInMilliSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_DelayCycles
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Cycles - Time to wait in core clock cycles
+ * Return Value: None
+ * Description: Busy waits on the SysTick counter without changing its
+ * setup, so a periodic or tickless SysTick keeps running (a stopped
+ * SysTick runs free for the wait and is stopped again). With the SysTick interrupt masked, the
+ * counter is polled directly, so the wait may be of any length.
+ *********************************************************************/
+void SysTick_DelayCycles(uint64 a_Cycles);
+
+
+/**********************************************************************
+ * Service Name: SysTick_DelayUs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMicroSeconds - Time to wait in microseconds
+ * Return Value: None
+ * Description: SysTick_DelayCycles in microseconds (one core cycle
+ * resolution).
+ *********************************************************************/
+void SysTick_DelayUs(uint32 a_TimeInMicroSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_DelayMs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMilliSeconds - Time to wait in milliseconds
+ * Return Value: None
+ * Description: SysTick_DelayCycles in milliseconds.
+ *********************************************************************/
+void SysTick_DelayMs(uint32 a_TimeInMilliSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_SleepUs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMicroSeconds - Time to wait in microseconds
+ * Return Value: None
+ * Description: Same as SysTick_DelayUs, sleeping (WFI) until the SysTick
+ * interrupts that come before the end and spinning the last part only.
+ * Without the SysTick interrupt it busy waits.
+ *********************************************************************/
+void SysTick_SleepUs(uint32 a_TimeInMicroSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_SleepMs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_TimeInMilliSeconds - Time to wait in milliseconds
+ * Return Value: None
+ * Description: SysTick_SleepUs in milliseconds.
+ *********************************************************************/
+void SysTick_SleepMs(uint32 a_TimeInMilliSeconds);
+
+
+/**********************************************************************
+ * Service Name: SysTick_Handler
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Interrupt handler for SysTick timer, used to advance the
+ * software timers and to call the callback function (once per interrupt,
+ * i.e. once per wake-up in tickless mode)
+ *********************************************************************/
+void SysTick_Handler(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_SetCallBack
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: Ptr2Func - Pointer to the callback function
+ * Return Value: None
+ * Description: Sets up the SysTick timer callback to be executed in the
+ * SysTick Handler
+ *********************************************************************/
+void SysTick_SetCallBack(void (*Ptr2Func) (void));
+
+
+/**********************************************************************
+ * Service Name: SysTick_SetDeferredCallBack
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Ptr2Func - Function run from the main loop after each SysTick
+ *             interrupt (NULL_PTR to stop)
+ *             a_Argument - Argument passed to the function
+ * Return Value: None
+ * Description: The handler only posts the function to the SysTick work
+ * queue (WORKQUEUE_SYSTICK_QUEUE), it runs when the main loop calls
+ * WorkQueue_Drain, outside of the interrupt priority.
+ *********************************************************************/
+void SysTick_SetDeferredCallBack(WorkQueue_FunctionType Ptr2Func, void *a_Argument);
+
+
+/**********************************************************************
+ * Service Name: SysTick_Stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Stops the SysTick timer
+ *********************************************************************/
+void SysTick_Stop(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Starts or resume the SysTick timer
+ *********************************************************************/
+void SysTick_Start(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_DeInit
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: De-initializes the SysTick timer
+ *********************************************************************/
+void SysTick_DeInit(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_SaveContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Context - Filled with the configuration
+ * Return Value: None
+ * Description: Saves the mode, the period and the control bits set by the
+ * last SysTick_Init, SysTick_InitCycles, SysTick_InitFractional or
+ * SysTick_InitTickless call, and the core clock and trim they used.
+ *********************************************************************/
+void SysTick_SaveContext(SysTick_ContextType *a_Context);
+
+
+/**********************************************************************
+ * Service Name: SysTick_RestoreContext
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Context - Configuration saved by SysTick_SaveContext
+ * Return Value: FALSE if the magic, the checksum or the clock is wrong
+ * (nothing is changed then)
+ * Description: Starts SysTick again as the saved init call did, without
+ * recomputing the reloads from milliseconds and without reading the
+ * SysTick registers. The time stamps restart from 0 and the software
+ * timers go on from where they stopped.
+ *********************************************************************/
+boolean SysTick_RestoreContext(const SysTick_ContextType *a_Context);
+
+
+/**********************************************************************
+ * Service Name: SysTick_Reschedule
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Tickless mode only: brings the next SysTick interrupt
+ * forward when a software timer was armed before the programmed wake-up.
+ * Called by SwTimer_Start, does nothing in periodic mode.
+ *********************************************************************/
+void SysTick_Reschedule(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_GetUnannouncedTicks
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: Whole ticks elapsed since the software timers were advanced
+ * Description: Tickless mode only (0 in periodic mode or inside the
+ * handler): the software timer time only moves on SysTick interrupts, so
+ * this gives the part of the current sleep already elapsed. Must be
+ * called inside a SYSTICK_CRITICAL_CEILING critical section.
+ *********************************************************************/
+uint32 SysTick_GetUnannouncedTicks(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_GetTicks
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Core clock cycles counted by SysTick since its init
+ * Description: Monotonic 64-bit time stamp made of the time base kept by
+ * the handler and the live counter. Lock-free: the interrupts stay
+ * enabled, a reader interrupted by the handler simply reads again. Safe
+ * in thread mode and in any interrupt that cannot preempt SysTick_Handler.
+ *********************************************************************/
+uint64 SysTick_GetTicks(void);
+
+
+/**********************************************************************
+ * Service Name: SysTick_GetMicros
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Microseconds counted by SysTick since its init
+ * Description: Same time stamp as SysTick_GetTicks in microseconds. The
+ * time base keeps the whole microseconds, so the read path only needs a
+ * 32-bit division.
+ *********************************************************************/
+uint64 SysTick_GetMicros(void);
+
+#endif /* SYSTICK_H_ */
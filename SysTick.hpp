@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * Module: SysTick
+ *
+ * File Name: SysTick.hpp
+ *
+ * Description: Header-only C++ front-end of the SysTick driver for a core
+ *              clock and times known at compile time. The conversions to
+ *              SysTick cycles are constant expressions and the values the
+ *              driver cannot run do not compile. The driver state (time
+ *              base, long periods, handler) is still set up by the C API.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef SYSTICK_HPP_
+#define SYSTICK_HPP_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "SysTick.h"
+
+/*******************************************************************************
+ *                           Template Definitions                              *
+ *******************************************************************************/
+namespace SysTick
+{
+
+/* SysTick cycles of a time in microseconds */
+constexpr uint64 cycles(uint32 a_ClockHz, uint64 a_TimeInMicroSeconds)
+{
+    return a_TimeInMicroSeconds * (a_ClockHz / 1000000UL);
+}
+
+/* Periodic interrupt every PeriodMs milliseconds, core clock ClockHz */
+template <uint32 ClockHz, uint32 PeriodMs>
+inline void init()
+{
+    static_assert((ClockHz != 0) && ((ClockHz % 1000000UL) == 0), "SysTick: the core clock must be a whole number of MHz");
+    static_assert(PeriodMs != 0, "SysTick: the period must not be 0");
+    (void)SysTick_SetCoreClock(ClockHz); // Checked above
+    SysTick_InitCycles(cycles(ClockHz, (uint64)PeriodMs * 1000UL));
+}
+
+/* Busy wait of TimeInMicroSeconds, core clock ClockHz */
+template <uint32 ClockHz, uint32 TimeInMicroSeconds>
+inline void delayUs()
+{
+    static_assert((ClockHz != 0) && ((ClockHz % 1000000UL) == 0), "SysTick: the core clock must be a whole number of MHz");
+    SysTick_DelayCycles(cycles(ClockHz, TimeInMicroSeconds));
+}
+
+} /* namespace SysTick */
+
+#endif /* SYSTICK_HPP_ */
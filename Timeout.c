@@ -0,0 +1,168 @@
+/******************************************************************************
+ *
+ * Module: Timeout
+ *
+ * File Name: Timeout.c
+ *
+ * Description: Source file for the asynchronous timeouts (one-shot
+ *              software timers with a completion flag).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "Timeout.h"
+#include "NVIC.h"
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Expiry of the software timer, in SysTick interrupt context */
+static void Timeout_Expire(void *a_Context)
+{
+    Timeout_Type *timeout = (Timeout_Type *)a_Context;
+
+    timeout->expired = TRUE;
+    if (timeout->callback != NULL_PTR)
+    {
+        (*timeout->callback)(timeout->context);
+    }
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Timeout_Create
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be set up
+ *             Ptr2Func - Function called on expiry (in SysTick interrupt
+ *             context), NULL_PTR if the flag is enough
+ *             a_Context - Pointer passed back to the function
+ * Return Value: FALSE if no software timer is free
+ * Description: Takes a software timer for the timeout, which stays
+ * stopped until Timeout_Start.
+ *********************************************************************/
+boolean Timeout_Create(Timeout_Type *a_Timeout, SwTimer_CallBackType Ptr2Func, void *a_Context)
+{
+    a_Timeout->expired = FALSE;
+    a_Timeout->callback = Ptr2Func;
+    a_Timeout->context = a_Context;
+    a_Timeout->timer = SwTimer_Create(Timeout_Expire, a_Timeout);
+
+    return (boolean)(a_Timeout->timer != SWTIMER_INVALID_ID);
+}
+
+
+/**********************************************************************
+ * Service Name: Timeout_Delete
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be released
+ * Return Value: None
+ * Description: Cancels the timeout and gives its timer back to the pool.
+ *********************************************************************/
+void Timeout_Delete(Timeout_Type *a_Timeout)
+{
+    SwTimer_Delete(a_Timeout->timer);
+    a_Timeout->timer = SWTIMER_INVALID_ID;
+}
+
+
+/**********************************************************************
+ * Service Name: Timeout_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be armed
+ *             a_Ticks - Interval in SysTick ticks (at least 1)
+ * Return Value: FALSE on invalid arguments
+ * Description: Clears the flag and arms the timeout to expire a_Ticks
+ * ticks from now, then returns at once. Restarting a running timeout
+ * moves its deadline.
+ *********************************************************************/
+boolean Timeout_Start(Timeout_Type *a_Timeout, uint32 a_Ticks)
+{
+    if (a_Ticks == 0)
+    {
+        return FALSE;
+    }
+
+    SwTimer_Stop(a_Timeout->timer); // No expiry of the previous run after the flag is cleared
+    a_Timeout->expired = FALSE;
+
+    return SwTimer_Start(a_Timeout->timer, a_Ticks, SWTIMER_ONE_SHOT);
+}
+
+
+/**********************************************************************
+ * Service Name: Timeout_Cancel
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be stopped
+ * Return Value: None
+ * Description: Stops the timeout if it has not expired yet: the
+ * completion function is not called and the flag stays FALSE.
+ *********************************************************************/
+void Timeout_Cancel(Timeout_Type *a_Timeout)
+{
+    SwTimer_Stop(a_Timeout->timer);
+}
+
+
+/**********************************************************************
+ * Service Name: Timeout_IsExpired
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be checked
+ * Return Value: TRUE once the timeout has expired
+ * Description: Reads the completion flag.
+ *********************************************************************/
+boolean Timeout_IsExpired(const Timeout_Type *a_Timeout)
+{
+    return a_Timeout->expired;
+}
+
+
+/**********************************************************************
+ * Service Name: Timeout_GetRemaining
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be checked
+ * Return Value: Ticks left, 0 once expired or cancelled
+ * Description: Returns the time left before the expiry.
+ *********************************************************************/
+uint32 Timeout_GetRemaining(const Timeout_Type *a_Timeout)
+{
+    return SwTimer_GetRemaining(a_Timeout->timer);
+}
+
+
+/**********************************************************************
+ * Service Name: Timeout_Sleep
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Timeout - Timeout waited for
+ * Return Value: Ticks left, 0 once expired or cancelled
+ * Description: Thread mode only: sleeps with WFI until the timeout expires
+ * or another interrupt is taken, whichever comes first, and returns
+ * after that interrupt has run. Returns at once if the timeout is not
+ * running. In periodic mode every tick wakes the core, in tickless mode
+ * only the nearest software timer deadline does.
+ *********************************************************************/
+uint32 Timeout_Sleep(Timeout_Type *a_Timeout)
+{
+    NVIC_CriticalStateType state;
+
+    //An interrupt arriving between the check and WFI stays pending, so WFI returns
+    state = NVIC_EnterCritical(0);
+    if (SwTimer_IsRunning(a_Timeout->timer))
+    {
+        Wait_For_Interrupt();
+    }
+    NVIC_ExitCritical(state); // The interrupt that woke the core runs here
+
+    return SwTimer_GetRemaining(a_Timeout->timer);
+}
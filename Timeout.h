@@ -0,0 +1,129 @@
+/******************************************************************************
+ *
+ * Module: Timeout
+ *
+ * File Name: Timeout.h
+ *
+ * Description: Header file for the asynchronous timeouts. A timeout is a
+ *              one-shot software timer that raises a flag and calls an
+ *              optional completion function when it expires, so the caller
+ *              is free while it runs: it may poll the flag from the main
+ *              loop or sleep with Timeout_Sleep, which returns on the
+ *              expiry or on any earlier interrupt with the time left. All
+ *              the running timeouts share the timing wheel, so in tickless
+ *              mode the SysTick wakes the core only at the nearest of their
+ *              deadlines.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef TIMEOUT_H_
+#define TIMEOUT_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+#include "SwTimer.h"
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+
+/* Owned by the caller, set up by Timeout_Create */
+typedef struct
+{
+    SwTimer_IdType timer;
+    volatile boolean expired;          /* Set on expiry, cleared by Timeout_Start */
+    SwTimer_CallBackType callback;     /* Completion function, NULL_PTR for the flag only */
+    void *context;
+} Timeout_Type;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Timeout_Create
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be set up
+ *             Ptr2Func - Function called on expiry (in SysTick interrupt
+ *             context), NULL_PTR if the flag is enough
+ *             a_Context - Pointer passed back to the function
+ * Return Value: FALSE if no software timer is free
+ * Description: Takes a software timer for the timeout, which stays
+ * stopped until Timeout_Start.
+ *********************************************************************/
+boolean Timeout_Create(Timeout_Type *a_Timeout, SwTimer_CallBackType Ptr2Func, void *a_Context);
+
+/**********************************************************************
+ * Service Name: Timeout_Delete
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be released
+ * Return Value: None
+ * Description: Cancels the timeout and gives its timer back to the pool.
+ *********************************************************************/
+void Timeout_Delete(Timeout_Type *a_Timeout);
+
+/**********************************************************************
+ * Service Name: Timeout_Start
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be armed
+ *             a_Ticks - Interval in SysTick ticks (at least 1)
+ * Return Value: FALSE on invalid arguments
+ * Description: Clears the flag and arms the timeout to expire a_Ticks
+ * ticks from now, then returns at once. Restarting a running timeout
+ * moves its deadline.
+ *********************************************************************/
+boolean Timeout_Start(Timeout_Type *a_Timeout, uint32 a_Ticks);
+
+/**********************************************************************
+ * Service Name: Timeout_Cancel
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be stopped
+ * Return Value: None
+ * Description: Stops the timeout if it has not expired yet: the
+ * completion function is not called and the flag stays FALSE.
+ *********************************************************************/
+void Timeout_Cancel(Timeout_Type *a_Timeout);
+
+/**********************************************************************
+ * Service Name: Timeout_IsExpired
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be checked
+ * Return Value: TRUE once the timeout has expired
+ * Description: Reads the completion flag.
+ *********************************************************************/
+boolean Timeout_IsExpired(const Timeout_Type *a_Timeout);
+
+/**********************************************************************
+ * Service Name: Timeout_GetRemaining
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Timeout - Timeout to be checked
+ * Return Value: Ticks left, 0 once expired or cancelled
+ * Description: Returns the time left before the expiry.
+ *********************************************************************/
+uint32 Timeout_GetRemaining(const Timeout_Type *a_Timeout);
+
+/**********************************************************************
+ * Service Name: Timeout_Sleep
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Timeout - Timeout waited for
+ * Return Value: Ticks left, 0 once expired or cancelled
+ * Description: Thread mode only: sleeps with WFI until the timeout expires
+ * or another interrupt is taken, whichever comes first, and returns
+ * after that interrupt has run. Returns at once if the timeout is not
+ * running. In periodic mode every tick wakes the core, in tickless mode
+ * only the nearest software timer deadline does.
+ *********************************************************************/
+uint32 Timeout_Sleep(Timeout_Type *a_Timeout);
+
+#endif /* TIMEOUT_H_ */
@@ -0,0 +1,232 @@
+/******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: Trace.c
+ *
+ * Description: Source file for the interrupt trace recorder (ring of
+ *              8-byte event records).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "Trace.h"
+
+#if TRACE_ENABLE
+
+#include "NVIC.h"
+#include "SysTick.h"
+#include "Mcu_Registers.h"
+
+#if (TRACE_BUFFER_RECORDS & (TRACE_BUFFER_RECORDS - 1)) != 0
+#error "Trace: TRACE_BUFFER_RECORDS must be a power of two"
+#endif
+
+#define DWT_CTRL_CYCCNTENA                   0x00000001
+#define CORE_DEMCR_TRCENA                    0x01000000
+
+#if TRACE_USE_DWT
+#define TRACE_NOW()                          ((uint32)DWT_CYCCNT_REG)
+#else
+#define TRACE_NOW()                          ((uint32)SysTick_GetTicks())
+#endif
+
+#define TRACE_SLOT(Index)                    ((Index) & (TRACE_BUFFER_RECORDS - 1))
+
+/*
+ * head counts the slots taken since Trace_Init (modulo 2^32). A record is
+ * written in the slot it took, so a handler preempting another recording
+ * simply takes the next slot. The stamp is taken before the slot, so the
+ * preempting record can hold a later stamp in an earlier slot: records may
+ * be out of order by the length of a record. A slot never written keeps
+ * info 0.
+ */
+static volatile Trace_RecordType g_TraceBuffer[TRACE_BUFFER_RECORDS];
+static volatile uint32 g_TraceHead = 0;
+static volatile boolean g_TraceFrozen = TRUE;
+static uint32 g_TraceClockHz = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Takes the next slot: returns the old head and increments it atomically */
+#if defined(TM4C_HOST_SIM)
+
+static uint32 Trace_TakeSlot(void)
+{
+    return g_TraceHead++; // The simulated interrupts never preempt a recording
+}
+
+#elif defined(__GNUC__)
+
+static inline uint32 Trace_TakeSlot(void)
+{
+    return __atomic_fetch_add(&g_TraceHead, 1, __ATOMIC_RELAXED); // LDREX/STREX loop
+}
+
+#else /* TI ARM compiler intrinsics */
+
+static inline uint32 Trace_TakeSlot(void)
+{
+    uint32 primask = _disable_interrupts();
+    uint32 index = g_TraceHead;
+
+    g_TraceHead = index + 1;
+    _restore_interrupts(primask);
+    return index;
+}
+
+#endif /* TM4C_HOST_SIM */
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Trace_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_ClockHz - Core clock, saved in the snapshots
+ * Return Value: None
+ * Description: Starts the DWT cycle counter (TRACE_USE_DWT), empties the
+ * ring and starts recording.
+ *********************************************************************/
+void Trace_Init(uint32 a_ClockHz)
+{
+    uint32 slot;
+
+#if TRACE_USE_DWT
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA; // Power the DWT unit
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA; // Start the cycle counter
+#endif
+
+    g_TraceFrozen = TRUE;
+    for (slot = 0; slot < TRACE_BUFFER_RECORDS; slot++)
+    {
+        g_TraceBuffer[slot].timeStamp = 0;
+        g_TraceBuffer[slot].info = 0;
+    }
+    g_TraceHead = 0;
+    g_TraceClockHz = a_ClockHz;
+    g_TraceFrozen = FALSE;
+}
+
+
+/**********************************************************************
+ * Service Name: Trace_Record
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Info - TRACE_INFO(event, vector, data)
+ * Return Value: None
+ * Description: Time stamps the event and writes it over the oldest record
+ * of the ring (the TRACE_ hooks). Does nothing while the ring is frozen.
+ *********************************************************************/
+void Trace_Record(uint32 a_Info)
+{
+    volatile Trace_RecordType *record;
+    uint32 timeStamp;
+
+    if (g_TraceFrozen)
+    {
+        return;
+    }
+
+    timeStamp = TRACE_NOW();
+    record = &g_TraceBuffer[TRACE_SLOT(Trace_TakeSlot())];
+    record->timeStamp = timeStamp;
+    record->info = a_Info;
+}
+
+
+/**********************************************************************
+ * Service Name: Trace_Freeze
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Stops the recording, e.g. when a deadline is missed, so the
+ * events that led to it stay in the ring until Trace_Resume.
+ *********************************************************************/
+void Trace_Freeze(void)
+{
+    g_TraceFrozen = TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: Trace_Resume
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Restarts the recording after Trace_Freeze.
+ *********************************************************************/
+void Trace_Resume(void)
+{
+    g_TraceFrozen = FALSE;
+}
+
+
+/**********************************************************************
+ * Service Name: Trace_IsFrozen
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE while the recording is stopped
+ * Description: Tells if the ring is frozen.
+ *********************************************************************/
+boolean Trace_IsFrozen(void)
+{
+    return g_TraceFrozen;
+}
+
+
+/**********************************************************************
+ * Service Name: Trace_Snapshot
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Header - Filled with the snapshot header
+ *             a_Records - Filled with the newest records, oldest first
+ *             a_MaxRecords - Size of a_Records
+ * Return Value: Number of records copied
+ * Description: Copies the ring out, from thread code. The recording is
+ * stopped during the copy (the events of that time are not recorded) and
+ * then left as it was. Writing the header and the records one after the
+ * other gives the dump read by host/TraceDecode.c.
+ *********************************************************************/
+uint32 Trace_Snapshot(Trace_HeaderType *a_Header, Trace_RecordType *a_Records, uint32 a_MaxRecords)
+{
+    boolean frozen = g_TraceFrozen;
+    uint32 head;
+    uint32 index;
+    uint32 count = 0;
+    uint32 taken;
+
+    //Any recording already started ran to its end in a handler before this point
+    g_TraceFrozen = TRUE;
+    head = g_TraceHead;
+
+    taken = (a_MaxRecords < TRACE_BUFFER_RECORDS) ? a_MaxRecords : TRACE_BUFFER_RECORDS;
+    for (index = head - taken; index != head; index++)
+    {
+        if (g_TraceBuffer[TRACE_SLOT(index)].info != 0) // Skip the slots never written
+        {
+            a_Records[count].timeStamp = g_TraceBuffer[TRACE_SLOT(index)].timeStamp;
+            a_Records[count].info = g_TraceBuffer[TRACE_SLOT(index)].info;
+            count++;
+        }
+    }
+
+    g_TraceFrozen = frozen;
+
+    a_Header->magic = TRACE_MAGIC;
+    a_Header->clockHz = g_TraceClockHz;
+    a_Header->count = count;
+    a_Header->lost = head - count; // Modulo 2^32, like head
+
+    return count;
+}
+
+#endif /* TRACE_ENABLE */
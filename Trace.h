@@ -0,0 +1,177 @@
+/******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: Trace.h
+ *
+ * Description: Header file for the interrupt trace recorder. Handler entries
+ *              and exits, SysTick ticks and user markers are written as
+ *              8-byte records (time stamp, event, vector, data) into a RAM
+ *              ring that always holds the latest TRACE_BUFFER_RECORDS events.
+ *              A record takes a slot with a lock-free increment of the head
+ *              index, so any priority may record without masking the
+ *              interrupts. The ring is frozen to keep the history around a
+ *              fault and copied out with Trace_Snapshot; host/TraceDecode.c
+ *              turns the copy into a Chrome trace. Everything compiles out
+ *              unless TRACE_ENABLE is set to 1.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE                         0
+#endif
+
+/* Time stamps from the DWT cycle counter (1, a single register read) or from
+ * SysTick_GetTicks (0, for cores without DWT; much slower to record) */
+#ifndef TRACE_USE_DWT
+#define TRACE_USE_DWT                        1
+#endif
+
+/* Records in the ring, a power of two */
+#ifndef TRACE_BUFFER_RECORDS
+#define TRACE_BUFFER_RECORDS                 256
+#endif
+
+/* Events, the vector is the exception number (IRQ + 16) for the handlers
+ * and the marker number for the user markers */
+#define TRACE_EVENT_ISR_ENTER                1
+#define TRACE_EVENT_ISR_EXIT                 2
+#define TRACE_EVENT_TICK                     3
+#define TRACE_EVENT_MARKER                   4
+
+#define TRACE_SYSTICK_VECTOR                 15
+#define TRACE_IRQ_VECTOR(IRQ)                ((uint8)((IRQ) + 16))
+
+/* Record info word: event in bits 0-7, vector in bits 8-15, data in bits 16-31 */
+#define TRACE_INFO(Event, Vector, Data)      ((uint32)(Event) | ((uint32)(Vector) << 8) | ((uint32)(Data) << 16))
+#define TRACE_INFO_EVENT(Info)               ((uint8)((Info) & 0xFF))
+#define TRACE_INFO_VECTOR(Info)              ((uint8)(((Info) >> 8) & 0xFF))
+#define TRACE_INFO_DATA(Info)                ((uint16)((Info) >> 16))
+
+/* First word of a snapshot: "TRC1" in a little-endian dump */
+#define TRACE_MAGIC                          0x31435254UL
+
+/* Hooks placed in the handlers and the application code */
+#if TRACE_ENABLE
+#define TRACE_ISR_ENTER(Vector)              Trace_Record(TRACE_INFO(TRACE_EVENT_ISR_ENTER, (Vector), 0))
+#define TRACE_ISR_EXIT(Vector)               Trace_Record(TRACE_INFO(TRACE_EVENT_ISR_EXIT, (Vector), 0))
+#define TRACE_TICK(Ticks)                    Trace_Record(TRACE_INFO(TRACE_EVENT_TICK, TRACE_SYSTICK_VECTOR, (Ticks)))
+#define TRACE_MARKER(Marker, Data)           Trace_Record(TRACE_INFO(TRACE_EVENT_MARKER, (Marker), (Data)))
+#else
+#define TRACE_ISR_ENTER(Vector)
+#define TRACE_ISR_EXIT(Vector)
+#define TRACE_TICK(Ticks)
+#define TRACE_MARKER(Marker, Data)
+#endif
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+
+/* One event, as stored in the ring and in a snapshot */
+typedef struct
+{
+    uint32 timeStamp;                  /* Core cycles, modulo 2^32 */
+    uint32 info;                       /* TRACE_INFO(event, vector, data) */
+} Trace_RecordType;
+
+/* Snapshot header, followed by count records oldest first */
+typedef struct
+{
+    uint32 magic;                      /* TRACE_MAGIC */
+    uint32 clockHz;                    /* Core clock given to Trace_Init */
+    uint32 count;                      /* Records in the snapshot */
+    uint32 lost;                       /* Older records overwritten in the ring */
+} Trace_HeaderType;
+
+#if TRACE_ENABLE
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Trace_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_ClockHz - Core clock, saved in the snapshots
+ * Return Value: None
+ * Description: Starts the DWT cycle counter (TRACE_USE_DWT), empties the
+ * ring and starts recording.
+ *********************************************************************/
+void Trace_Init(uint32 a_ClockHz);
+
+/**********************************************************************
+ * Service Name: Trace_Record
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Info - TRACE_INFO(event, vector, data)
+ * Return Value: None
+ * Description: Time stamps the event and writes it over the oldest record
+ * of the ring (the TRACE_ hooks). Does nothing while the ring is frozen.
+ *********************************************************************/
+void Trace_Record(uint32 a_Info);
+
+/**********************************************************************
+ * Service Name: Trace_Freeze
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Stops the recording, e.g. when a deadline is missed, so the
+ * events that led to it stay in the ring until Trace_Resume.
+ *********************************************************************/
+void Trace_Freeze(void);
+
+/**********************************************************************
+ * Service Name: Trace_Resume
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Restarts the recording after Trace_Freeze.
+ *********************************************************************/
+void Trace_Resume(void);
+
+/**********************************************************************
+ * Service Name: Trace_IsFrozen
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE while the recording is stopped
+ * Description: Tells if the ring is frozen.
+ *********************************************************************/
+boolean Trace_IsFrozen(void);
+
+/**********************************************************************
+ * Service Name: Trace_Snapshot
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Header - Filled with the snapshot header
+ *             a_Records - Filled with the newest records, oldest first
+ *             a_MaxRecords - Size of a_Records
+ * Return Value: Number of records copied
+ * Description: Copies the ring out, from thread code. The recording is
+ * stopped during the copy (the events of that time are not recorded) and
+ * then left as it was. Writing the header and the records one after the
+ * other gives the dump read by host/TraceDecode.c.
+ *********************************************************************/
+uint32 Trace_Snapshot(Trace_HeaderType *a_Header, Trace_RecordType *a_Records, uint32 a_MaxRecords);
+
+#endif /* TRACE_ENABLE */
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,183 @@
+/******************************************************************************
+ *
+ * Module: WorkQueue
+ *
+ * File Name: WorkQueue.c
+ *
+ * Description: Source file for the deferred work queues (lock-free single
+ *              producer / single consumer rings).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "WorkQueue.h"
+
+#define WORKQUEUE_INDEX_MASK                 (WORKQUEUE_CAPACITY - 1)
+
+/* Compile-time check: the ring index is the free running counter masked */
+typedef char WorkQueue_CapacityIsPowerOfTwo[((WORKQUEUE_CAPACITY & WORKQUEUE_INDEX_MASK) == 0) ? 1 : -1];
+
+typedef struct
+{
+    WorkQueue_FunctionType function;
+    void *argument;
+} WorkQueue_ItemType;
+
+/*
+ * The producer only writes head, the consumer only writes tail, both are free
+ * running counters so head - tail is the fill level. The item is stored
+ * before head is published, the volatile accesses keep that order.
+ */
+typedef struct
+{
+    volatile WorkQueue_ItemType items[WORKQUEUE_CAPACITY];
+    volatile uint32 head;
+    volatile uint32 tail;
+    volatile uint32 overflows;
+} WorkQueue_RingType;
+
+static WorkQueue_RingType g_WorkQueueRings[WORKQUEUE_COUNT];
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: WorkQueue_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Empties every ring and clears the overflow counters.
+ *********************************************************************/
+void WorkQueue_Init(void)
+{
+    WorkQueue_IdType queue;
+
+    for (queue = 0; queue < WORKQUEUE_COUNT; queue++)
+    {
+        g_WorkQueueRings[queue].head = 0;
+        g_WorkQueueRings[queue].tail = 0;
+        g_WorkQueueRings[queue].overflows = 0;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: WorkQueue_Post
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant (one producer per ring)
+ * Parameters: a_Queue - Ring owned by the caller
+ *             Ptr2Func - Function to be run by WorkQueue_Drain
+ *             a_Argument - Argument passed to the function
+ * Return Value: FALSE if the ring is full (the item is dropped and counted)
+ * Description: Wait-free: a few loads and stores and no interrupt masking,
+ * callable from any interrupt handler.
+ *********************************************************************/
+boolean WorkQueue_Post(WorkQueue_IdType a_Queue, WorkQueue_FunctionType Ptr2Func, void *a_Argument)
+{
+    WorkQueue_RingType *ring;
+    uint32 head;
+
+    if (a_Queue >= WORKQUEUE_COUNT)
+    {
+        return FALSE;
+    }
+
+    ring = &g_WorkQueueRings[a_Queue];
+    head = ring->head;
+    if ((head - ring->tail) >= WORKQUEUE_CAPACITY)
+    {
+        ring->overflows++;
+        return FALSE;
+    }
+
+    ring->items[head & WORKQUEUE_INDEX_MASK].function = Ptr2Func;
+    ring->items[head & WORKQUEUE_INDEX_MASK].argument = a_Argument;
+    ring->head = head + 1; // Publish the item to the consumer
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: WorkQueue_Drain
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant (single consumer)
+ * Parameters: a_MaxItems - Most items run per ring in this call
+ * Return Value: Number of items run
+ * Description: Runs the posted items of every ring, oldest first, up to
+ * a_MaxItems per ring so a busy producer cannot starve the main loop.
+ * Called from the main loop.
+ *********************************************************************/
+uint32 WorkQueue_Drain(uint32 a_MaxItems)
+{
+    WorkQueue_RingType *ring;
+    WorkQueue_FunctionType function;
+    void *argument;
+    WorkQueue_IdType queue;
+    uint32 tail;
+    uint32 head;
+    uint32 done = 0;
+    uint32 batch;
+
+    for (queue = 0; queue < WORKQUEUE_COUNT; queue++)
+    {
+        ring = &g_WorkQueueRings[queue];
+        tail = ring->tail;
+        head = ring->head; // Items posted after this read wait for the next call
+
+        for (batch = 0; (batch < a_MaxItems) && (tail != head); batch++)
+        {
+            function = ring->items[tail & WORKQUEUE_INDEX_MASK].function;
+            argument = ring->items[tail & WORKQUEUE_INDEX_MASK].argument;
+            tail++;
+            ring->tail = tail; // Free the slot before running the item, it may post again
+
+            if (function != NULL_PTR)
+            {
+                (*function)(argument);
+            }
+            done++;
+        }
+    }
+
+    return done;
+}
+
+
+/**********************************************************************
+ * Service Name: WorkQueue_GetPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Queue - Ring to be checked
+ * Return Value: Number of items waiting in the ring
+ * Description: Returns the fill level of a ring.
+ *********************************************************************/
+uint32 WorkQueue_GetPending(WorkQueue_IdType a_Queue)
+{
+    if (a_Queue >= WORKQUEUE_COUNT)
+    {
+        return 0;
+    }
+    return g_WorkQueueRings[a_Queue].head - g_WorkQueueRings[a_Queue].tail;
+}
+
+
+/**********************************************************************
+ * Service Name: WorkQueue_GetOverflowCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Queue - Ring to be checked
+ * Return Value: Number of items dropped because the ring was full
+ * Description: Returns the overflow counter of a ring.
+ *********************************************************************/
+uint32 WorkQueue_GetOverflowCount(WorkQueue_IdType a_Queue)
+{
+    if (a_Queue >= WORKQUEUE_COUNT)
+    {
+        return 0;
+    }
+    return g_WorkQueueRings[a_Queue].overflows;
+}
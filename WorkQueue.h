@@ -0,0 +1,108 @@
+/******************************************************************************
+ *
+ * Module: WorkQueue
+ *
+ * File Name: WorkQueue.h
+ *
+ * Description: Header file for the deferred work queues. Interrupt handlers
+ *              post {function, argument} items into lock-free single
+ *              producer / single consumer rings and the main loop runs them
+ *              later in batches, outside of the interrupt priority.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef WORKQUEUE_H_
+#define WORKQUEUE_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+/* Number of rings: each ring has a single producer, give one to every
+ * interrupt priority level that posts work */
+#ifndef WORKQUEUE_COUNT
+#define WORKQUEUE_COUNT                      2
+#endif
+
+/* Items per ring, must be a power of two */
+#ifndef WORKQUEUE_CAPACITY
+#define WORKQUEUE_CAPACITY                   16
+#endif
+
+/* Ring fed by SysTick_Handler with the deferred SysTick callback */
+#define WORKQUEUE_SYSTICK_QUEUE              0
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef uint8 WorkQueue_IdType;
+
+typedef void (*WorkQueue_FunctionType)(void *a_Argument);
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: WorkQueue_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Empties every ring and clears the overflow counters.
+ *********************************************************************/
+void WorkQueue_Init(void);
+
+/**********************************************************************
+ * Service Name: WorkQueue_Post
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant (one producer per ring)
+ * Parameters: a_Queue - Ring owned by the caller
+ *             Ptr2Func - Function to be run by WorkQueue_Drain
+ *             a_Argument - Argument passed to the function
+ * Return Value: FALSE if the ring is full (the item is dropped and counted)
+ * Description: Wait-free: a few loads and stores and no interrupt masking,
+ * callable from any interrupt handler.
+ *********************************************************************/
+boolean WorkQueue_Post(WorkQueue_IdType a_Queue, WorkQueue_FunctionType Ptr2Func, void *a_Argument);
+
+/**********************************************************************
+ * Service Name: WorkQueue_Drain
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant (single consumer)
+ * Parameters: a_MaxItems - Most items run per ring in this call
+ * Return Value: Number of items run
+ * Description: Runs the posted items of every ring, oldest first, up to
+ * a_MaxItems per ring so a busy producer cannot starve the main loop.
+ * Called from the main loop.
+ *********************************************************************/
+uint32 WorkQueue_Drain(uint32 a_MaxItems);
+
+/**********************************************************************
+ * Service Name: WorkQueue_GetPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Queue - Ring to be checked
+ * Return Value: Number of items waiting in the ring
+ * Description: Returns the fill level of a ring.
+ *********************************************************************/
+uint32 WorkQueue_GetPending(WorkQueue_IdType a_Queue);
+
+/**********************************************************************
+ * Service Name: WorkQueue_GetOverflowCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Queue - Ring to be checked
+ * Return Value: Number of items dropped because the ring was full
+ * Description: Returns the overflow counter of a ring.
+ *********************************************************************/
+uint32 WorkQueue_GetOverflowCount(WorkQueue_IdType a_Queue);
+
+#endif /* WORKQUEUE_H_ */
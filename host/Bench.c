@@ -0,0 +1,755 @@
+/******************************************************************************
+ *
+ * Module: Bench
+ *
+ * File Name: Bench.c
+ *
+ * Description: Source file for the host-side cost benchmark of the driver
+ *              APIs.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Bench.h"
+#include "RegSim.h"
+#include "NVIC.h"
+#include "SysTick.h"
+#include "SwTimer.h"
+
+/* IRQs and exception used by the suite */
+#define BENCH_IRQ                            5
+#define BENCH_IRQ_HIGH                       100
+
+typedef struct
+{
+    const char *name;
+    Bench_FunctionType function;
+} Bench_CaseType;
+
+/* Saved by the SaveContext cases, written back by the RestoreContext ones */
+static NVIC_ContextType g_BenchNvicContext;
+static SysTick_ContextType g_BenchSysTickContext;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void Bench_Handler(void)
+{
+}
+
+static void Bench_CallBack(void)
+{
+}
+
+static void Bench_Deferred(void *a_Argument)
+{
+    (void)a_Argument;
+}
+
+/* One call of each API, with representative arguments */
+static void Bench_NvicEnableIRQ(void)
+{
+    NVIC_EnableIRQ(BENCH_IRQ);
+}
+
+static void Bench_NvicDisableIRQ(void)
+{
+    NVIC_DisableIRQ(BENCH_IRQ);
+}
+
+static void Bench_NvicEnableIRQMask(void)
+{
+    NVIC_IRQMaskType mask = {{0, 0, 0, 0}};
+
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ);
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ_HIGH);
+    NVIC_EnableIRQMask(&mask);
+}
+
+static void Bench_NvicDisableIRQMask(void)
+{
+    NVIC_IRQMaskType mask = {{0, 0, 0, 0}};
+
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ);
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ_HIGH);
+    NVIC_DisableIRQMask(&mask);
+}
+
+static void Bench_NvicSetPending(void)
+{
+    NVIC_SetPending(BENCH_IRQ);
+}
+
+static void Bench_NvicClearPending(void)
+{
+    NVIC_ClearPending(BENCH_IRQ);
+}
+
+static void Bench_NvicIsPending(void)
+{
+    (void)NVIC_IsPending(BENCH_IRQ);
+}
+
+static void Bench_NvicIsActive(void)
+{
+    (void)NVIC_IsActive(BENCH_IRQ);
+}
+
+static void Bench_NvicTriggerSoftware(void)
+{
+    NVIC_TriggerSoftware(BENCH_IRQ);
+}
+
+static void Bench_NvicSetPendingMask(void)
+{
+    NVIC_IRQMaskType mask = {{0, 0, 0, 0}};
+
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ);
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ_HIGH);
+    NVIC_SetPendingMask(&mask);
+}
+
+static void Bench_NvicClearPendingMask(void)
+{
+    NVIC_IRQMaskType mask = {{0, 0, 0, 0}};
+
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ);
+    NVIC_IRQ_MASK_ADD(mask, BENCH_IRQ_HIGH);
+    NVIC_ClearPendingMask(&mask);
+}
+
+static void Bench_NvicGetPendingMask(void)
+{
+    NVIC_IRQMaskType mask;
+
+    NVIC_GetPendingMask(&mask);
+}
+
+static void Bench_NvicGetActiveMask(void)
+{
+    NVIC_IRQMaskType mask;
+
+    NVIC_GetActiveMask(&mask);
+}
+
+static void Bench_NvicSetPriorityIRQ(void)
+{
+    NVIC_SetPriorityIRQ(BENCH_IRQ, 3);
+}
+
+static void Bench_NvicSetPriorityIRQTable(void)
+{
+    static const NVIC_IRQPriorityConfigType s_Table[] = {{4, 1}, {5, 2}, {6, 3}, {7, 4}, {BENCH_IRQ_HIGH, 5}};
+
+    NVIC_SetPriorityIRQTable(s_Table, sizeof(s_Table) / sizeof(s_Table[0]));
+}
+
+static void Bench_NvicWritePriorityWords(void)
+{
+    static const NVIC_PriorityWordType s_Words[] = {{1, NVIC_PRI_WORD(1, 2, 3, 4)}, {25, NVIC_PRI_WORD(5, 5, 5, 5)}};
+
+    NVIC_WritePriorityWords(s_Words, sizeof(s_Words) / sizeof(s_Words[0]));
+}
+
+static void Bench_NvicEnableException(void)
+{
+    NVIC_EnableException(EXCEPTION_USAGE_FAULT_TYPE);
+}
+
+static void Bench_NvicDisableException(void)
+{
+    NVIC_DisableException(EXCEPTION_USAGE_FAULT_TYPE);
+}
+
+static void Bench_NvicSetPriorityException(void)
+{
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 2);
+}
+
+static void Bench_NvicSetPriorityExceptionTable(void)
+{
+    static const NVIC_ExceptionPriorityConfigType s_Table[] = {{EXCEPTION_SVC_TYPE, 6}, {EXCEPTION_PEND_SV_TYPE, 7},
+                                                               {EXCEPTION_SYSTICK_TYPE, 2}};
+
+    NVIC_SetPriorityExceptionTable(s_Table, sizeof(s_Table) / sizeof(s_Table[0]));
+}
+
+static void Bench_NvicSetPriorityGrouping(void)
+{
+    NVIC_SetPriorityGrouping(NVIC_PRIORITY_GROUP_3_0);
+}
+
+static void Bench_NvicGetPriorityGrouping(void)
+{
+    (void)NVIC_GetPriorityGrouping();
+}
+
+static void Bench_NvicEncodePriority(void)
+{
+    (void)NVIC_EncodePriority(NVIC_PRIORITY_GROUP_2_1, 2, 1);
+}
+
+static void Bench_NvicDecodePriority(void)
+{
+    uint8 preempt;
+    uint8 sub;
+
+    NVIC_DecodePriority(5, NVIC_PRIORITY_GROUP_2_1, &preempt, &sub);
+}
+
+static void Bench_NvicGetPriorityIRQ(void)
+{
+    (void)NVIC_GetPriorityIRQ(BENCH_IRQ);
+}
+
+static void Bench_NvicGetPriorityException(void)
+{
+    (void)NVIC_GetPriorityException(EXCEPTION_SYSTICK_TYPE);
+}
+
+static void Bench_NvicIsIRQEnabled(void)
+{
+    (void)NVIC_IsIRQEnabled(BENCH_IRQ);
+}
+
+#if NVIC_SHADOW_ENABLE
+static void Bench_NvicShadowResync(void)
+{
+    NVIC_ShadowResync();
+}
+
+static void Bench_NvicShadowVerify(void)
+{
+    (void)NVIC_ShadowVerify();
+}
+#endif
+
+static void Bench_NvicSaveContext(void)
+{
+    NVIC_SaveContext(&g_BenchNvicContext);
+}
+
+static void Bench_NvicRestoreContext(void)
+{
+    (void)NVIC_RestoreContext(&g_BenchNvicContext);
+}
+
+static void Bench_NvicRelocateVectorTable(void)
+{
+    NVIC_RelocateVectorTable();
+}
+
+static void Bench_NvicIsVectorTableRelocated(void)
+{
+    (void)NVIC_IsVectorTableRelocated();
+}
+
+static void Bench_NvicRegisterHandler(void)
+{
+    (void)NVIC_RegisterHandler(BENCH_IRQ, Bench_Handler);
+}
+
+static void Bench_NvicRegisterExceptionHandler(void)
+{
+    (void)NVIC_RegisterExceptionHandler(EXCEPTION_PEND_SV_TYPE, Bench_Handler);
+}
+
+static void Bench_NvicCritical(void)
+{
+    NVIC_ExitCritical(NVIC_EnterCritical(3));
+}
+
+static void Bench_NvicIsExceptionMasked(void)
+{
+    (void)NVIC_IsExceptionMasked(EXCEPTION_SYSTICK_TYPE);
+}
+
+static void Bench_SysTickSetCoreClock(void)
+{
+    (void)SysTick_SetCoreClock(16000000UL);
+}
+
+static void Bench_SysTickInstallHandler(void)
+{
+    SysTick_InstallHandler();
+}
+
+static void Bench_SysTickInit(void)
+{
+    SysTick_Init(1);
+}
+
+static void Bench_SysTickInitCycles(void)
+{
+    SysTick_InitCycles(16000);
+}
+
+static void Bench_SysTickInitFractional(void)
+{
+    (void)SysTick_InitFractional(1, 3000);
+}
+
+static void Bench_SysTickSetTrim(void)
+{
+    SysTick_SetTrim(2500);
+}
+
+static void Bench_SysTickInitTickless(void)
+{
+    SysTick_InitTickless(1);
+}
+
+static void Bench_SysTickStartBusyWait(void)
+{
+    SysTick_StartBusyWait(1);
+}
+
+static void Bench_SysTickDelayCycles(void)
+{
+    SysTick_DelayCycles(1000);
+}
+
+static void Bench_SysTickDelayUs(void)
+{
+    SysTick_DelayUs(10);
+}
+
+static void Bench_SysTickDelayMs(void)
+{
+    SysTick_DelayMs(1);
+}
+
+static void Bench_SysTickSleepUs(void)
+{
+    SysTick_SleepUs(100);
+}
+
+static void Bench_SysTickSleepMs(void)
+{
+    SysTick_SleepMs(2);
+}
+
+static void Bench_SysTickHandler(void)
+{
+    SysTick_Handler();
+}
+
+static void Bench_SysTickSetCallBack(void)
+{
+    SysTick_SetCallBack(Bench_CallBack);
+}
+
+static void Bench_SysTickSetDeferredCallBack(void)
+{
+    SysTick_SetDeferredCallBack(Bench_Deferred, NULL_PTR);
+}
+
+static void Bench_SysTickStop(void)
+{
+    SysTick_Stop();
+}
+
+static void Bench_SysTickStart(void)
+{
+    SysTick_Start();
+}
+
+static void Bench_SysTickDeInit(void)
+{
+    SysTick_DeInit();
+}
+
+static void Bench_SysTickSaveContext(void)
+{
+    SysTick_SaveContext(&g_BenchSysTickContext);
+}
+
+static void Bench_SysTickRestoreContext(void)
+{
+    (void)SysTick_RestoreContext(&g_BenchSysTickContext);
+}
+
+static void Bench_SysTickReschedule(void)
+{
+    SysTick_Reschedule();
+}
+
+static void Bench_SysTickGetUnannouncedTicks(void)
+{
+    (void)SysTick_GetUnannouncedTicks();
+}
+
+static void Bench_SysTickGetTicks(void)
+{
+    (void)SysTick_GetTicks();
+}
+
+static void Bench_SysTickGetMicros(void)
+{
+    (void)SysTick_GetMicros();
+}
+
+/*
+ * The suite, in run order: each case leaves the state the next ones need
+ * (periodic SysTick for the delays and time stamps, tickless mode for the
+ * tickless services, busy wait last as it stops SysTick).
+ */
+static const Bench_CaseType g_BenchCases[] =
+{
+    {"NVIC_EnableIRQ", Bench_NvicEnableIRQ},
+    {"NVIC_DisableIRQ", Bench_NvicDisableIRQ},
+    {"NVIC_EnableIRQMask", Bench_NvicEnableIRQMask},
+    {"NVIC_DisableIRQMask", Bench_NvicDisableIRQMask},
+    {"NVIC_SetPending", Bench_NvicSetPending},
+    {"NVIC_ClearPending", Bench_NvicClearPending},
+    {"NVIC_IsPending", Bench_NvicIsPending},
+    {"NVIC_IsActive", Bench_NvicIsActive},
+    {"NVIC_TriggerSoftware", Bench_NvicTriggerSoftware},
+    {"NVIC_SetPendingMask", Bench_NvicSetPendingMask},
+    {"NVIC_ClearPendingMask", Bench_NvicClearPendingMask},
+    {"NVIC_GetPendingMask", Bench_NvicGetPendingMask},
+    {"NVIC_GetActiveMask", Bench_NvicGetActiveMask},
+    {"NVIC_SetPriorityIRQ", Bench_NvicSetPriorityIRQ},
+    {"NVIC_SetPriorityIRQTable", Bench_NvicSetPriorityIRQTable},
+    {"NVIC_WritePriorityWords", Bench_NvicWritePriorityWords},
+    {"NVIC_EnableException", Bench_NvicEnableException},
+    {"NVIC_DisableException", Bench_NvicDisableException},
+    {"NVIC_SetPriorityException", Bench_NvicSetPriorityException},
+    {"NVIC_SetPriorityExceptionTable", Bench_NvicSetPriorityExceptionTable},
+    {"NVIC_SetPriorityGrouping", Bench_NvicSetPriorityGrouping},
+    {"NVIC_GetPriorityGrouping", Bench_NvicGetPriorityGrouping},
+    {"NVIC_EncodePriority", Bench_NvicEncodePriority},
+    {"NVIC_DecodePriority", Bench_NvicDecodePriority},
+    {"NVIC_GetPriorityIRQ", Bench_NvicGetPriorityIRQ},
+    {"NVIC_GetPriorityException", Bench_NvicGetPriorityException},
+    {"NVIC_IsIRQEnabled", Bench_NvicIsIRQEnabled},
+#if NVIC_SHADOW_ENABLE
+    {"NVIC_ShadowResync", Bench_NvicShadowResync},
+    {"NVIC_ShadowVerify", Bench_NvicShadowVerify},
+#endif
+    {"NVIC_SaveContext", Bench_NvicSaveContext},
+    {"NVIC_RestoreContext", Bench_NvicRestoreContext},
+    {"NVIC_RelocateVectorTable", Bench_NvicRelocateVectorTable},
+    {"NVIC_IsVectorTableRelocated", Bench_NvicIsVectorTableRelocated},
+    {"NVIC_RegisterHandler", Bench_NvicRegisterHandler},
+    {"NVIC_RegisterExceptionHandler", Bench_NvicRegisterExceptionHandler},
+    {"NVIC_EnterCritical+ExitCritical", Bench_NvicCritical},
+    {"NVIC_IsExceptionMasked", Bench_NvicIsExceptionMasked},
+    {"SysTick_SetCoreClock", Bench_SysTickSetCoreClock},
+    {"SysTick_InstallHandler", Bench_SysTickInstallHandler},
+    {"SysTick_InitCycles", Bench_SysTickInitCycles},
+    {"SysTick_Init", Bench_SysTickInit},
+    {"SysTick_SetCallBack", Bench_SysTickSetCallBack},
+    {"SysTick_SetDeferredCallBack", Bench_SysTickSetDeferredCallBack},
+    {"SysTick_Handler", Bench_SysTickHandler},
+    {"SysTick_GetTicks", Bench_SysTickGetTicks},
+    {"SysTick_GetMicros", Bench_SysTickGetMicros},
+    {"SysTick_DelayCycles", Bench_SysTickDelayCycles},
+    {"SysTick_DelayUs", Bench_SysTickDelayUs},
+    {"SysTick_DelayMs", Bench_SysTickDelayMs},
+    {"SysTick_SleepUs", Bench_SysTickSleepUs},
+    {"SysTick_SleepMs", Bench_SysTickSleepMs},
+    {"SysTick_Stop", Bench_SysTickStop},
+    {"SysTick_Start", Bench_SysTickStart},
+    {"SysTick_SaveContext", Bench_SysTickSaveContext},
+    {"SysTick_RestoreContext", Bench_SysTickRestoreContext},
+    {"SysTick_InitFractional", Bench_SysTickInitFractional},
+    {"SysTick_SetTrim", Bench_SysTickSetTrim},
+    {"SysTick_InitTickless", Bench_SysTickInitTickless},
+    {"SysTick_Reschedule", Bench_SysTickReschedule},
+    {"SysTick_GetUnannouncedTicks", Bench_SysTickGetUnannouncedTicks},
+    {"SysTick_DeInit", Bench_SysTickDeInit},
+    {"SysTick_StartBusyWait", Bench_SysTickStartBusyWait},
+};
+
+static uint32 g_BenchExpiries = 0;
+
+static void Bench_CountExpiry(void *a_Context)
+{
+    (void)a_Context;
+    g_BenchExpiries++;
+}
+
+/* Runs the timers for a_Ticks ticks on a fresh SysTick, returns the interrupts taken */
+static uint32 Bench_RunTimers(boolean a_Tickless, const uint32 *a_Intervals, uint8 a_Timers, uint32 a_Ticks,
+                              uint32 *a_Expiries)
+{
+    SwTimer_IdType ids[SWTIMER_MAX_TIMERS];
+    uint32 isrs;
+    uint8 index;
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SwTimer_Init();
+
+    //Armed before SysTick starts, so that both modes see the same deadlines
+    for (index = 0; (index < a_Timers) && (index < SWTIMER_MAX_TIMERS); index++)
+    {
+        ids[index] = SwTimer_Create(Bench_CountExpiry, NULL_PTR);
+        (void)SwTimer_Start(ids[index], a_Intervals[index], SWTIMER_PERIODIC);
+    }
+
+    if (a_Tickless)
+    {
+        SysTick_InitTickless(1);
+    }
+    else
+    {
+        SysTick_Init(1);
+    }
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+
+    g_BenchExpiries = 0;
+    isrs = RegSim_GetSysTickIsrCount();
+    RegSim_SysTickAdvance(a_Ticks * BENCH_TICK_CYCLES);
+    isrs = RegSim_GetSysTickIsrCount() - isrs;
+    *a_Expiries = g_BenchExpiries;
+
+    while (index > 0)
+    {
+        index--;
+        SwTimer_Delete(ids[index]);
+    }
+    SysTick_DeInit();
+
+    return isrs;
+}
+
+static const Bench_ResultType *Bench_Find(const Bench_ResultType *a_Results, uint8 a_Count, const char *a_Name)
+{
+    uint8 index;
+
+    for (index = 0; index < a_Count; index++)
+    {
+        if (strcmp(a_Results[index].name, a_Name) == 0)
+        {
+            return &a_Results[index];
+        }
+    }
+    return NULL_PTR;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: Bench_Measure
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Name - Name of the measured call
+ *             Ptr2Func - Function making the call
+ *             a_Result - Filled with the name, the access counts and the access cycles
+ * Return Value: None
+ * Description: Runs Ptr2Func once to warm up (first call work such as the
+ * vector table copy), then once more with cleared counters, and records
+ * the register accesses and the simulated cycles (DWT_CYCCNT) of the
+ * second run. Only the accesses and the waits move the simulated counter,
+ * so these are BENCH_CYCLES_PER_ACCESS per access plus the cycles spun or
+ * slept in WFI, not instruction cycles.
+ *********************************************************************/
+void Bench_Measure(const char *a_Name, Bench_FunctionType Ptr2Func, Bench_ResultType *a_Result)
+{
+    uint32 start;
+
+    (*Ptr2Func)();
+
+    RegSim_ClearCounters();
+    start = RegSim_Peek(REGSIM_DWT_CYCCNT);
+    (*Ptr2Func)();
+    a_Result->accessCycles = RegSim_Peek(REGSIM_DWT_CYCCNT) - start;
+    a_Result->reads = RegSim_GetTotalReads();
+    a_Result->writes = RegSim_GetTotalWrites();
+
+    strncpy(a_Result->name, a_Name, BENCH_NAME_LENGTH - 1);
+    a_Result->name[BENCH_NAME_LENGTH - 1] = '\0';
+}
+
+
+/**********************************************************************
+ * Service Name: Bench_RunDrivers
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Results - Filled with one result per API
+ *             a_Max - Size of a_Results
+ * Return Value: Number of results filled
+ * Description: Resets the simulated registers and measures every public
+ * function of NVIC.h and SysTick.h with representative arguments.
+ *********************************************************************/
+uint8 Bench_RunDrivers(Bench_ResultType *a_Results, uint8 a_Max)
+{
+    uint8 count = 0;
+
+    RegSim_Reset();
+    RegSim_SetCyclesPerAccess(BENCH_CYCLES_PER_ACCESS);
+    RegSim_Poke(REGSIM_CORE_DEMCR, REGSIM_DEMCR_TRCENA); // Simulated cycle counter on
+    RegSim_Poke(REGSIM_DWT_CTRL, REGSIM_DWT_CTRL_CYCCNTENA);
+
+    while ((count < a_Max) && (count < (sizeof(g_BenchCases) / sizeof(g_BenchCases[0]))))
+    {
+        Bench_Measure(g_BenchCases[count].name, g_BenchCases[count].function, &a_Results[count]);
+        count++;
+    }
+
+    RegSim_SetCyclesPerAccess(0);
+
+    return count;
+}
+
+
+/**********************************************************************
+ * Service Name: Bench_WriteJson
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Path - File to be written
+ *             a_Results - Results to be saved
+ *             a_Count - Number of results
+ * Return Value: FALSE if the file cannot be written
+ * Description: Saves the results as a JSON object, one API per line:
+ * "name": {"reads": r, "writes": w, "accessCycles": c}.
+ *********************************************************************/
+boolean Bench_WriteJson(const char *a_Path, const Bench_ResultType *a_Results, uint8 a_Count)
+{
+    FILE *file = fopen(a_Path, "w");
+    uint8 index;
+
+    if (file == NULL_PTR)
+    {
+        return FALSE;
+    }
+
+    fprintf(file, "{\n");
+    for (index = 0; index < a_Count; index++)
+    {
+        fprintf(file, "  \"%s\": {\"reads\": %lu, \"writes\": %lu, \"accessCycles\": %lu}%s\n",
+                a_Results[index].name, (unsigned long)a_Results[index].reads,
+                (unsigned long)a_Results[index].writes, (unsigned long)a_Results[index].accessCycles,
+                (index + 1 < a_Count) ? "," : "");
+    }
+    fprintf(file, "}\n");
+
+    return (fclose(file) == 0) ? TRUE : FALSE;
+}
+
+
+/**********************************************************************
+ * Service Name: Bench_ReadJson
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Path - File written by Bench_WriteJson
+ *             a_Results - Filled with the saved results
+ *             a_Max - Size of a_Results
+ * Return Value: Number of results read (0 if the file cannot be read)
+ * Description: Loads a baseline saved by Bench_WriteJson. The key
+ * "cycles" of older baselines is read as accessCycles; entries without
+ * either load with 0 access cycles, which are not compared.
+ *********************************************************************/
+uint8 Bench_ReadJson(const char *a_Path, Bench_ResultType *a_Results, uint8 a_Max)
+{
+    FILE *file = fopen(a_Path, "r");
+    char line[128];
+    unsigned long reads;
+    unsigned long writes;
+    unsigned long cycles;
+    int fields;
+    uint8 count = 0;
+
+    if (file == NULL_PTR)
+    {
+        return 0;
+    }
+
+    while ((count < a_Max) && (fgets(line, sizeof(line), file) != NULL_PTR))
+    {
+        //Lines other than the API entries ("{" and "}") do not match
+        cycles = 0;
+        fields = sscanf(line, " \"%39[^\"]\": {\"reads\": %lu, \"writes\": %lu, \"accessCycles\": %lu}",
+                        a_Results[count].name, &reads, &writes, &cycles);
+        if (fields == 3)
+        {
+            //Key of the older baselines, or none
+            fields = sscanf(line, " \"%39[^\"]\": {\"reads\": %lu, \"writes\": %lu, \"cycles\": %lu}",
+                            a_Results[count].name, &reads, &writes, &cycles);
+        }
+        if (fields >= 3)
+        {
+            a_Results[count].reads = (uint32)reads;
+            a_Results[count].writes = (uint32)writes;
+            a_Results[count].accessCycles = (uint32)cycles;
+            count++;
+        }
+    }
+    fclose(file);
+
+    return count;
+}
+
+
+/**********************************************************************
+ * Service Name: Bench_Compare
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Baseline - Saved results
+ *             a_BaselineCount - Number of saved results
+ *             a_Results - New results
+ *             a_Count - Number of new results
+ * Return Value: Number of regressions
+ * Description: Reports on stderr each API of the baseline that now does
+ * more register reads or writes, takes more access cycles, or is
+ * missing from the new results. New APIs and cheaper ones are not
+ * regressions.
+ *********************************************************************/
+uint8 Bench_Compare(const Bench_ResultType *a_Baseline, uint8 a_BaselineCount,
+                    const Bench_ResultType *a_Results, uint8 a_Count)
+{
+    const Bench_ResultType *result;
+    uint8 regressions = 0;
+    uint8 index;
+
+    for (index = 0; index < a_BaselineCount; index++)
+    {
+        result = Bench_Find(a_Results, a_Count, a_Baseline[index].name);
+        if (result == NULL_PTR)
+        {
+            fprintf(stderr, "%s: not measured\n", a_Baseline[index].name);
+            regressions++;
+        }
+        else if ((result->reads > a_Baseline[index].reads) || (result->writes > a_Baseline[index].writes) ||
+                 ((a_Baseline[index].accessCycles != 0) && (result->accessCycles > a_Baseline[index].accessCycles)))
+        {
+            fprintf(stderr, "%s: reads %lu -> %lu, writes %lu -> %lu, access cycles %lu -> %lu\n", a_Baseline[index].name,
+                    (unsigned long)a_Baseline[index].reads, (unsigned long)result->reads,
+                    (unsigned long)a_Baseline[index].writes, (unsigned long)result->writes,
+                    (unsigned long)a_Baseline[index].accessCycles, (unsigned long)result->accessCycles);
+            regressions++;
+        }
+    }
+
+    return regressions;
+}
+
+
+/**********************************************************************
+ * Service Name: Bench_CountIsrEntries
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Intervals - Intervals of the periodic software timers, in
+ *             1 ms ticks
+ *             a_Timers - Number of timers
+ *             a_Ticks - Simulated time in 1 ms ticks (at most 268000)
+ *             a_Result - Filled with the interrupt and expiry counts
+ * Return Value: None
+ * Description: Runs the same timers on the periodic and on the tickless
+ * SysTick for the same simulated time and counts the SysTick interrupts
+ * taken in each mode, i.e. the ISR entries tickless mode avoids.
+ *********************************************************************/
+void Bench_CountIsrEntries(const uint32 *a_Intervals, uint8 a_Timers, uint32 a_Ticks, Bench_IsrResultType *a_Result)
+{
+    a_Result->periodicIsrs = Bench_RunTimers(FALSE, a_Intervals, a_Timers, a_Ticks, &a_Result->periodicExpiries);
+    a_Result->ticklessIsrs = Bench_RunTimers(TRUE, a_Intervals, a_Timers, a_Ticks, &a_Result->ticklessExpiries);
+}
@@ -0,0 +1,170 @@
+/******************************************************************************
+ *
+ * Module: Bench
+ *
+ * File Name: Bench.h
+ *
+ * Description: Header file for the host-side cost benchmark of the driver
+ *              APIs. Each public function of NVIC.h and SysTick.h is called
+ *              on the RegSim backend and its register reads and writes are
+ *              counted: on the TM4C123 every such access goes over the
+ *              private peripheral bus and is the main cost of these calls.
+ *              The results are saved as a JSON baseline, and a later run is
+ *              compared with it so that an API doing more register accesses
+ *              than before is reported as a regression.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+#ifndef BENCH_MAX_RESULTS
+#define BENCH_MAX_RESULTS                    64
+#endif
+
+/* Longest API name, with the terminating zero */
+#define BENCH_NAME_LENGTH                    40
+
+/* Simulated core cycles per register access while the suite runs, so that
+ * the SysTick counter moves under the delay loops */
+#ifndef BENCH_CYCLES_PER_ACCESS
+#define BENCH_CYCLES_PER_ACCESS              4
+#endif
+
+/* Tick of the ISR entry comparison: 1 ms at 16MHz */
+#define BENCH_TICK_CYCLES                    16000UL
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef void (*Bench_FunctionType)(void);
+
+typedef struct
+{
+    char name[BENCH_NAME_LENGTH];
+    uint32 reads;        /* Register reads of one call */
+    uint32 writes;       /* Register writes of one call */
+    uint32 accessCycles; /* BENCH_CYCLES_PER_ACCESS per access plus the cycles waited, not instructions */
+} Bench_ResultType;
+
+/* SysTick interrupts taken for the same software timer load in both modes */
+typedef struct
+{
+    uint32 periodicIsrs;      /* With SysTick_Init, one per tick */
+    uint32 ticklessIsrs;      /* With SysTick_InitTickless, one per wake */
+    uint32 periodicExpiries;  /* Timer expiries seen in each mode, equal when */
+    uint32 ticklessExpiries;  /* no deadline is missed */
+} Bench_IsrResultType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************
+ * Service Name: Bench_Measure
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Name - Name of the measured call
+ *             Ptr2Func - Function making the call
+ *             a_Result - Filled with the name, the access counts and the access cycles
+ * Return Value: None
+ * Description: Runs Ptr2Func once to warm up (first call work such as the
+ * vector table copy), then once more with cleared counters, and records
+ * the register accesses and the simulated cycles (DWT_CYCCNT) of the
+ * second run. Only the accesses and the waits move the simulated counter,
+ * so these are BENCH_CYCLES_PER_ACCESS per access plus the cycles spun or
+ * slept in WFI, not instruction cycles.
+ *********************************************************************/
+void Bench_Measure(const char *a_Name, Bench_FunctionType Ptr2Func, Bench_ResultType *a_Result);
+
+/**********************************************************************
+ * Service Name: Bench_RunDrivers
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Results - Filled with one result per API
+ *             a_Max - Size of a_Results
+ * Return Value: Number of results filled
+ * Description: Resets the simulated registers and measures every public
+ * function of NVIC.h and SysTick.h with representative arguments.
+ *********************************************************************/
+uint8 Bench_RunDrivers(Bench_ResultType *a_Results, uint8 a_Max);
+
+/**********************************************************************
+ * Service Name: Bench_WriteJson
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Path - File to be written
+ *             a_Results - Results to be saved
+ *             a_Count - Number of results
+ * Return Value: FALSE if the file cannot be written
+ * Description: Saves the results as a JSON object, one API per line:
+ * "name": {"reads": r, "writes": w, "accessCycles": c}.
+ *********************************************************************/
+boolean Bench_WriteJson(const char *a_Path, const Bench_ResultType *a_Results, uint8 a_Count);
+
+/**********************************************************************
+ * Service Name: Bench_ReadJson
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Path - File written by Bench_WriteJson
+ *             a_Results - Filled with the saved results
+ *             a_Max - Size of a_Results
+ * Return Value: Number of results read (0 if the file cannot be read)
+ * Description: Loads a baseline saved by Bench_WriteJson. The key
+ * "cycles" of older baselines is read as accessCycles; entries without
+ * either load with 0 access cycles, which are not compared.
+ *********************************************************************/
+uint8 Bench_ReadJson(const char *a_Path, Bench_ResultType *a_Results, uint8 a_Max);
+
+/**********************************************************************
+ * Service Name: Bench_Compare
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Baseline - Saved results
+ *             a_BaselineCount - Number of saved results
+ *             a_Results - New results
+ *             a_Count - Number of new results
+ * Return Value: Number of regressions
+ * Description: Reports on stderr each API of the baseline that now does
+ * more register reads or writes, takes more access cycles, or is
+ * missing from the new results. New APIs and cheaper ones are not
+ * regressions.
+ *********************************************************************/
+uint8 Bench_Compare(const Bench_ResultType *a_Baseline, uint8 a_BaselineCount,
+                    const Bench_ResultType *a_Results, uint8 a_Count);
+
+/**********************************************************************
+ * Service Name: Bench_CountIsrEntries
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Intervals - Intervals of the periodic software timers, in
+ *             1 ms ticks
+ *             a_Timers - Number of timers
+ *             a_Ticks - Simulated time in 1 ms ticks (at most 268000)
+ *             a_Result - Filled with the interrupt and expiry counts
+ * Return Value: None
+ * Description: Runs the same timers on the periodic and on the tickless
+ * SysTick for the same simulated time and counts the SysTick interrupts
+ * taken in each mode, i.e. the ISR entries tickless mode avoids.
+ *********************************************************************/
+void Bench_CountIsrEntries(const uint32 *a_Intervals, uint8 a_Timers, uint32 a_Ticks, Bench_IsrResultType *a_Result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,534 @@
+/******************************************************************************
+ *
+ * Module: NvicSim
+ *
+ * File Name: NvicSim.c
+ *
+ * Description: Source file for the host-side NVIC arbitration simulator.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "NvicSim.h"
+#include "RegSim.h"
+
+/* Execution priority of thread mode, below every group priority */
+#define NVICSIM_THREAD_PRIORITY              0x100
+
+#define NVICSIM_NO_SOURCE                    0xFF
+#define NVICSIM_NO_EVENT                     0xFFFFFFFFFFFFFFFFULL
+
+typedef enum
+{
+    NVICSIM_PHASE_RUN,          /* Top of the active stack (or thread mode) runs */
+    NVICSIM_PHASE_ENTRY,        /* Stacking, the vector is chosen at the end (late arrival) */
+    NVICSIM_PHASE_TAILCHAIN,    /* From one handler to the next without unstacking */
+    NVICSIM_PHASE_EXIT          /* Unstacking to the preempted context */
+} NvicSim_PhaseType;
+
+typedef struct
+{
+    NvicSim_SourceConfigType config;
+    uint8 priority;             /* Resolved 3-bit priority */
+    uint64 nominal;             /* Request time before jitter */
+    uint64 nextArrival;         /* NVICSIM_NO_EVENT when no request is left */
+    boolean pending;
+    uint64 pendingSince;
+    uint64 activeSince;         /* Request time of the running instance */
+    uint32 remaining;           /* Cycles left to the running instance */
+    uint64 responseSum;
+    NvicSim_SummaryType summary;
+} NvicSim_SourceType;
+
+static NvicSim_SourceType g_NvicSimSources[NVICSIM_MAX_SOURCES];
+static uint8 g_NvicSimCount = 0;
+static uint8 g_NvicSimSubBits = 0;
+static uint32 g_NvicSimRandom = 1;
+
+static uint64 g_NvicSimTime = 0;
+static NvicSim_PhaseType g_NvicSimPhase = NVICSIM_PHASE_RUN;
+static uint64 g_NvicSimPhaseEnd = 0;
+
+/* Active handlers, the last one is running */
+static uint8 g_NvicSimStack[NVICSIM_MAX_SOURCES];
+static uint8 g_NvicSimDepth = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Deterministic jitter (linear congruential generator) */
+static uint32 NvicSim_Random(uint32 a_Range)
+{
+    g_NvicSimRandom = (g_NvicSimRandom * 1103515245UL) + 12345UL;
+    return (a_Range == 0) ? 0 : (uint32)((g_NvicSimRandom >> 8) % (a_Range + 1));
+}
+
+/* Priority byte of a vector in the simulated NVIC PRIn / SYSPRIn registers */
+static uint8 NvicSim_RegisterPriority(uint8 a_Vector)
+{
+    uint32 word;
+    uint8 byteIndex;
+
+    if (a_Vector >= 16)
+    {
+        word = RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + ((a_Vector - 16) >> 2)));
+        byteIndex = (a_Vector - 16) & 3;
+    }
+    else if (a_Vector >= 4)
+    {
+        word = RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_SYSTEM_PRI1 + ((a_Vector - 4) >> 2)));
+        byteIndex = (a_Vector - 4) & 3;
+    }
+    else
+    {
+        return 0; // Fixed negative priorities, taken as the highest one
+    }
+
+    return (uint8)((word >> ((8 * byteIndex) + 5)) & 0x7);
+}
+
+static uint32 NvicSim_Group(uint8 a_Source)
+{
+    return g_NvicSimSources[a_Source].priority >> g_NvicSimSubBits;
+}
+
+/* Arbitration order of the pending sources: priority, then vector number */
+static boolean NvicSim_GoesFirst(uint8 a_Source, uint8 a_Other)
+{
+    NvicSim_SourceType *source = &g_NvicSimSources[a_Source];
+    NvicSim_SourceType *other = &g_NvicSimSources[a_Other];
+
+    return (source->priority < other->priority) ||
+           ((source->priority == other->priority) && (source->config.vector < other->config.vector));
+}
+
+/* Group priority of the running context */
+static uint32 NvicSim_ContextPriority(void)
+{
+    return (g_NvicSimDepth == 0) ? NVICSIM_THREAD_PRIORITY : NvicSim_Group(g_NvicSimStack[g_NvicSimDepth - 1]);
+}
+
+/* Highest pending source able to preempt the running context */
+static uint8 NvicSim_SelectPending(void)
+{
+    uint32 context = NvicSim_ContextPriority();
+    uint8 best = NVICSIM_NO_SOURCE;
+    uint8 index;
+
+    for (index = 0; index < g_NvicSimCount; index++)
+    {
+        if (g_NvicSimSources[index].pending && (NvicSim_Group(index) < context) &&
+            ((best == NVICSIM_NO_SOURCE) || NvicSim_GoesFirst(index, best)))
+        {
+            best = index;
+        }
+    }
+
+    return best;
+}
+
+static void NvicSim_ScheduleArrival(NvicSim_SourceType *a_Source, boolean a_First)
+{
+    uint64 previous = a_Source->nextArrival;
+    uint64 arrival;
+
+    if (a_First)
+    {
+        a_Source->nominal = a_Source->config.offset;
+    }
+    else if (a_Source->config.period == 0)
+    {
+        a_Source->nextArrival = NVICSIM_NO_EVENT; // Single request
+        return;
+    }
+    else
+    {
+        a_Source->nominal += a_Source->config.period;
+    }
+
+    arrival = a_Source->nominal + NvicSim_Random(a_Source->config.jitter);
+    a_Source->nextArrival = (!a_First && (arrival < previous)) ? previous : arrival; // Jitter above the period
+}
+
+static void NvicSim_Record(NvicSim_SourceType *a_Source, uint32 a_Response)
+{
+    NvicSim_SummaryType *summary = &a_Source->summary;
+    uint32 deadline = (a_Source->config.deadline != 0) ? a_Source->config.deadline : a_Source->config.period;
+    uint8 bin = 0;
+    uint32 value = a_Response;
+
+    summary->completed++;
+    a_Source->responseSum += a_Response;
+    if (a_Response < summary->responseMin)
+    {
+        summary->responseMin = a_Response;
+    }
+    if (a_Response > summary->responseMax)
+    {
+        summary->responseMax = a_Response;
+    }
+    if ((deadline != 0) && (a_Response > deadline))
+    {
+        summary->misses++;
+    }
+
+    while ((value != 0) && (bin < (NVICSIM_HISTOGRAM_BINS - 1)))
+    {
+        value >>= 1;
+        bin++;
+    }
+    summary->histogram[bin]++;
+}
+
+/* Stacking or tail-chaining done: the best pending source becomes active */
+static void NvicSim_Activate(void)
+{
+    uint8 index = NvicSim_SelectPending();
+    NvicSim_SourceType *source;
+    uint32 latency;
+
+    g_NvicSimPhase = NVICSIM_PHASE_RUN;
+    if (index == NVICSIM_NO_SOURCE)
+    {
+        return;
+    }
+
+    source = &g_NvicSimSources[index];
+    source->pending = FALSE;
+    source->activeSince = source->pendingSince;
+    source->remaining = source->config.cost;
+    latency = (uint32)(g_NvicSimTime - source->pendingSince);
+    if (latency < source->summary.latencyMin)
+    {
+        source->summary.latencyMin = latency;
+    }
+    if (latency > source->summary.latencyMax)
+    {
+        source->summary.latencyMax = latency;
+    }
+
+    if (g_NvicSimDepth != 0)
+    {
+        g_NvicSimSources[g_NvicSimStack[g_NvicSimDepth - 1]].summary.preemptions++;
+    }
+    g_NvicSimStack[g_NvicSimDepth++] = index;
+}
+
+/* The running handler returns: tail-chain to a pending source or unstack */
+static void NvicSim_Complete(void)
+{
+    NvicSim_SourceType *source = &g_NvicSimSources[g_NvicSimStack[--g_NvicSimDepth]];
+
+    NvicSim_Record(source, (uint32)(g_NvicSimTime - source->activeSince));
+
+    if (NvicSim_SelectPending() != NVICSIM_NO_SOURCE)
+    {
+        g_NvicSimPhase = NVICSIM_PHASE_TAILCHAIN;
+        g_NvicSimPhaseEnd = g_NvicSimTime + NVICSIM_TAILCHAIN_CYCLES;
+    }
+    else
+    {
+        g_NvicSimPhase = NVICSIM_PHASE_EXIT;
+        g_NvicSimPhaseEnd = g_NvicSimTime + NVICSIM_EXIT_CYCLES;
+    }
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: NvicSim_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Sources - Interrupt sources (copied)
+ *             a_Count - Number of sources (at most NVICSIM_MAX_SOURCES)
+ *             a_Seed - Seed of the request jitter
+ * Return Value: FALSE if there are too many sources or a vector is used twice
+ * Description: Loads the sources, resolves their priorities and the
+ * priority grouping from the simulated registers and resets the time.
+ *********************************************************************/
+boolean NvicSim_Init(const NvicSim_SourceConfigType *a_Sources, uint8 a_Count, uint32 a_Seed)
+{
+    NvicSim_SourceType *source;
+    uint32 prigroup;
+    uint8 index;
+    uint8 other;
+    uint8 bin;
+
+    if (a_Count > NVICSIM_MAX_SOURCES)
+    {
+        return FALSE;
+    }
+    for (index = 0; index < a_Count; index++)
+    {
+        for (other = 0; other < index; other++)
+        {
+            if (a_Sources[index].vector == a_Sources[other].vector)
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    //Subpriority bits among the 3 implemented ones (PRIGROUP 5 to 7)
+    prigroup = (RegSim_Peek(REGSIM_NVIC_APINT) & REGSIM_APINT_PRIGROUP_MASK) >> REGSIM_APINT_PRIGROUP_BITS_POS;
+    g_NvicSimSubBits = (prigroup > 4) ? (uint8)(prigroup - 4) : 0;
+    g_NvicSimRandom = a_Seed;
+    g_NvicSimTime = 0;
+    g_NvicSimPhase = NVICSIM_PHASE_RUN;
+    g_NvicSimDepth = 0;
+    g_NvicSimCount = a_Count;
+
+    for (index = 0; index < a_Count; index++)
+    {
+        source = &g_NvicSimSources[index];
+        source->config = a_Sources[index];
+        source->priority = (a_Sources[index].priority == NVICSIM_PRIORITY_FROM_REGISTERS) ?
+                           NvicSim_RegisterPriority(a_Sources[index].vector) : (a_Sources[index].priority & 0x7);
+        source->pending = FALSE;
+        source->remaining = 0;
+        source->responseSum = 0;
+        source->summary.requests = 0;
+        source->summary.overruns = 0;
+        source->summary.completed = 0;
+        source->summary.misses = 0;
+        source->summary.preemptions = 0;
+        source->summary.latencyMin = 0xFFFFFFFFUL;
+        source->summary.latencyMax = 0;
+        source->summary.responseMin = 0xFFFFFFFFUL;
+        source->summary.responseMax = 0;
+        source->summary.responseMean = 0;
+        for (bin = 0; bin < NVICSIM_HISTOGRAM_BINS; bin++)
+        {
+            source->summary.histogram[bin] = 0;
+        }
+        NvicSim_ScheduleArrival(source, TRUE);
+    }
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: NvicSim_Run
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Simulated time to be run
+ * Return Value: None
+ * Description: Runs the arbitration for a_Cycles cycles, from where the
+ * previous call stopped.
+ *********************************************************************/
+void NvicSim_Run(uint64 a_Cycles)
+{
+    uint64 end = g_NvicSimTime + a_Cycles;
+    uint64 next;
+    NvicSim_SourceType *source;
+    NvicSim_SourceType *running;
+    uint8 index;
+
+    while (TRUE)
+    {
+        //Next event: a request, the end of an exception sequence or of the running handler
+        next = end;
+        running = ((g_NvicSimPhase == NVICSIM_PHASE_RUN) && (g_NvicSimDepth != 0)) ?
+                  &g_NvicSimSources[g_NvicSimStack[g_NvicSimDepth - 1]] : NULL_PTR;
+        for (index = 0; index < g_NvicSimCount; index++)
+        {
+            if (g_NvicSimSources[index].nextArrival < next)
+            {
+                next = g_NvicSimSources[index].nextArrival;
+            }
+        }
+        if ((g_NvicSimPhase != NVICSIM_PHASE_RUN) && (g_NvicSimPhaseEnd < next))
+        {
+            next = g_NvicSimPhaseEnd;
+        }
+        if ((running != NULL_PTR) && ((g_NvicSimTime + running->remaining) < next))
+        {
+            next = g_NvicSimTime + running->remaining;
+        }
+
+        if (running != NULL_PTR)
+        {
+            running->remaining -= (uint32)(next - g_NvicSimTime);
+        }
+        g_NvicSimTime = next;
+        if (next == end)
+        {
+            break;
+        }
+
+        //Requests: a source already pending keeps a single pend bit
+        for (index = 0; index < g_NvicSimCount; index++)
+        {
+            source = &g_NvicSimSources[index];
+            while (source->nextArrival == g_NvicSimTime)
+            {
+                source->summary.requests++;
+                if (source->pending)
+                {
+                    source->summary.overruns++;
+                }
+                else
+                {
+                    source->pending = TRUE;
+                    source->pendingSince = g_NvicSimTime;
+                }
+                NvicSim_ScheduleArrival(source, FALSE);
+            }
+        }
+
+        if ((g_NvicSimPhase != NVICSIM_PHASE_RUN) && (g_NvicSimPhaseEnd == g_NvicSimTime))
+        {
+            if (g_NvicSimPhase == NVICSIM_PHASE_EXIT)
+            {
+                g_NvicSimPhase = NVICSIM_PHASE_RUN; // Back in the preempted context
+            }
+            else
+            {
+                NvicSim_Activate(); // The highest request at this point wins (late arrival)
+            }
+        }
+
+        if ((g_NvicSimPhase == NVICSIM_PHASE_RUN) && (g_NvicSimDepth != 0) &&
+            (g_NvicSimSources[g_NvicSimStack[g_NvicSimDepth - 1]].remaining == 0))
+        {
+            NvicSim_Complete();
+        }
+
+        if (NvicSim_SelectPending() != NVICSIM_NO_SOURCE)
+        {
+            if (g_NvicSimPhase == NVICSIM_PHASE_RUN)
+            {
+                g_NvicSimPhase = NVICSIM_PHASE_ENTRY; // Preemption
+                g_NvicSimPhaseEnd = g_NvicSimTime + NVICSIM_ENTRY_CYCLES;
+            }
+            else if (g_NvicSimPhase == NVICSIM_PHASE_EXIT)
+            {
+                g_NvicSimPhase = NVICSIM_PHASE_TAILCHAIN; // Unstacking abandoned
+                g_NvicSimPhaseEnd = g_NvicSimTime + NVICSIM_TAILCHAIN_CYCLES;
+            }
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: NvicSim_GetSummary
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Source - Index of the source in the NvicSim_Init table
+ *             a_Summary - Filled with the statistics of the source
+ * Return Value: FALSE if the index is out of range
+ * Description: Returns the simulated latencies and response times.
+ *********************************************************************/
+boolean NvicSim_GetSummary(uint8 a_Source, NvicSim_SummaryType *a_Summary)
+{
+    NvicSim_SourceType *source;
+
+    if (a_Source >= g_NvicSimCount)
+    {
+        return FALSE;
+    }
+
+    source = &g_NvicSimSources[a_Source];
+    *a_Summary = source->summary;
+    if (a_Summary->completed != 0)
+    {
+        a_Summary->responseMean = (uint32)(source->responseSum / a_Summary->completed);
+    }
+    else
+    {
+        a_Summary->latencyMin = 0;
+        a_Summary->responseMin = 0;
+    }
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: NvicSim_Analyze
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Source - Index of the source in the NvicSim_Init table
+ *             a_Analysis - Filled with the static bound of the source
+ * Return Value: FALSE if the index is out of range
+ * Description: Response time analysis: the handler cost plus the entry and
+ * exit sequences, plus one run of the longest handler of the same
+ * preemption level (no preemption inside a level), plus the requests of
+ * the sources that can preempt it or go first, iterated to a fixed point:
+ * R = C + B + sum(ceil((R + Jj) / Tj) * Cj).
+ *********************************************************************/
+boolean NvicSim_Analyze(uint8 a_Source, NvicSim_AnalysisType *a_Analysis)
+{
+    const NvicSim_SourceConfigType *config;
+    const NvicSim_SourceConfigType *other;
+    uint64 overhead = NVICSIM_ENTRY_CYCLES + NVICSIM_EXIT_CYCLES;
+    uint64 deadline;
+    uint64 response;
+    uint64 previous;
+    uint64 requests;
+    uint32 blocking = 0;
+    uint8 index;
+
+    if (a_Source >= g_NvicSimCount)
+    {
+        return FALSE;
+    }
+
+    config = &g_NvicSimSources[a_Source].config;
+    deadline = (config->deadline != 0) ? config->deadline : config->period;
+
+    //A source of the same level that started first runs to its end
+    for (index = 0; index < g_NvicSimCount; index++)
+    {
+        if ((index != a_Source) && (NvicSim_Group(index) == NvicSim_Group(a_Source)) &&
+            !NvicSim_GoesFirst(index, a_Source) && (g_NvicSimSources[index].config.cost > blocking))
+        {
+            blocking = g_NvicSimSources[index].config.cost;
+        }
+    }
+
+    response = config->cost + overhead + blocking;
+    do
+    {
+        previous = response;
+        response = config->cost + overhead + blocking;
+        for (index = 0; index < g_NvicSimCount; index++)
+        {
+            other = &g_NvicSimSources[index].config;
+            if ((index == a_Source) || !NvicSim_GoesFirst(index, a_Source))
+            {
+                continue;
+            }
+            //Higher levels preempt, the same level with a higher priority goes first
+            requests = (other->period == 0) ? 1 : ((previous + other->jitter + other->period - 1) / other->period);
+            response += requests * (other->cost + overhead);
+        }
+    } while ((response != previous) && ((deadline == 0) || (response <= deadline)) && (response < NVICSIM_UNBOUNDED));
+
+    a_Analysis->priority = g_NvicSimSources[a_Source].priority;
+    a_Analysis->blocking = blocking;
+    a_Analysis->bound = ((response == previous) && (response < NVICSIM_UNBOUNDED)) ? (uint32)response : NVICSIM_UNBOUNDED;
+    a_Analysis->schedulable = (a_Analysis->bound != NVICSIM_UNBOUNDED) && ((deadline == 0) || (response <= deadline));
+
+    return TRUE;
+}
+
+
+/**********************************************************************
+ * Service Name: NvicSim_GetTime
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Simulated cycles since NvicSim_Init
+ * Description: Returns the simulated time.
+ *********************************************************************/
+uint64 NvicSim_GetTime(void)
+{
+    return g_NvicSimTime;
+}
@@ -0,0 +1,177 @@
+/******************************************************************************
+ *
+ * Module: NvicSim
+ *
+ * File Name: NvicSim.h
+ *
+ * Description: Header file for the host-side NVIC arbitration simulator used
+ *              to check a priority layout offline. Interrupt sources are
+ *              described by their arrival pattern and handler cost; the
+ *              simulator replays them cycle by cycle with the Cortex-M4
+ *              pending/active rules (preemption on the group priority only,
+ *              tail-chaining, late arrival, one pend bit per source) and
+ *              reports latency and response time statistics and deadline
+ *              misses. A static response time analysis gives the matching
+ *              worst-case bounds.
+ *
+ *              The priorities can be taken from the simulated registers, so
+ *              the application runs its NVIC_SetPriorityIRQ,
+ *              NVIC_SetPriorityException and NVIC_SetPriorityGrouping calls
+ *              on the RegSim backend first. Plain C, deterministic for a
+ *              given seed.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef NVICSIM_H_
+#define NVICSIM_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+#ifndef NVICSIM_MAX_SOURCES
+#define NVICSIM_MAX_SOURCES                  16
+#endif
+
+/* Core cycles of the exception sequences (Cortex-M4, zero wait state memory,
+ * no floating point frame) */
+#ifndef NVICSIM_ENTRY_CYCLES
+#define NVICSIM_ENTRY_CYCLES                 12
+#endif
+#ifndef NVICSIM_TAILCHAIN_CYCLES
+#define NVICSIM_TAILCHAIN_CYCLES             6
+#endif
+#ifndef NVICSIM_EXIT_CYCLES
+#define NVICSIM_EXIT_CYCLES                  10
+#endif
+
+/* Vector numbers of the sources: 16 + IRQ number for the IRQs */
+#define NVICSIM_VECTOR_PENDSV                14
+#define NVICSIM_VECTOR_SYSTICK               15
+#define NVICSIM_VECTOR_IRQ(IRQ_Num)          (16 + (IRQ_Num))
+
+/* Priority of a source read from the simulated priority registers */
+#define NVICSIM_PRIORITY_FROM_REGISTERS      0xFF
+
+/* Response time histogram: bin k counts [2^(k-1), 2^k) cycles, as IsrStats */
+#define NVICSIM_HISTOGRAM_BINS               16
+
+/* Bound returned by NvicSim_Analyze when the iteration passes the deadline */
+#define NVICSIM_UNBOUNDED                    0xFFFFFFFFUL
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef struct
+{
+    uint8 vector;        /* NVICSIM_VECTOR_IRQ(n), NVICSIM_VECTOR_SYSTICK, ... */
+    uint8 priority;      /* 3-bit priority value, or NVICSIM_PRIORITY_FROM_REGISTERS */
+    uint32 period;       /* Cycles between two requests, 0 for a single request */
+    uint32 offset;       /* Time of the first request */
+    uint32 jitter;       /* Each request comes 0 to jitter cycles late */
+    uint32 cost;         /* Handler run time in cycles */
+    uint32 deadline;     /* Response time limit in cycles, 0 for the period */
+} NvicSim_SourceConfigType;
+
+typedef struct
+{
+    uint32 requests;     /* Requests made */
+    uint32 overruns;     /* Requests lost: the pend bit was still set */
+    uint32 completed;    /* Handler runs finished */
+    uint32 misses;       /* Completed runs over the deadline */
+    uint32 preemptions;  /* Times the handler was preempted */
+    uint32 latencyMin;   /* Request to handler start */
+    uint32 latencyMax;
+    uint32 responseMin;  /* Request to handler end */
+    uint32 responseMax;
+    uint32 responseMean;
+    uint32 histogram[NVICSIM_HISTOGRAM_BINS];
+} NvicSim_SummaryType;
+
+typedef struct
+{
+    uint8 priority;      /* Priority used by the simulation */
+    uint32 blocking;     /* Longest run of a source of the same preemption level */
+    uint32 bound;        /* Worst-case response time, or NVICSIM_UNBOUNDED */
+    boolean schedulable; /* bound within the deadline */
+} NvicSim_AnalysisType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************
+ * Service Name: NvicSim_Init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Sources - Interrupt sources (copied)
+ *             a_Count - Number of sources (at most NVICSIM_MAX_SOURCES)
+ *             a_Seed - Seed of the request jitter
+ * Return Value: FALSE if there are too many sources or a vector is used twice
+ * Description: Loads the sources, resolves their priorities and the
+ * priority grouping from the simulated registers and resets the time.
+ *********************************************************************/
+boolean NvicSim_Init(const NvicSim_SourceConfigType *a_Sources, uint8 a_Count, uint32 a_Seed);
+
+/**********************************************************************
+ * Service Name: NvicSim_Run
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Simulated time to be run
+ * Return Value: None
+ * Description: Runs the arbitration for a_Cycles cycles, from where the
+ * previous call stopped.
+ *********************************************************************/
+void NvicSim_Run(uint64 a_Cycles);
+
+/**********************************************************************
+ * Service Name: NvicSim_GetSummary
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Source - Index of the source in the NvicSim_Init table
+ *             a_Summary - Filled with the statistics of the source
+ * Return Value: FALSE if the index is out of range
+ * Description: Returns the simulated latencies and response times.
+ *********************************************************************/
+boolean NvicSim_GetSummary(uint8 a_Source, NvicSim_SummaryType *a_Summary);
+
+/**********************************************************************
+ * Service Name: NvicSim_Analyze
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Source - Index of the source in the NvicSim_Init table
+ *             a_Analysis - Filled with the static bound of the source
+ * Return Value: FALSE if the index is out of range
+ * Description: Response time analysis: the handler cost plus the entry and
+ * exit sequences, plus one run of the longest handler of the same
+ * preemption level (no preemption inside a level), plus the requests of
+ * the sources that can preempt it or go first, iterated to a fixed point:
+ * R = C + B + sum(ceil((R + Jj) / Tj) * Cj).
+ *********************************************************************/
+boolean NvicSim_Analyze(uint8 a_Source, NvicSim_AnalysisType *a_Analysis);
+
+/**********************************************************************
+ * Service Name: NvicSim_GetTime
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Simulated cycles since NvicSim_Init
+ * Description: Returns the simulated time.
+ *********************************************************************/
+uint64 NvicSim_GetTime(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVICSIM_H_ */
@@ -0,0 +1,768 @@
+/******************************************************************************
+ *
+ * Module: RegSim
+ *
+ * File Name: RegSim.c
+ *
+ * Description: Source file for the host-side simulated register file used to
+ *              build and run the NVIC and SysTick drivers on Linux.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include "RegSim.h"
+
+/* Implemented priority bits: the TM4C123 keeps bits 7:5 of every priority byte */
+#define REGSIM_PRI_IMPLEMENTED_MASK          0xE0E0E0E0
+#define REGSIM_SYSTEM_PRI1_IMPLEMENTED_MASK  0x00E0E0E0
+#define REGSIM_SYSTEM_PRI2_IMPLEMENTED_MASK  0xE0000000
+#define REGSIM_SYSTEM_PRI3_IMPLEMENTED_MASK  0xE0E000E0
+
+/* SysTick and PendSV priority bytes in SYSPRI3 */
+#define REGSIM_SYSTICK_PRIORITY(pri3)        (((pri3) >> 24) & 0xE0)
+#define REGSIM_PENDSV_PRIORITY(pri3)         (((pri3) >> 16) & 0xE0)
+
+/* Simulated register file, the ENn/DISn and PENDn/UNPENDn pairs share one
+ * state word. IRQ pend bits are only state: the IRQ handlers are not taken. */
+static uint32 g_RegSimValue[REGSIM_REGISTERS_COUNT];
+static uint32 g_RegSimEnable[REGSIM_NVIC_BANK_WORDS];
+static uint32 g_RegSimIrqPending[REGSIM_NVIC_BANK_WORDS];
+
+static uint32 g_RegSimReadCount[REGSIM_REGISTERS_COUNT];
+static uint32 g_RegSimWriteCount[REGSIM_REGISTERS_COUNT];
+
+/* Reset vector table (flash on the target) and the table selected by VTABLE */
+static RegSim_HandlerType g_RegSimResetVectors[REGSIM_VECTOR_COUNT];
+static RegSim_HandlerType *g_RegSimVectorTable = g_RegSimResetVectors;
+
+static boolean g_RegSimPendSVPending = FALSE;
+static uint32 g_RegSimCyclesPerAccess = 0;
+static uint32 g_RegSimSysTickIsrCount = 0;
+static uint32 g_RegSimSysTickPending = 0;
+static boolean g_RegSimInSysTickHandler = FALSE;
+static uint32 g_RegSimActiveVector = 0;         /* VECACTIVE of INTCTRL, 0 in thread mode */
+static boolean g_RegSimPrimask = FALSE;
+static uint32 g_RegSimBasepri = 0;
+static boolean g_RegSimSysTickWrapped = FALSE;  /* Counter reached zero, the reload edge is next */
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* BASEPRI masks the exceptions whose preemption priority (the bits above the
+ * PRIGROUP binary point) is not above its own */
+static boolean RegSim_MaskedByBasepri(uint32 a_Priority)
+{
+    uint32 prigroup = (g_RegSimValue[REGSIM_NVIC_APINT] & REGSIM_APINT_PRIGROUP_MASK) >> REGSIM_APINT_PRIGROUP_BITS_POS;
+    uint32 preemptMask = (0xFFUL << (prigroup + 1)) & 0xFF;
+
+    return (g_RegSimBasepri != 0) && ((a_Priority & preemptMask) >= (g_RegSimBasepri & preemptMask));
+}
+
+/* Takes the pending SysTick interrupts, a wrap raised from inside the handler
+ * is taken after the handler returns, as on the target (no self preemption). */
+static void RegSim_DeliverSysTick(void)
+{
+    uint32 previous;
+
+    if (g_RegSimInSysTickHandler || g_RegSimPrimask)
+    {
+        return;
+    }
+    if (RegSim_MaskedByBasepri(REGSIM_SYSTICK_PRIORITY(g_RegSimValue[REGSIM_NVIC_SYSTEM_PRI3])))
+    {
+        return; // Masked by BASEPRI
+    }
+
+    while (g_RegSimSysTickPending != 0)
+    {
+        g_RegSimSysTickPending = 0;
+        if (g_RegSimVectorTable[REGSIM_VECTOR_SYSTICK] != 0)
+        {
+            previous = g_RegSimActiveVector;
+            g_RegSimActiveVector = REGSIM_VECTOR_SYSTICK;
+            g_RegSimInSysTickHandler = TRUE;
+            g_RegSimSysTickIsrCount++;
+            (*g_RegSimVectorTable[REGSIM_VECTOR_SYSTICK])();
+            g_RegSimInSysTickHandler = FALSE;
+            g_RegSimActiveVector = previous;
+        }
+    }
+}
+
+/* Takes a pending PendSV once no handler is running and the masks allow its
+ * priority. The simulated handler runs the pended work to completion. */
+static void RegSim_DeliverPendSV(void)
+{
+    uint32 previous;
+
+    if (g_RegSimInSysTickHandler || g_RegSimPrimask)
+    {
+        return;
+    }
+    if (RegSim_MaskedByBasepri(REGSIM_PENDSV_PRIORITY(g_RegSimValue[REGSIM_NVIC_SYSTEM_PRI3])))
+    {
+        return; // Masked by BASEPRI
+    }
+
+    while (g_RegSimPendSVPending)
+    {
+        g_RegSimPendSVPending = FALSE;
+        if (g_RegSimVectorTable[REGSIM_VECTOR_PENDSV] != 0)
+        {
+            previous = g_RegSimActiveVector;
+            g_RegSimActiveVector = REGSIM_VECTOR_PENDSV;
+            (*g_RegSimVectorTable[REGSIM_VECTOR_PENDSV])();
+            g_RegSimActiveVector = previous;
+        }
+    }
+}
+
+/* SysTick first, then PendSV tail-chained after it */
+static void RegSim_DeliverExceptions(void)
+{
+    RegSim_DeliverSysTick();
+    RegSim_DeliverPendSV();
+}
+
+/* Runs the SysTick down-counter, returns after the cycles are consumed */
+static void RegSim_SysTickRun(uint32 a_Cycles)
+{
+    uint32 *ctrl = &g_RegSimValue[REGSIM_SYSTICK_CTRL];
+    uint32 *current = &g_RegSimValue[REGSIM_SYSTICK_CURRENT];
+    uint32 reload;
+    uint32 step;
+
+    while ((a_Cycles != 0) && ((*ctrl & REGSIM_SYSTICK_CTRL_ENABLE) != 0))
+    {
+        reload = g_RegSimValue[REGSIM_SYSTICK_RELOAD];
+        if (*current == 0)
+        {
+            /* A zero RELOAD value disables the counter on its next wrap */
+            if (reload == 0)
+            {
+                break;
+            }
+            *current = reload; // The counter reloads on the clock edge after reaching zero
+            a_Cycles--;
+            /* The exception is taken after the reload at the earliest (entry latency) */
+            if (g_RegSimSysTickWrapped && ((*ctrl & REGSIM_SYSTICK_CTRL_INTEN) != 0))
+            {
+                g_RegSimSysTickPending = 1; // A single pend bit, wraps taken while masked collapse
+            }
+            g_RegSimSysTickWrapped = FALSE;
+            continue;
+        }
+
+        step = (a_Cycles < *current) ? a_Cycles : *current;
+        *current -= step;
+        a_Cycles -= step;
+
+        if (*current == 0)
+        {
+            *ctrl |= REGSIM_SYSTICK_CTRL_COUNT;
+            g_RegSimSysTickWrapped = TRUE;
+        }
+    }
+}
+
+/* Free running DWT cycle counter, counts while trace and CYCCNTENA are enabled */
+static void RegSim_CycleCounterRun(uint32 a_Cycles)
+{
+    if (((g_RegSimValue[REGSIM_CORE_DEMCR] & REGSIM_DEMCR_TRCENA) != 0) &&
+        ((g_RegSimValue[REGSIM_DWT_CTRL] & REGSIM_DWT_CTRL_CYCCNTENA) != 0))
+    {
+        g_RegSimValue[REGSIM_DWT_CYCCNT] += a_Cycles;
+    }
+}
+
+/* Counted accesses consume core time when the harness asked for it */
+static void RegSim_AccessTime(void)
+{
+    if (g_RegSimCyclesPerAccess != 0)
+    {
+        RegSim_CycleCounterRun(g_RegSimCyclesPerAccess);
+        RegSim_SysTickRun(g_RegSimCyclesPerAccess);
+        RegSim_DeliverExceptions();
+    }
+}
+
+/*******************************************************************************
+ *                           Function Definitions                              *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: RegSim_Reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Puts every simulated register in its reset state and clears
+ * the access counters.
+ *********************************************************************/
+void RegSim_Reset(void)
+{
+    uint32 i;
+
+    for (i = 0; i < REGSIM_REGISTERS_COUNT; i++)
+    {
+        g_RegSimValue[i] = 0;
+    }
+    for (i = 0; i < REGSIM_NVIC_BANK_WORDS; i++)
+    {
+        g_RegSimEnable[i] = 0;
+        g_RegSimIrqPending[i] = 0;
+    }
+    g_RegSimVectorTable = g_RegSimResetVectors; // VTABLE resets to 0
+    g_RegSimSysTickPending = 0;
+    g_RegSimPendSVPending = FALSE;
+    g_RegSimInSysTickHandler = FALSE;
+    g_RegSimActiveVector = 0;
+    g_RegSimPrimask = FALSE;
+    g_RegSimBasepri = 0;
+    g_RegSimSysTickWrapped = FALSE;
+    g_RegSimCyclesPerAccess = 0;
+    RegSim_ClearCounters();
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_Read
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Register to be read
+ * Return Value: Value seen by the driver
+ * Description: Counted bus read. Models the read side effects of the
+ * register (e.g. the SysTick COUNT flag is cleared on read, VECACTIVE of
+ * INTCTRL holds the simulated exception being run).
+ *********************************************************************/
+uint32 RegSim_Read(RegSim_RegisterType a_Register)
+{
+    uint32 value;
+
+    RegSim_AccessTime();
+    g_RegSimReadCount[a_Register]++;
+
+    value = RegSim_Peek(a_Register);
+    if (a_Register == REGSIM_SYSTICK_CTRL)
+    {
+        g_RegSimValue[REGSIM_SYSTICK_CTRL] &= ~REGSIM_SYSTICK_CTRL_COUNT; // COUNT is cleared by reading CTRL
+    }
+    return value;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_Write
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Register to be written
+ *             a_Value - Value stored by the driver
+ * Return Value: None
+ * Description: Counted bus write. Models write-1-to-set (NVIC ENn and
+ * PENDn, INTCTRL PENDSTSET), write-1-to-clear (NVIC DISn and UNPENDn,
+ * INTCTRL PENDSTCLR), write-any-to-clear (SysTick CURRENT), the SWTRIG
+ * IRQ number, the read-only ACTIVEn bits, the APINT write key and the
+ * unimplemented priority bits.
+ *********************************************************************/
+void RegSim_Write(RegSim_RegisterType a_Register, uint32 a_Value)
+{
+    RegSim_AccessTime();
+    g_RegSimWriteCount[a_Register]++;
+
+    if ((a_Register >= REGSIM_NVIC_EN0) && (a_Register < REGSIM_NVIC_DIS0))
+    {
+        g_RegSimEnable[a_Register - REGSIM_NVIC_EN0] |= a_Value; // Write 1 to set
+    }
+    else if ((a_Register >= REGSIM_NVIC_DIS0) && (a_Register < REGSIM_NVIC_PRI0))
+    {
+        g_RegSimEnable[a_Register - REGSIM_NVIC_DIS0] &= ~a_Value; // Write 1 to clear
+    }
+    else if ((a_Register >= REGSIM_NVIC_PRI0) && (a_Register < REGSIM_NVIC_SYSTEM_PRI1))
+    {
+        g_RegSimValue[a_Register] = a_Value & REGSIM_PRI_IMPLEMENTED_MASK;
+    }
+    else if ((a_Register >= REGSIM_NVIC_PEND0) && (a_Register < REGSIM_NVIC_UNPEND0))
+    {
+        g_RegSimIrqPending[a_Register - REGSIM_NVIC_PEND0] |= a_Value; // Write 1 to set
+    }
+    else if ((a_Register >= REGSIM_NVIC_UNPEND0) && (a_Register < REGSIM_NVIC_ACTIVE0))
+    {
+        g_RegSimIrqPending[a_Register - REGSIM_NVIC_UNPEND0] &= ~a_Value; // Write 1 to clear
+    }
+    else if ((a_Register >= REGSIM_NVIC_ACTIVE0) && (a_Register < REGSIM_NVIC_SWTRIG))
+    {
+        //Read-only, the active bits are set by the harness with RegSim_Poke
+    }
+    else
+    {
+        switch (a_Register)
+        {
+            case REGSIM_NVIC_SWTRIG:
+                //Pends the IRQ whose number is written, reads as 0
+                if ((a_Value & REGSIM_SWTRIG_INTID_MASK) < REGSIM_NVIC_IRQS)
+                {
+                    g_RegSimIrqPending[(a_Value & REGSIM_SWTRIG_INTID_MASK) >> 5] |= 1UL << (a_Value & 31);
+                }
+                break;
+            case REGSIM_SYSTICK_CTRL:
+                //COUNT is read-only, it keeps its state across writes
+                g_RegSimValue[REGSIM_SYSTICK_CTRL] = (a_Value & ~REGSIM_SYSTICK_CTRL_COUNT) |
+                                                     (g_RegSimValue[REGSIM_SYSTICK_CTRL] & REGSIM_SYSTICK_CTRL_COUNT);
+                break;
+            case REGSIM_SYSTICK_RELOAD:
+                g_RegSimValue[REGSIM_SYSTICK_RELOAD] = a_Value & REGSIM_SYSTICK_RELOAD_MASK;
+                break;
+            case REGSIM_SYSTICK_CURRENT:
+                //Any write clears the counter and the COUNT flag
+                g_RegSimValue[REGSIM_SYSTICK_CURRENT] = 0;
+                g_RegSimValue[REGSIM_SYSTICK_CTRL] &= ~REGSIM_SYSTICK_CTRL_COUNT;
+                g_RegSimSysTickWrapped = FALSE;
+                break;
+            case REGSIM_NVIC_SYSTEM_INTCTRL:
+                //Only the SysTick and PendSV pend bits are modelled
+                if ((a_Value & REGSIM_INTCTRL_PENDSTCLR) != 0)
+                {
+                    g_RegSimSysTickPending = 0;
+                }
+                if ((a_Value & REGSIM_INTCTRL_PENDSTSET) != 0)
+                {
+                    g_RegSimSysTickPending = 1;
+                }
+                if ((a_Value & REGSIM_INTCTRL_PENDSVCLR) != 0)
+                {
+                    g_RegSimPendSVPending = FALSE;
+                }
+                if ((a_Value & REGSIM_INTCTRL_PENDSVSET) != 0)
+                {
+                    g_RegSimPendSVPending = TRUE;
+                }
+                RegSim_DeliverExceptions();
+                break;
+            case REGSIM_NVIC_APINT:
+                //Writes without the key are ignored, only PRIGROUP is kept
+                if ((a_Value & REGSIM_APINT_VECTKEY_MASK) == REGSIM_APINT_VECTKEY)
+                {
+                    g_RegSimValue[REGSIM_NVIC_APINT] = a_Value & REGSIM_APINT_PRIGROUP_MASK;
+                }
+                break;
+            case REGSIM_NVIC_SYSTEM_PRI1:
+                g_RegSimValue[a_Register] = a_Value & REGSIM_SYSTEM_PRI1_IMPLEMENTED_MASK;
+                break;
+            case REGSIM_NVIC_SYSTEM_PRI2:
+                g_RegSimValue[a_Register] = a_Value & REGSIM_SYSTEM_PRI2_IMPLEMENTED_MASK;
+                break;
+            case REGSIM_NVIC_SYSTEM_PRI3:
+                g_RegSimValue[a_Register] = a_Value & REGSIM_SYSTEM_PRI3_IMPLEMENTED_MASK;
+                break;
+            default:
+                g_RegSimValue[a_Register] = a_Value;
+                break;
+        }
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_WriteByte
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Byte accessible register (PRIn, SYSPRIn)
+ *             a_Byte - Byte lane (0 to 3)
+ *             a_Value - Value stored in the byte
+ * Return Value: None
+ * Description: Counted byte write (STRB): one write access that changes
+ * a single byte of the register.
+ *********************************************************************/
+void RegSim_WriteByte(RegSim_RegisterType a_Register, uint8 a_Byte, uint8 a_Value)
+{
+    uint32 shift = 8UL * (a_Byte & 3);
+
+    //The other byte lanes are not accessed: merged without a counted read
+    RegSim_Write(a_Register, (RegSim_Peek(a_Register) & ~(0xFFUL << shift)) | ((uint32)a_Value << shift));
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_Peek
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Register - Register to be inspected
+ * Return Value: Current register value
+ * Description: Reads a register for the test harness without counting the
+ * access and without side effects.
+ *********************************************************************/
+uint32 RegSim_Peek(RegSim_RegisterType a_Register)
+{
+    if ((a_Register >= REGSIM_NVIC_EN0) && (a_Register < REGSIM_NVIC_DIS0))
+    {
+        return g_RegSimEnable[a_Register - REGSIM_NVIC_EN0];
+    }
+    else if ((a_Register >= REGSIM_NVIC_DIS0) && (a_Register < REGSIM_NVIC_PRI0))
+    {
+        return g_RegSimEnable[a_Register - REGSIM_NVIC_DIS0];
+    }
+    else if ((a_Register >= REGSIM_NVIC_PEND0) && (a_Register < REGSIM_NVIC_UNPEND0))
+    {
+        return g_RegSimIrqPending[a_Register - REGSIM_NVIC_PEND0];
+    }
+    else if ((a_Register >= REGSIM_NVIC_UNPEND0) && (a_Register < REGSIM_NVIC_ACTIVE0))
+    {
+        return g_RegSimIrqPending[a_Register - REGSIM_NVIC_UNPEND0];
+    }
+    else if (a_Register == REGSIM_NVIC_SWTRIG)
+    {
+        return 0; // Write-only
+    }
+    else if (a_Register == REGSIM_NVIC_SYSTEM_INTCTRL)
+    {
+        return ((g_RegSimSysTickPending != 0) ? REGSIM_INTCTRL_PENDSTSET : 0) |
+               (g_RegSimPendSVPending ? REGSIM_INTCTRL_PENDSVSET : 0) | g_RegSimActiveVector;
+    }
+    else if (a_Register == REGSIM_NVIC_APINT)
+    {
+        return REGSIM_APINT_VECTKEYSTAT | g_RegSimValue[REGSIM_NVIC_APINT];
+    }
+    else
+    {
+        return g_RegSimValue[a_Register];
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_Poke
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Register to be forced
+ *             a_Value - Raw value to be stored
+ * Return Value: None
+ * Description: Forces a register value for the test harness without
+ * counting the access and without write semantics.
+ *********************************************************************/
+void RegSim_Poke(RegSim_RegisterType a_Register, uint32 a_Value)
+{
+    if ((a_Register >= REGSIM_NVIC_EN0) && (a_Register < REGSIM_NVIC_DIS0))
+    {
+        g_RegSimEnable[a_Register - REGSIM_NVIC_EN0] = a_Value;
+    }
+    else if ((a_Register >= REGSIM_NVIC_DIS0) && (a_Register < REGSIM_NVIC_PRI0))
+    {
+        g_RegSimEnable[a_Register - REGSIM_NVIC_DIS0] = a_Value;
+    }
+    else if ((a_Register >= REGSIM_NVIC_PEND0) && (a_Register < REGSIM_NVIC_UNPEND0))
+    {
+        g_RegSimIrqPending[a_Register - REGSIM_NVIC_PEND0] = a_Value;
+    }
+    else if ((a_Register >= REGSIM_NVIC_UNPEND0) && (a_Register < REGSIM_NVIC_ACTIVE0))
+    {
+        g_RegSimIrqPending[a_Register - REGSIM_NVIC_UNPEND0] = a_Value;
+    }
+    else
+    {
+        g_RegSimValue[a_Register] = a_Value;
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetReadCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Register - Register to be queried
+ * Return Value: Number of driver reads since the last counter clear
+ * Description: Returns the read counter of one register.
+ *********************************************************************/
+uint32 RegSim_GetReadCount(RegSim_RegisterType a_Register)
+{
+    return g_RegSimReadCount[a_Register];
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetWriteCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Register - Register to be queried
+ * Return Value: Number of driver writes since the last counter clear
+ * Description: Returns the write counter of one register.
+ *********************************************************************/
+uint32 RegSim_GetWriteCount(RegSim_RegisterType a_Register)
+{
+    return g_RegSimWriteCount[a_Register];
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetTotalReads
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of driver reads over all registers
+ * Description: Returns the sum of all the read counters.
+ *********************************************************************/
+uint32 RegSim_GetTotalReads(void)
+{
+    uint32 total = 0;
+    uint32 i;
+
+    for (i = 0; i < REGSIM_REGISTERS_COUNT; i++)
+    {
+        total += g_RegSimReadCount[i];
+    }
+    return total;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetTotalWrites
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of driver writes over all registers
+ * Description: Returns the sum of all the write counters.
+ *********************************************************************/
+uint32 RegSim_GetTotalWrites(void)
+{
+    uint32 total = 0;
+    uint32 i;
+
+    for (i = 0; i < REGSIM_REGISTERS_COUNT; i++)
+    {
+        total += g_RegSimWriteCount[i];
+    }
+    return total;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_ClearCounters
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Clears the access counters, the register values are kept.
+ *********************************************************************/
+void RegSim_ClearCounters(void)
+{
+    uint32 i;
+
+    for (i = 0; i < REGSIM_REGISTERS_COUNT; i++)
+    {
+        g_RegSimReadCount[i] = 0;
+        g_RegSimWriteCount[i] = 0;
+    }
+    g_RegSimSysTickIsrCount = 0;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SetSysTickHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Ptr2Func - Function called when the simulated SysTick
+ *             interrupt is taken (normally SysTick_Handler)
+ * Return Value: None
+ * Description: Connects the simulated SysTick exception to its handler in
+ * the reset vector table (the flash one on the target).
+ *********************************************************************/
+void RegSim_SetSysTickHandler(void (*Ptr2Func)(void))
+{
+    g_RegSimResetVectors[REGSIM_VECTOR_SYSTICK] = Ptr2Func;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SetPendSVHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Ptr2Func - Function called when the simulated PendSV
+ *             exception is taken (normally PendSV_Handler)
+ * Return Value: None
+ * Description: Connects the simulated PendSV exception to its handler in
+ * the reset vector table. PendSV is taken outside of the SysTick handler
+ * (tail-chained after it) while PRIMASK and BASEPRI allow its priority.
+ *********************************************************************/
+void RegSim_SetPendSVHandler(void (*Ptr2Func)(void))
+{
+    g_RegSimResetVectors[REGSIM_VECTOR_PENDSV] = Ptr2Func;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SetVectorTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Table - Vector table of REGSIM_VECTOR_COUNT entries
+ * Return Value: None
+ * Description: Models the VTABLE register: the simulated exceptions are
+ * taken through the entries of this table. RegSim_Reset selects the reset
+ * table again.
+ *********************************************************************/
+void RegSim_SetVectorTable(RegSim_HandlerType *a_Table)
+{
+    g_RegSimVectorTable = a_Table;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetVectorTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Vector table in use
+ * Description: Returns the table selected by the VTABLE model.
+ *********************************************************************/
+RegSim_HandlerType *RegSim_GetVectorTable(void)
+{
+    return g_RegSimVectorTable;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SetPrimask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Masked - TRUE to mask the interrupts, FALSE to unmask them
+ * Return Value: None
+ * Description: Models the PRIMASK I-bit of the simulated core. Interrupts
+ * raised while masked are taken as soon as they are unmasked.
+ *********************************************************************/
+void RegSim_SetPrimask(boolean a_Masked)
+{
+    g_RegSimPrimask = a_Masked;
+    RegSim_DeliverExceptions();
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetPrimask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE if the interrupts are masked
+ * Description: Returns the PRIMASK I-bit of the simulated core.
+ *********************************************************************/
+boolean RegSim_GetPrimask(void)
+{
+    return g_RegSimPrimask;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SetBasepri
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Basepri - Priority mask (priority in bits 7:5, 0 masks nothing)
+ * Return Value: None
+ * Description: Models the BASEPRI register of the simulated core: the
+ * SysTick interrupt is held while its preemption priority is not above
+ * BASEPRI.
+ *********************************************************************/
+void RegSim_SetBasepri(uint32 a_Basepri)
+{
+    g_RegSimBasepri = a_Basepri & 0xE0;
+    RegSim_DeliverExceptions();
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetBasepri
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: BASEPRI of the simulated core
+ * Description: Returns the BASEPRI register of the simulated core.
+ *********************************************************************/
+uint32 RegSim_GetBasepri(void)
+{
+    return g_RegSimBasepri;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SetCyclesPerAccess
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Core cycles consumed by each counted access
+ * Return Value: None
+ * Description: Lets simulated time run while the driver accesses the
+ * registers, so that polling loops terminate. Zero (the default) freezes
+ * the time between two calls of RegSim_SysTickAdvance.
+ *********************************************************************/
+void RegSim_SetCyclesPerAccess(uint32 a_Cycles)
+{
+    g_RegSimCyclesPerAccess = a_Cycles;
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_SysTickAdvance
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Number of core cycles to be simulated
+ * Return Value: None
+ * Description: Runs the simulated SysTick counter for the given number of
+ * cycles, setting the COUNT flag and taking the SysTick interrupt on
+ * every wrap while it is enabled. The DWT cycle counter runs as well.
+ *********************************************************************/
+void RegSim_SysTickAdvance(uint32 a_Cycles)
+{
+    uint32 current;
+    uint32 step;
+
+    /* Run wrap by wrap so that each interrupt sees the counter at the time it is taken */
+    while (a_Cycles != 0)
+    {
+        current = g_RegSimValue[REGSIM_SYSTICK_CURRENT];
+        step = (current == 0) ? 1 : current;
+        step = (a_Cycles < step) ? a_Cycles : step;
+        RegSim_CycleCounterRun(step);
+        RegSim_SysTickRun(step);
+        a_Cycles -= step;
+        RegSim_DeliverExceptions();
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_WaitForInterrupt
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Models WFI: runs the simulated time until the SysTick
+ * interrupt is pending or taken (masked or not). Returns at once when an
+ * exception is pending or the SysTick interrupt is disabled.
+ *********************************************************************/
+void RegSim_WaitForInterrupt(void)
+{
+    uint32 isrCount = g_RegSimSysTickIsrCount;
+    uint32 enabled = REGSIM_SYSTICK_CTRL_ENABLE | REGSIM_SYSTICK_CTRL_INTEN;
+
+    if (((g_RegSimValue[REGSIM_SYSTICK_CTRL] & enabled) != enabled) || (g_RegSimValue[REGSIM_SYSTICK_RELOAD] == 0))
+    {
+        return; // No wake-up source modelled
+    }
+
+    while ((g_RegSimSysTickPending == 0) && !g_RegSimPendSVPending && (g_RegSimSysTickIsrCount == isrCount))
+    {
+        RegSim_SysTickAdvance(g_RegSimValue[REGSIM_SYSTICK_CURRENT] + 1);
+    }
+}
+
+
+/**********************************************************************
+ * Service Name: RegSim_GetSysTickIsrCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of simulated SysTick interrupts taken
+ * Description: Returns the number of SysTick handler entries since the
+ * last counter clear.
+ *********************************************************************/
+uint32 RegSim_GetSysTickIsrCount(void)
+{
+    return g_RegSimSysTickIsrCount;
+}
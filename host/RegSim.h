@@ -0,0 +1,470 @@
+/******************************************************************************
+ *
+ * Module: RegSim
+ *
+ * File Name: RegSim.h
+ *
+ * Description: Header file for the host-side simulated register file used to
+ *              build and run the NVIC and SysTick drivers on Linux.
+ *
+ *              Define TM4C_HOST_SIM and compile the drivers as C++ (the
+ *              register macros below are proxy objects, so every access goes
+ *              through RegSim_Read/RegSim_Write and is counted). RegSim.c
+ *              itself is plain C. The host std_types.h must define NULL_PTR
+ *              as a null pointer constant that is valid in C++ (e.g. 0).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#ifndef REGSIM_H_
+#define REGSIM_H_
+
+/*******************************************************************************
+ *                                Inclusions                                   *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                           Preprocessor Definitions                          *
+ *******************************************************************************/
+
+/* Number of words in each NVIC register bank modelled by the simulator (IRQ 0 to 138) */
+#define REGSIM_NVIC_BANK_WORDS               5
+#define REGSIM_NVIC_PRI_WORDS                35
+#define REGSIM_NVIC_IRQS                     139
+
+#define REGSIM_SYSTICK_CTRL_ENABLE           0x00000001
+#define REGSIM_SYSTICK_CTRL_INTEN            0x00000002
+#define REGSIM_SYSTICK_CTRL_COUNT            0x00010000
+#define REGSIM_SYSTICK_RELOAD_MASK           0x00FFFFFF
+
+#define REGSIM_DWT_CTRL_CYCCNTENA            0x00000001
+#define REGSIM_DEMCR_TRCENA                  0x01000000
+
+#define REGSIM_INTCTRL_VECACT_MASK           0x000000FF
+#define REGSIM_INTCTRL_PENDSTCLR             0x02000000
+#define REGSIM_INTCTRL_PENDSTSET             0x04000000
+#define REGSIM_INTCTRL_PENDSVCLR             0x08000000
+#define REGSIM_INTCTRL_PENDSVSET             0x10000000
+
+/* Exception vectors of the simulated core (16 system vectors + 139 IRQs) */
+#define REGSIM_VECTOR_COUNT                  (16 + REGSIM_NVIC_IRQS)
+#define REGSIM_VECTOR_PENDSV                 14
+#define REGSIM_VECTOR_SYSTICK                15
+
+#define REGSIM_APINT_VECTKEY                 0x05FA0000
+#define REGSIM_APINT_VECTKEY_MASK            0xFFFF0000
+#define REGSIM_APINT_VECTKEYSTAT             0xFA050000
+#define REGSIM_APINT_PRIGROUP_MASK           0x00000700
+#define REGSIM_APINT_PRIGROUP_BITS_POS       8
+
+#define REGSIM_SWTRIG_INTID_MASK             0x000000FF
+
+/*******************************************************************************
+ *                           Data Types Declarations                           *
+ *******************************************************************************/
+typedef void (*RegSim_HandlerType)(void);
+
+typedef enum
+{
+    REGSIM_SYSTICK_CTRL,
+    REGSIM_SYSTICK_RELOAD,
+    REGSIM_SYSTICK_CURRENT,
+    REGSIM_NVIC_EN0,
+    REGSIM_NVIC_DIS0 = REGSIM_NVIC_EN0 + REGSIM_NVIC_BANK_WORDS,
+    REGSIM_NVIC_PRI0 = REGSIM_NVIC_DIS0 + REGSIM_NVIC_BANK_WORDS,
+    REGSIM_NVIC_SYSTEM_PRI1 = REGSIM_NVIC_PRI0 + REGSIM_NVIC_PRI_WORDS,
+    REGSIM_NVIC_SYSTEM_PRI2,
+    REGSIM_NVIC_SYSTEM_PRI3,
+    REGSIM_NVIC_SYSTEM_SYSHNDCTRL,
+    REGSIM_NVIC_SYSTEM_INTCTRL,
+    REGSIM_NVIC_APINT,
+    REGSIM_DWT_CTRL,
+    REGSIM_DWT_CYCCNT,
+    REGSIM_CORE_DEMCR,
+    REGSIM_NVIC_PEND0,
+    REGSIM_NVIC_UNPEND0 = REGSIM_NVIC_PEND0 + REGSIM_NVIC_BANK_WORDS,
+    REGSIM_NVIC_ACTIVE0 = REGSIM_NVIC_UNPEND0 + REGSIM_NVIC_BANK_WORDS,
+    REGSIM_NVIC_SWTRIG = REGSIM_NVIC_ACTIVE0 + REGSIM_NVIC_BANK_WORDS,
+    REGSIM_REGISTERS_COUNT
+} RegSim_RegisterType;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************
+ * Service Name: RegSim_Reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Puts every simulated register in its reset state and clears
+ * the access counters.
+ *********************************************************************/
+void RegSim_Reset(void);
+
+/**********************************************************************
+ * Service Name: RegSim_Read
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Register to be read
+ * Return Value: Value seen by the driver
+ * Description: Counted bus read. Models the read side effects of the
+ * register (e.g. the SysTick COUNT flag is cleared on read, VECACTIVE of
+ * INTCTRL holds the simulated exception being run).
+ *********************************************************************/
+uint32 RegSim_Read(RegSim_RegisterType a_Register);
+
+/**********************************************************************
+ * Service Name: RegSim_Write
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Register to be written
+ *             a_Value - Value stored by the driver
+ * Return Value: None
+ * Description: Counted bus write. Models write-1-to-set (NVIC ENn and
+ * PENDn, INTCTRL PENDSTSET), write-1-to-clear (NVIC DISn and UNPENDn,
+ * INTCTRL PENDSTCLR), write-any-to-clear (SysTick CURRENT), the SWTRIG
+ * IRQ number, the read-only ACTIVEn bits, the APINT write key and the
+ * unimplemented priority bits.
+ *********************************************************************/
+void RegSim_Write(RegSim_RegisterType a_Register, uint32 a_Value);
+
+/**********************************************************************
+ * Service Name: RegSim_WriteByte
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Byte accessible register (PRIn, SYSPRIn)
+ *             a_Byte - Byte lane (0 to 3)
+ *             a_Value - Value stored in the byte
+ * Return Value: None
+ * Description: Counted byte write (STRB): one write access that changes
+ * a single byte of the register.
+ *********************************************************************/
+void RegSim_WriteByte(RegSim_RegisterType a_Register, uint8 a_Byte, uint8 a_Value);
+
+/**********************************************************************
+ * Service Name: RegSim_Peek
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Register - Register to be inspected
+ * Return Value: Current register value
+ * Description: Reads a register for the test harness without counting the
+ * access and without side effects.
+ *********************************************************************/
+uint32 RegSim_Peek(RegSim_RegisterType a_Register);
+
+/**********************************************************************
+ * Service Name: RegSim_Poke
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Register - Register to be forced
+ *             a_Value - Raw value to be stored
+ * Return Value: None
+ * Description: Forces a register value for the test harness without
+ * counting the access and without write semantics.
+ *********************************************************************/
+void RegSim_Poke(RegSim_RegisterType a_Register, uint32 a_Value);
+
+/**********************************************************************
+ * Service Name: RegSim_GetReadCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Register - Register to be queried
+ * Return Value: Number of driver reads since the last counter clear
+ * Description: Returns the read counter of one register.
+ *********************************************************************/
+uint32 RegSim_GetReadCount(RegSim_RegisterType a_Register);
+
+/**********************************************************************
+ * Service Name: RegSim_GetWriteCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: a_Register - Register to be queried
+ * Return Value: Number of driver writes since the last counter clear
+ * Description: Returns the write counter of one register.
+ *********************************************************************/
+uint32 RegSim_GetWriteCount(RegSim_RegisterType a_Register);
+
+/**********************************************************************
+ * Service Name: RegSim_GetTotalReads
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of driver reads over all registers
+ * Description: Returns the sum of all the read counters.
+ *********************************************************************/
+uint32 RegSim_GetTotalReads(void);
+
+/**********************************************************************
+ * Service Name: RegSim_GetTotalWrites
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of driver writes over all registers
+ * Description: Returns the sum of all the write counters.
+ *********************************************************************/
+uint32 RegSim_GetTotalWrites(void);
+
+/**********************************************************************
+ * Service Name: RegSim_ClearCounters
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Clears the access counters, the register values are kept.
+ *********************************************************************/
+void RegSim_ClearCounters(void);
+
+/**********************************************************************
+ * Service Name: RegSim_SetSysTickHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Ptr2Func - Function called when the simulated SysTick
+ *             interrupt is taken (normally SysTick_Handler)
+ * Return Value: None
+ * Description: Connects the simulated SysTick exception to its handler in
+ * the reset vector table (the flash one on the target).
+ *********************************************************************/
+void RegSim_SetSysTickHandler(void (*Ptr2Func)(void));
+
+/**********************************************************************
+ * Service Name: RegSim_SetPendSVHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: Ptr2Func - Function called when the simulated PendSV
+ *             exception is taken (normally PendSV_Handler)
+ * Return Value: None
+ * Description: Connects the simulated PendSV exception to its handler in
+ * the reset vector table. PendSV is taken outside of the SysTick handler
+ * (tail-chained after it) while PRIMASK and BASEPRI allow its priority.
+ *********************************************************************/
+void RegSim_SetPendSVHandler(void (*Ptr2Func)(void));
+
+/**********************************************************************
+ * Service Name: RegSim_SetVectorTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Table - Vector table of REGSIM_VECTOR_COUNT entries
+ * Return Value: None
+ * Description: Models the VTABLE register: the simulated exceptions are
+ * taken through the entries of this table. RegSim_Reset selects the reset
+ * table again.
+ *********************************************************************/
+void RegSim_SetVectorTable(RegSim_HandlerType *a_Table);
+
+/**********************************************************************
+ * Service Name: RegSim_GetVectorTable
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Vector table in use
+ * Description: Returns the table selected by the VTABLE model.
+ *********************************************************************/
+RegSim_HandlerType *RegSim_GetVectorTable(void);
+
+/**********************************************************************
+ * Service Name: RegSim_SetPrimask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Masked - TRUE to mask the interrupts, FALSE to unmask them
+ * Return Value: None
+ * Description: Models the PRIMASK I-bit of the simulated core. Interrupts
+ * raised while masked are taken as soon as they are unmasked.
+ *********************************************************************/
+void RegSim_SetPrimask(boolean a_Masked);
+
+/**********************************************************************
+ * Service Name: RegSim_GetPrimask
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: TRUE if the interrupts are masked
+ * Description: Returns the PRIMASK I-bit of the simulated core.
+ *********************************************************************/
+boolean RegSim_GetPrimask(void);
+
+/**********************************************************************
+ * Service Name: RegSim_SetBasepri
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Basepri - Priority mask (priority in bits 7:5, 0 masks nothing)
+ * Return Value: None
+ * Description: Models the BASEPRI register of the simulated core: the
+ * SysTick interrupt is held while its preemption priority is not above
+ * BASEPRI.
+ *********************************************************************/
+void RegSim_SetBasepri(uint32 a_Basepri);
+
+/**********************************************************************
+ * Service Name: RegSim_GetBasepri
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: BASEPRI of the simulated core
+ * Description: Returns the BASEPRI register of the simulated core.
+ *********************************************************************/
+uint32 RegSim_GetBasepri(void);
+
+/**********************************************************************
+ * Service Name: RegSim_SetCyclesPerAccess
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Core cycles consumed by each counted access
+ * Return Value: None
+ * Description: Lets simulated time run while the driver accesses the
+ * registers, so that polling loops terminate. Zero (the default) freezes
+ * the time between two calls of RegSim_SysTickAdvance.
+ *********************************************************************/
+void RegSim_SetCyclesPerAccess(uint32 a_Cycles);
+
+/**********************************************************************
+ * Service Name: RegSim_SysTickAdvance
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: a_Cycles - Number of core cycles to be simulated
+ * Return Value: None
+ * Description: Runs the simulated SysTick counter for the given number of
+ * cycles, setting the COUNT flag and taking the SysTick interrupt on
+ * every wrap while it is enabled. The DWT cycle counter runs as well.
+ *********************************************************************/
+void RegSim_SysTickAdvance(uint32 a_Cycles);
+
+/**********************************************************************
+ * Service Name: RegSim_WaitForInterrupt
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: None
+ * Return Value: None
+ * Description: Models WFI: runs the simulated time until the SysTick
+ * interrupt is pending or taken (masked or not). Returns at once when an
+ * exception is pending or the SysTick interrupt is disabled.
+ *********************************************************************/
+void RegSim_WaitForInterrupt(void);
+
+/**********************************************************************
+ * Service Name: RegSim_GetSysTickIsrCount
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters: None
+ * Return Value: Number of simulated SysTick interrupts taken
+ * Description: Returns the number of SysTick handler entries since the
+ * last counter clear.
+ *********************************************************************/
+uint32 RegSim_GetSysTickIsrCount(void);
+
+#ifdef __cplusplus
+}
+
+/*******************************************************************************
+ *                           Register Proxy                                    *
+ *******************************************************************************/
+
+/* Stands for one memory mapped register in the driver expressions, every read
+ * and every write is forwarded to the simulated register file. */
+class RegSim_Register
+{
+public:
+    explicit RegSim_Register(RegSim_RegisterType a_Register) : m_Register(a_Register) {}
+
+    operator uint32() const { return RegSim_Read(m_Register); }
+
+    const RegSim_Register &operator=(uint32 a_Value) const
+    {
+        RegSim_Write(m_Register, a_Value);
+        return *this;
+    }
+
+    const RegSim_Register &operator|=(uint32 a_Value) const
+    {
+        RegSim_Write(m_Register, RegSim_Read(m_Register) | a_Value);
+        return *this;
+    }
+
+    const RegSim_Register &operator&=(uint32 a_Value) const
+    {
+        RegSim_Write(m_Register, RegSim_Read(m_Register) & a_Value);
+        return *this;
+    }
+
+    const RegSim_Register &operator^=(uint32 a_Value) const
+    {
+        RegSim_Write(m_Register, RegSim_Read(m_Register) ^ a_Value);
+        return *this;
+    }
+
+private:
+    RegSim_RegisterType m_Register;
+};
+
+#define REGSIM_REG(id)                       (RegSim_Register((RegSim_RegisterType)(id)))
+
+/* One byte of a byte accessible register */
+class RegSim_ByteRegister
+{
+public:
+    RegSim_ByteRegister(RegSim_RegisterType a_Register, uint8 a_Byte) : m_Register(a_Register), m_Byte(a_Byte) {}
+
+    operator uint8() const { return (uint8)(RegSim_Read(m_Register) >> (8 * m_Byte)); }
+
+    const RegSim_ByteRegister &operator=(uint8 a_Value) const
+    {
+        RegSim_WriteByte(m_Register, m_Byte, a_Value);
+        return *this;
+    }
+
+private:
+    RegSim_RegisterType m_Register;
+    uint8 m_Byte;
+};
+
+#define REGSIM_BYTE_REG(id, byte)            (RegSim_ByteRegister((RegSim_RegisterType)(id), (uint8)(byte)))
+
+/*******************************************************************************
+ *                       Simulated Register Definitions                        *
+ *******************************************************************************/
+#define SYSTICK_CTRL_REG                     REGSIM_REG(REGSIM_SYSTICK_CTRL)
+#define SYSTICK_RELOAD_REG                   REGSIM_REG(REGSIM_SYSTICK_RELOAD)
+#define SYSTICK_CURRENT_REG                  REGSIM_REG(REGSIM_SYSTICK_CURRENT)
+
+#define NVIC_EN_REG(n)                       REGSIM_REG(REGSIM_NVIC_EN0 + (n))
+#define NVIC_DIS_REG(n)                      REGSIM_REG(REGSIM_NVIC_DIS0 + (n))
+#define NVIC_PRI_REG(n)                      REGSIM_REG(REGSIM_NVIC_PRI0 + (n))
+#define NVIC_PEND_REG(n)                     REGSIM_REG(REGSIM_NVIC_PEND0 + (n))
+#define NVIC_UNPEND_REG(n)                   REGSIM_REG(REGSIM_NVIC_UNPEND0 + (n))
+#define NVIC_ACTIVE_REG(n)                   REGSIM_REG(REGSIM_NVIC_ACTIVE0 + (n))
+#define NVIC_SWTRIG_REG                      REGSIM_REG(REGSIM_NVIC_SWTRIG)
+
+#define NVIC_EN0_REG                         NVIC_EN_REG(0)
+#define NVIC_EN1_REG                         NVIC_EN_REG(1)
+#define NVIC_EN2_REG                         NVIC_EN_REG(2)
+#define NVIC_EN3_REG                         NVIC_EN_REG(3)
+#define NVIC_EN4_REG                         NVIC_EN_REG(4)
+
+#define NVIC_DIS0_REG                        NVIC_DIS_REG(0)
+#define NVIC_DIS1_REG                        NVIC_DIS_REG(1)
+#define NVIC_DIS2_REG                        NVIC_DIS_REG(2)
+#define NVIC_DIS3_REG                        NVIC_DIS_REG(3)
+#define NVIC_DIS4_REG                        NVIC_DIS_REG(4)
+
+#define NVIC_SYSTEM_PRI1_REG                 REGSIM_REG(REGSIM_NVIC_SYSTEM_PRI1)
+#define NVIC_SYSTEM_PRI2_REG                 REGSIM_REG(REGSIM_NVIC_SYSTEM_PRI2)
+#define NVIC_SYSTEM_PRI3_REG                 REGSIM_REG(REGSIM_NVIC_SYSTEM_PRI3)
+#define NVIC_PRI_BYTE_REG(IRQ_Num)           REGSIM_BYTE_REG(REGSIM_NVIC_PRI0 + ((IRQ_Num) >> 2), (IRQ_Num) & 3)
+#define NVIC_SYSTEM_PRI_BYTE_REG(Vector)     REGSIM_BYTE_REG(REGSIM_NVIC_SYSTEM_PRI1 + (((Vector) - 4) >> 2), ((Vector) - 4) & 3)
+#define NVIC_SYSTEM_SYSHNDCTRL               REGSIM_REG(REGSIM_NVIC_SYSTEM_SYSHNDCTRL)
+#define NVIC_SYSTEM_INTCTRL                  REGSIM_REG(REGSIM_NVIC_SYSTEM_INTCTRL)
+#define NVIC_APINT_REG                       REGSIM_REG(REGSIM_NVIC_APINT)
+
+#define DWT_CTRL_REG                         REGSIM_REG(REGSIM_DWT_CTRL)
+#define DWT_CYCCNT_REG                       REGSIM_REG(REGSIM_DWT_CYCCNT)
+#define CORE_DEMCR_REG                       REGSIM_REG(REGSIM_CORE_DEMCR)
+
+#endif /* __cplusplus */
+
+#endif /* REGSIM_H_ */
@@ -0,0 +1,214 @@
+/******************************************************************************
+ *
+ * Module: TraceDecode
+ *
+ * File Name: TraceDecode.c
+ *
+ * Description: Host tool converting a trace dump (Trace_HeaderType followed
+ *              by the records of Trace_Snapshot, little-endian, as written
+ *              out by the target or read with the debugger) into the Chrome
+ *              trace event format, to be opened in chrome://tracing or
+ *              Perfetto. Handlers become nested slices on one timeline,
+ *              ticks and markers become instant events.
+ *
+ *              Build: cc -I. -Ihost -o tracedecode host/TraceDecode.c
+ *              Usage: tracedecode dump.bin [trace.json]
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "Trace.h"
+
+/* Deepest handler nesting followed, exits without a known entry are dropped */
+#define TRACEDECODE_MAX_DEPTH                32
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Reads a little-endian word, FALSE at the end of the file */
+static boolean TraceDecode_ReadWord(FILE *a_File, uint32 *a_Word)
+{
+    uint8 bytes[4];
+
+    if (fread(bytes, 1, sizeof(bytes), a_File) != sizeof(bytes))
+    {
+        return FALSE;
+    }
+
+    *a_Word = (uint32)bytes[0] | ((uint32)bytes[1] << 8) | ((uint32)bytes[2] << 16) | ((uint32)bytes[3] << 24);
+    return TRUE;
+}
+
+/* Name of a handler from its exception number */
+static void TraceDecode_VectorName(uint8 a_Vector, char *a_Name, size_t a_Size)
+{
+    switch (a_Vector)
+    {
+    case 11:
+        snprintf(a_Name, a_Size, "SVCall");
+        break;
+    case 14:
+        snprintf(a_Name, a_Size, "PendSV");
+        break;
+    case TRACE_SYSTICK_VECTOR:
+        snprintf(a_Name, a_Size, "SysTick");
+        break;
+    default:
+        if (a_Vector >= 16)
+        {
+            snprintf(a_Name, a_Size, "IRQ %u", (unsigned)(a_Vector - 16));
+        }
+        else
+        {
+            snprintf(a_Name, a_Size, "Exception %u", (unsigned)a_Vector);
+        }
+        break;
+    }
+}
+
+/* Writes the records as Chrome trace events, time stamps in microseconds */
+static uint32 TraceDecode_Convert(FILE *a_In, FILE *a_Out, const Trace_HeaderType *a_Header)
+{
+    Trace_RecordType record;
+    char name[32];
+    sint64 cycles = 0;
+    uint32 previous = 0;
+    uint32 count = 0;
+    uint8 depth = 0;
+    double micros;
+    const char *separator = "";
+
+    fprintf(a_Out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    while ((count < a_Header->count) &&
+           TraceDecode_ReadWord(a_In, &record.timeStamp) && TraceDecode_ReadWord(a_In, &record.info))
+    {
+        //The stamps are 32-bit: unwrap them from the first record on. A handler
+        //preempting a record between its stamp and its slot leaves a newer stamp
+        //before an older one, so the step is signed
+        if (count != 0)
+        {
+            cycles += (sint32)(record.timeStamp - previous);
+        }
+        previous = record.timeStamp;
+        count++;
+        micros = ((double)cycles * 1000000.0) / (double)a_Header->clockHz;
+
+        switch (TRACE_INFO_EVENT(record.info))
+        {
+        case TRACE_EVENT_ISR_ENTER:
+        case TRACE_EVENT_ISR_EXIT:
+            if (TRACE_INFO_EVENT(record.info) == TRACE_EVENT_ISR_ENTER)
+            {
+                if (depth == TRACEDECODE_MAX_DEPTH)
+                {
+                    continue;
+                }
+                depth++;
+            }
+            else if (depth == 0)
+            {
+                continue; // Entered before the oldest record
+            }
+            else
+            {
+                depth--;
+            }
+            TraceDecode_VectorName(TRACE_INFO_VECTOR(record.info), name, sizeof(name));
+            fprintf(a_Out, "%s  {\"name\": \"%s\", \"ph\": \"%s\", \"ts\": %.3f, \"pid\": 0, \"tid\": 0}", separator,
+                    name, (TRACE_INFO_EVENT(record.info) == TRACE_EVENT_ISR_ENTER) ? "B" : "E", micros);
+            break;
+        case TRACE_EVENT_TICK:
+            fprintf(a_Out, "%s  {\"name\": \"Tick\", \"ph\": \"i\", \"s\": \"g\", \"ts\": %.3f, \"pid\": 0, \"tid\": 0, "
+                    "\"args\": {\"ticks\": %u}}", separator, micros, (unsigned)TRACE_INFO_DATA(record.info));
+            break;
+        case TRACE_EVENT_MARKER:
+            fprintf(a_Out, "%s  {\"name\": \"Marker %u\", \"ph\": \"i\", \"s\": \"t\", \"ts\": %.3f, \"pid\": 0, \"tid\": 0, "
+                    "\"args\": {\"data\": %u}}", separator, (unsigned)TRACE_INFO_VECTOR(record.info), micros,
+                    (unsigned)TRACE_INFO_DATA(record.info));
+            break;
+        default:
+            continue; // Unknown event
+        }
+        separator = ",\n";
+    }
+
+    //Close the handlers still running at the last record
+    while (depth != 0)
+    {
+        fprintf(a_Out, "%s  {\"ph\": \"E\", \"ts\": %.3f, \"pid\": 0, \"tid\": 0}", separator,
+                ((double)cycles * 1000000.0) / (double)a_Header->clockHz);
+        separator = ",\n";
+        depth--;
+    }
+    fprintf(a_Out, "\n]}\n");
+
+    return count;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+/**********************************************************************
+ * Service Name: main
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-Reentrant
+ * Parameters: argv[1] - Trace dump, argv[2] - JSON output (stdout if absent)
+ * Return Value: 0 on success, 1 if the dump cannot be read
+ * Description: Checks the dump header and writes the Chrome trace.
+ *********************************************************************/
+int main(int argc, char **argv)
+{
+    Trace_HeaderType header;
+    FILE *in;
+    FILE *out = stdout;
+    uint32 count;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "usage: %s dump.bin [trace.json]\n", argv[0]);
+        return 1;
+    }
+
+    in = fopen(argv[1], "rb");
+    if (in == NULL_PTR)
+    {
+        fprintf(stderr, "%s: cannot open\n", argv[1]);
+        return 1;
+    }
+
+    if (!TraceDecode_ReadWord(in, &header.magic) || !TraceDecode_ReadWord(in, &header.clockHz) ||
+        !TraceDecode_ReadWord(in, &header.count) || !TraceDecode_ReadWord(in, &header.lost) ||
+        (header.magic != TRACE_MAGIC) || (header.clockHz == 0))
+    {
+        fprintf(stderr, "%s: not a trace dump\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+
+    if ((argc == 3) && ((out = fopen(argv[2], "w")) == NULL_PTR))
+    {
+        fprintf(stderr, "%s: cannot write\n", argv[2]);
+        fclose(in);
+        return 1;
+    }
+
+    count = TraceDecode_Convert(in, out, &header);
+    fclose(in);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    fprintf(stderr, "%lu records, %lu lost before the dump\n", (unsigned long)count, (unsigned long)header.lost);
+    if (count < header.count)
+    {
+        fprintf(stderr, "%s: truncated, %lu records expected\n", argv[1], (unsigned long)header.count);
+    }
+
+    return 0;
+}
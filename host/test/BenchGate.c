@@ -0,0 +1,61 @@
+/******************************************************************************
+ *
+ * Module: BenchGate
+ *
+ * File Name: BenchGate.c
+ *
+ * Description: Host regression gate of the API cost benchmark: runs
+ *              Bench_RunDrivers and compares the register accesses and the
+ *              access cycles of each API with a checked-in baseline.
+ *              Exits with 1 if the baseline cannot be read or an API got
+ *              more expensive.
+ *
+ *              Usage: BenchGate baseline.json [results.json], the results
+ *              file (if given) is written before the comparison and is the
+ *              new baseline after an intended change.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "Bench.h"
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    static Bench_ResultType s_Results[BENCH_MAX_RESULTS];
+    static Bench_ResultType s_Baseline[BENCH_MAX_RESULTS];
+    uint8 count;
+    uint8 baselineCount;
+    uint8 regressions;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s baseline.json [results.json]\n", argv[0]);
+        return 1;
+    }
+
+    count = Bench_RunDrivers(s_Results, BENCH_MAX_RESULTS);
+    if ((argc > 2) && !Bench_WriteJson(argv[2], s_Results, count))
+    {
+        fprintf(stderr, "%s: cannot be written\n", argv[2]);
+        return 1;
+    }
+
+    baselineCount = Bench_ReadJson(argv[1], s_Baseline, BENCH_MAX_RESULTS);
+    if (baselineCount == 0)
+    {
+        fprintf(stderr, "%s: no baseline entries\n", argv[1]);
+        return 1;
+    }
+
+    regressions = Bench_Compare(s_Baseline, baselineCount, s_Results, count);
+    printf("BenchGate: %u APIs measured, %u in the baseline, %u regressions\n", (unsigned)count,
+           (unsigned)baselineCount, (unsigned)regressions);
+    return (regressions == 0) ? 0 : 1;
+}
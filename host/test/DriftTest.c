@@ -0,0 +1,195 @@
+/******************************************************************************
+ *
+ * Module: DriftTest
+ *
+ * File Name: DriftTest.c
+ *
+ * Description: Host test of the fractional SysTick time base: runs a
+ *              fractional period, with or without a clock trim, for a
+ *              billion ticks on the RegSim backend and checks at every
+ *              tick that the cycle time stamp, and the simulated time
+ *              itself (the cycles the counter was run for), stay within a
+ *              few cycles of the ideal time, i.e. that no error
+ *              accumulates in the time base nor in the reloads.
+ *
+ *              Usage: DriftTest [case [ticks]], all the cases for 1e9
+ *              ticks by default.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SysTick.h"
+#include "RegSim.h"
+
+/* Largest distance allowed between the time stamp or the simulated time
+ * and the ideal time */
+#define DRIFTTEST_MAX_ERROR_CYCLES           4
+
+#define DRIFTTEST_DEFAULT_TICKS              1000000000ULL
+
+#define DRIFTTEST_PPB                        1000000000ULL
+
+typedef struct
+{
+    const char *name;
+    uint32 clockHz;
+    uint32 numerator;                  /* Period in seconds: numerator / denominator */
+    uint32 denominator;
+    sint32 trimPpb;
+} DriftTest_CaseType;
+
+static const DriftTest_CaseType g_DriftTestCases[] =
+{
+    {"1/3 ms at 16MHz", 16000000UL, 1, 3000, 0},
+    {"1/60 s at 16MHz", 16000000UL, 1, 60, 0},
+    {"1/3 ms at 16MHz, +12345 ppb", 16000000UL, 1, 3000, 12345},
+    {"7/9999 s at 80MHz, -987654 ppb", 80000000UL, 7, 9999, -987654},
+};
+
+#define DRIFTTEST_CASES                      (sizeof(g_DriftTestCases) / sizeof(g_DriftTestCases[0]))
+
+static volatile uint64 g_DriftTestTicks = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void DriftTest_CallBack(void)
+{
+    g_DriftTestTicks++;
+}
+
+/*
+ * Runs a_Ticks periods wrap by wrap. The ideal time after k ticks is
+ * k * clock * numerator * (1e9 + trim) / (denominator * 1e9) cycles, kept as a
+ * whole part and a remainder so that it stays exact for any tick count.
+ */
+static boolean DriftTest_Run(const DriftTest_CaseType *a_Case, uint64 a_Ticks)
+{
+    uint64 denominator = (uint64)a_Case->denominator * DRIFTTEST_PPB;
+    uint64 step = (uint64)a_Case->clockHz * a_Case->numerator * (uint64)(DRIFTTEST_PPB + a_Case->trimPpb);
+    uint64 stepCycles = step / denominator;
+    uint64 stepRemainder = step % denominator;
+    uint64 idealCycles = 0;
+    uint64 idealRemainder = 0;
+    uint64 start;
+    uint64 ticks = 0;
+    uint64 advanced = 0;
+    uint32 wrap;
+    sint64 error;
+    sint64 minError = 0;
+    sint64 maxError = 0;
+    sint64 hardwareError;
+    sint64 minHardwareError = 0;
+    sint64 maxHardwareError = 0;
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SysTick_SetCallBack(DriftTest_CallBack);
+    if (!SysTick_SetCoreClock(a_Case->clockHz))
+    {
+        printf("%s: clock rejected\n", a_Case->name);
+        return FALSE;
+    }
+    SysTick_SetTrim(a_Case->trimPpb);
+    if (!SysTick_InitFractional(a_Case->numerator, a_Case->denominator))
+    {
+        printf("%s: period rejected\n", a_Case->name);
+        return FALSE;
+    }
+
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+    start = SysTick_GetTicks();
+    g_DriftTestTicks = 0;
+
+    while (ticks < a_Ticks)
+    {
+        wrap = RegSim_Peek(REGSIM_SYSTICK_CURRENT) + 1;
+        RegSim_SysTickAdvance(wrap); // To the next wrap, where the handler calls back
+        advanced += wrap;
+        if (g_DriftTestTicks != (ticks + 1))
+        {
+            printf("%s: %llu callbacks after %llu ticks\n", a_Case->name, (unsigned long long)g_DriftTestTicks,
+                   (unsigned long long)ticks);
+            return FALSE;
+        }
+        ticks = g_DriftTestTicks;
+
+        idealCycles += stepCycles;
+        idealRemainder += stepRemainder;
+        if (idealRemainder >= denominator)
+        {
+            idealRemainder -= denominator;
+            idealCycles++;
+        }
+
+        error = (sint64)((SysTick_GetTicks() - start) - idealCycles);
+        minError = (error < minError) ? error : minError;
+        maxError = (error > maxError) ? error : maxError;
+        if ((error > DRIFTTEST_MAX_ERROR_CYCLES) || (error < -DRIFTTEST_MAX_ERROR_CYCLES))
+        {
+            printf("%s: %lld cycles off after %llu ticks\n", a_Case->name, (long long)error, (unsigned long long)ticks);
+            return FALSE;
+        }
+
+        //The time stamp follows the reloads, the reloads must follow the ideal time
+        hardwareError = (sint64)(advanced - idealCycles);
+        minHardwareError = (hardwareError < minHardwareError) ? hardwareError : minHardwareError;
+        maxHardwareError = (hardwareError > maxHardwareError) ? hardwareError : maxHardwareError;
+        if ((hardwareError > DRIFTTEST_MAX_ERROR_CYCLES) || (hardwareError < -DRIFTTEST_MAX_ERROR_CYCLES))
+        {
+            printf("%s: simulated time %lld cycles off after %llu ticks\n", a_Case->name, (long long)hardwareError,
+                   (unsigned long long)ticks);
+            return FALSE;
+        }
+    }
+
+    SysTick_SetCallBack(NULL_PTR);
+    SysTick_DeInit();
+    SysTick_SetTrim(0);
+    printf("%s: %llu ticks, error %lld to %lld cycles (simulated time %lld to %lld)\n", a_Case->name,
+           (unsigned long long)ticks, (long long)minError, (long long)maxError, (long long)minHardwareError,
+           (long long)maxHardwareError);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    uint64 ticks = DRIFTTEST_DEFAULT_TICKS;
+    uint32 first = 0;
+    uint32 last = DRIFTTEST_CASES - 1;
+    uint32 index;
+
+    if (argc > 1)
+    {
+        first = (uint32)strtoul(argv[1], NULL_PTR, 10);
+        last = first;
+        if (first >= DRIFTTEST_CASES)
+        {
+            fprintf(stderr, "usage: %s [case (0 to %u) [ticks]]\n", argv[0], (unsigned)(DRIFTTEST_CASES - 1));
+            return 1;
+        }
+    }
+    if (argc > 2)
+    {
+        ticks = strtoull(argv[2], NULL_PTR, 10);
+    }
+
+    for (index = first; index <= last; index++)
+    {
+        if (!DriftTest_Run(&g_DriftTestCases[index], ticks))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
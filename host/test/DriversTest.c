@@ -0,0 +1,267 @@
+/******************************************************************************
+ *
+ * Module: DriversTest
+ *
+ * File Name: DriversTest.c
+ *
+ * Description: Host regression test of the NVIC and SysTick drivers on the
+ *              RegSim backend: register semantics seen by the drivers, the
+ *              register accesses of the basic calls and the periodic
+ *              SysTick interrupt. Also built with NVIC_SHADOW_ENABLE=1
+ *              (DriversTestShadow). Exits with 1 on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "NVIC.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define DRIVERSTEST_CHECK(Condition)                                                  \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* Active and pending bits of SYSHNDCTRL: SVCall pending, SysTick active */
+#define DRIVERSTEST_SYSHNDCTRL_STATE         0x00008800
+
+static uint32 g_DriversTestCallBacks = 0;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void DriversTest_CallBack(void)
+{
+    g_DriversTestCallBacks++;
+}
+
+/* Reset of the simulated core, the shadow follows the registers as after a real reset */
+static void DriversTest_Reset(void)
+{
+    RegSim_Reset();
+#if NVIC_SHADOW_ENABLE
+    NVIC_ShadowResync();
+#endif
+}
+
+/* ENn is write-1-to-set, DISn write-1-to-clear: one store per call, no read */
+static boolean DriversTest_Enable(void)
+{
+    DriversTest_Reset();
+    NVIC_EnableIRQ(5);
+    NVIC_EnableIRQ(40);
+    NVIC_DisableIRQ(5);
+
+    DRIVERSTEST_CHECK(RegSim_Peek(REGSIM_NVIC_EN0) == 0);
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 1)) == (1UL << 8));
+    DRIVERSTEST_CHECK(NVIC_IsIRQEnabled(40) && !NVIC_IsIRQEnabled(5));
+    DRIVERSTEST_CHECK(RegSim_GetWriteCount(REGSIM_NVIC_EN0) == 1);
+    DRIVERSTEST_CHECK(RegSim_GetWriteCount((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 1)) == 1);
+    DRIVERSTEST_CHECK(RegSim_GetWriteCount(REGSIM_NVIC_DIS0) == 1);
+
+    /* The last IRQ of the vector table is in EN4 */
+    NVIC_EnableIRQ(NVIC_VECTOR_IRQS - 1);
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 4)) == (1UL << 10));
+    DRIVERSTEST_CHECK(NVIC_IsIRQEnabled(NVIC_VECTOR_IRQS - 1));
+    NVIC_DisableIRQ(NVIC_VECTOR_IRQS - 1);
+    DRIVERSTEST_CHECK(!NVIC_IsIRQEnabled(NVIC_VECTOR_IRQS - 1));
+    return TRUE;
+}
+
+/* A priority lands in bits 7:5 of its byte in PRIn, the other IRQs keep theirs */
+static boolean DriversTest_Priority(void)
+{
+    DriversTest_Reset();
+    NVIC_SetPriorityIRQ(5, 2);
+    NVIC_SetPriorityIRQ(6, 5);
+    NVIC_SetPriorityIRQ(138, 4); // Byte 2 of PRI34
+    NVIC_SetPriorityIRQ(NVIC_VECTOR_IRQS, 7); // Out of range, ignored
+
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + 1)) == 0x00A04000);
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + 34)) == 0x00800000);
+    DRIVERSTEST_CHECK(NVIC_GetPriorityIRQ(5) == 2);
+    DRIVERSTEST_CHECK(NVIC_GetPriorityIRQ(6) == 5);
+    DRIVERSTEST_CHECK((NVIC_GetPriorityIRQ(138) == 4) && (NVIC_GetPriorityIRQ(NVIC_VECTOR_IRQS) == 0));
+
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 3);
+    DRIVERSTEST_CHECK(NVIC_GetPriorityException(EXCEPTION_SYSTICK_TYPE) == 3);
+    return TRUE;
+}
+
+/* 1 ms period at 16MHz: one interrupt and 16000 cycles per period */
+static boolean DriversTest_Periodic(void)
+{
+    DriversTest_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    g_DriversTestCallBacks = 0;
+    SysTick_SetCallBack(DriversTest_CallBack);
+    SysTick_Init(1);
+
+    DRIVERSTEST_CHECK(RegSim_Peek(REGSIM_SYSTICK_RELOAD) == 15999);
+    DRIVERSTEST_CHECK((RegSim_Peek(REGSIM_SYSTICK_CTRL) & 0x7) == 0x7);
+
+    RegSim_SysTickAdvance(1 + (10 * 16000UL)); // The counter loads on the first cycle
+    DRIVERSTEST_CHECK(g_DriversTestCallBacks == 10);
+    DRIVERSTEST_CHECK(RegSim_GetSysTickIsrCount() == 10);
+    DRIVERSTEST_CHECK(SysTick_GetTicks() == (10 * 16000ULL));
+
+    SysTick_SetCallBack(NULL_PTR);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/* The delays end on the counter alone, also with the interrupt masked */
+static boolean DriversTest_Delay(void)
+{
+    NVIC_CriticalStateType state;
+    uint32 control;
+
+    DriversTest_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    RegSim_SetCyclesPerAccess(10);
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(10);
+
+    state = NVIC_EnterCritical(0);
+    RegSim_ClearCounters();
+    SysTick_DelayCycles(50000);
+    NVIC_ExitCritical(state);
+    DRIVERSTEST_CHECK(((RegSim_GetTotalReads() + RegSim_GetTotalWrites()) * 10) >= 50000);
+
+    /* A stopped SysTick runs free for the wait, then is stopped as it was */
+    SysTick_DeInit();
+    RegSim_Poke(REGSIM_SYSTICK_RELOAD, 1234);
+    control = RegSim_Peek(REGSIM_SYSTICK_CTRL);
+    RegSim_ClearCounters();
+    SysTick_DelayCycles(50000);
+    DRIVERSTEST_CHECK(((RegSim_GetTotalReads() + RegSim_GetTotalWrites()) * 10) >= 50000);
+    DRIVERSTEST_CHECK((RegSim_Peek(REGSIM_SYSTICK_CTRL) == control) && ((control & 0x1) == 0));
+    DRIVERSTEST_CHECK(RegSim_Peek(REGSIM_SYSTICK_RELOAD) == 1234);
+
+    SysTick_StartBusyWait(2);
+    DRIVERSTEST_CHECK((RegSim_Peek(REGSIM_SYSTICK_CTRL) & 0x1) == 0);
+    return TRUE;
+}
+
+/* The checksum documented in NVIC.c, to forge contexts past it */
+static uint32 DriversTest_Checksum(const NVIC_ContextType *a_Context)
+{
+    const uint32 *word = (const uint32 *)a_Context;
+    uint32 sum = 0;
+    uint8 index;
+
+    for (index = 0; index < ((sizeof(NVIC_ContextType) / sizeof(uint32)) - 1); index++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + word[index];
+    }
+
+    return ~sum;
+}
+
+/*
+ * Save, scramble every saved register, restore: the configuration comes
+ * back and the active and pending bits of SYSHNDCTRL (set by the handlers
+ * running) are kept. A bad checksum or magic writes nothing.
+ */
+static boolean DriversTest_Context(void)
+{
+    NVIC_ContextType context;
+    NVIC_ContextType forged;
+    uint8 index;
+
+    DriversTest_Reset();
+    NVIC_EnableIRQ(5);
+    NVIC_EnableIRQ(40);
+    NVIC_EnableIRQ(127);
+    NVIC_EnableIRQ(130);
+    NVIC_SetPriorityIRQ(5, 2);
+    NVIC_SetPriorityIRQ(137, 5);
+    NVIC_SetPriorityIRQ(100, 6);
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 3);
+    NVIC_SetPriorityException(EXCEPTION_SVC_TYPE, 1);
+    NVIC_SetPriorityGrouping(NVIC_PRIORITY_GROUP_2_1);
+    NVIC_EnableException(EXCEPTION_BUS_FAULT_TYPE);
+    NVIC_EnableException(EXCEPTION_USAGE_FAULT_TYPE);
+    NVIC_SaveContext(&context);
+
+    for (index = 0; index < NVIC_IRQ_MASK_WORDS; index++)
+    {
+        RegSim_Poke((RegSim_RegisterType)(REGSIM_NVIC_EN0 + index), 0xFFFFFFFF);
+    }
+    for (index = 0; index < NVIC_PRI_REGISTERS; index++)
+    {
+        RegSim_Poke((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + index), 0xE0E0E0E0);
+    }
+    RegSim_Poke(REGSIM_NVIC_SYSTEM_PRI2, 0);
+    RegSim_Poke(REGSIM_NVIC_SYSTEM_PRI3, 0);
+    RegSim_Poke(REGSIM_NVIC_SYSTEM_SYSHNDCTRL, MEM_FAULT_ENABLE_MASK | DRIVERSTEST_SYSHNDCTRL_STATE);
+    NVIC_SetPriorityGrouping(NVIC_PRIORITY_GROUP_0_3);
+
+    DRIVERSTEST_CHECK(NVIC_RestoreContext(&context));
+    DRIVERSTEST_CHECK(RegSim_Peek(REGSIM_NVIC_EN0) == (1UL << 5));
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 1)) == (1UL << 8));
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 2)) == 0);
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 3)) == (1UL << 31));
+    DRIVERSTEST_CHECK(RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 4)) == (1UL << 2));
+    DRIVERSTEST_CHECK(NVIC_GetPriorityIRQ(137) == 5);
+    DRIVERSTEST_CHECK((NVIC_GetPriorityIRQ(5) == 2) && (NVIC_GetPriorityIRQ(100) == 6) && (NVIC_GetPriorityIRQ(6) == 0));
+    DRIVERSTEST_CHECK(NVIC_GetPriorityException(EXCEPTION_SYSTICK_TYPE) == 3);
+    DRIVERSTEST_CHECK(NVIC_GetPriorityException(EXCEPTION_SVC_TYPE) == 1);
+    DRIVERSTEST_CHECK(NVIC_GetPriorityGrouping() == NVIC_PRIORITY_GROUP_2_1);
+    DRIVERSTEST_CHECK(RegSim_Peek(REGSIM_NVIC_SYSTEM_SYSHNDCTRL) ==
+                      (BUS_FAULT_ENABLE_MASK | USAGE_FAULT_ENABLE_MASK | DRIVERSTEST_SYSHNDCTRL_STATE));
+#if NVIC_SHADOW_ENABLE
+    DRIVERSTEST_CHECK(NVIC_ShadowVerify());
+#endif
+
+    /* A corrupted word fails the checksum */
+    forged = context;
+    forged.priority[1] ^= 0x00002000; // IRQ 5 from 2 to 3
+    RegSim_ClearCounters();
+    DRIVERSTEST_CHECK(!NVIC_RestoreContext(&forged));
+    DRIVERSTEST_CHECK(RegSim_GetTotalWrites() == 0);
+
+    /* The checksum of the test is the driver's: a consistent edit is taken */
+    forged.checksum = DriversTest_Checksum(&forged);
+    DRIVERSTEST_CHECK(NVIC_RestoreContext(&forged));
+    DRIVERSTEST_CHECK(NVIC_GetPriorityIRQ(5) == 3);
+
+    /* A wrong magic fails even with its checksum right, zeroed RAM fails too */
+    forged = context;
+    forged.magic ^= 1;
+    forged.checksum = DriversTest_Checksum(&forged);
+    RegSim_ClearCounters();
+    DRIVERSTEST_CHECK(!NVIC_RestoreContext(&forged));
+    for (index = 0; index < (sizeof(NVIC_ContextType) / sizeof(uint32)); index++)
+    {
+        ((uint32 *)&forged)[index] = 0;
+    }
+    DRIVERSTEST_CHECK(!NVIC_RestoreContext(&forged));
+    DRIVERSTEST_CHECK(RegSim_GetTotalWrites() == 0);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!DriversTest_Enable() || !DriversTest_Priority() || !DriversTest_Periodic() || !DriversTest_Delay() ||
+        !DriversTest_Context())
+    {
+        return 1;
+    }
+
+    printf("DriversTest: all checks passed\n");
+    return 0;
+}
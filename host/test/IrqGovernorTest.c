@@ -0,0 +1,208 @@
+/******************************************************************************
+ *
+ * Module: IrqGovernorTest
+ *
+ * File Name: IrqGovernorTest.c
+ *
+ * Description: Host test of the interrupt load governor, built with
+ *              ISRSTATS_ENABLE=1 and IRQGOVERNOR_ENABLE=1 on the RegSim
+ *              backend. The handlers of the governed IRQs are played by the
+ *              test (IsrStats hooks around simulated time), the windows are
+ *              sampled by the real SysTick_Handler. Checks the masking of
+ *              two vectors over budget (DIS stores), the
+ *              IRQGOVERNOR_HOLD_WINDOWS hold, the release only once the
+ *              total load is low (EN stores) and the statistics. Exits with
+ *              1 on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "IrqGovernor.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define IRQGOVERNORTEST_CHECK(Condition)                                              \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz, 10 ms windows */
+#define IRQGOVERNORTEST_TICK_CYCLES          16000UL
+#define IRQGOVERNORTEST_WINDOW_TICKS         10
+#define IRQGOVERNORTEST_WINDOW_CYCLES        (IRQGOVERNORTEST_WINDOW_TICKS * IRQGOVERNORTEST_TICK_CYCLES)
+#define IRQGOVERNORTEST_RELEASE              100
+
+/* Governed UART (IRQ 5, EN0/DIS0 bit 5) and CAN (IRQ 39, EN1/DIS1 bit 7)
+ * handlers, and an ungoverned handler that only adds load */
+#define IRQGOVERNORTEST_UART_VECTOR          1
+#define IRQGOVERNORTEST_UART_IRQ             5
+#define IRQGOVERNORTEST_UART_BUDGET          100
+#define IRQGOVERNORTEST_CAN_VECTOR           2
+#define IRQGOVERNORTEST_CAN_IRQ              39
+#define IRQGOVERNORTEST_CAN_BUDGET           200
+#define IRQGOVERNORTEST_OTHER_VECTOR         3
+
+#define IRQGOVERNORTEST_EN1                  ((RegSim_RegisterType)(REGSIM_NVIC_EN0 + 1))
+#define IRQGOVERNORTEST_DIS1                 ((RegSim_RegisterType)(REGSIM_NVIC_DIS0 + 1))
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* One run of an instrumented handler taking a_Cycles */
+static void IrqGovernorTest_Handler(IsrStats_VectorType a_Vector, uint32 a_Cycles)
+{
+    if (a_Cycles != 0)
+    {
+        IsrStats_Enter(a_Vector, ISRSTATS_NO_LATENCY);
+        RegSim_SysTickAdvance(a_Cycles);
+        IsrStats_Exit(a_Vector);
+    }
+}
+
+/* One window: the handlers run back to back at its start, the rest is idle */
+static void IrqGovernorTest_Window(uint32 a_Uart, uint32 a_Can, uint32 a_Other)
+{
+    IrqGovernorTest_Handler(IRQGOVERNORTEST_UART_VECTOR, a_Uart);
+    IrqGovernorTest_Handler(IRQGOVERNORTEST_CAN_VECTOR, a_Can);
+    IrqGovernorTest_Handler(IRQGOVERNORTEST_OTHER_VECTOR, a_Other);
+    RegSim_SysTickAdvance(IRQGOVERNORTEST_WINDOW_CYCLES - (a_Uart + a_Can + a_Other));
+}
+
+static boolean IrqGovernorTest_IsEnabled(NVIC_IRQType a_IRQ)
+{
+    return (RegSim_Peek((RegSim_RegisterType)(REGSIM_NVIC_EN0 + (a_IRQ / 32))) & (1UL << (a_IRQ % 32))) != 0;
+}
+
+/*
+ * Window 1: UART 250 permille (budget 100), CAN 300 (budget 200), both are
+ * masked. Window 2: quiet but held. Window 3: held long enough, but the
+ * ungoverned handler keeps the load at 200, over the release. Window 4:
+ * quiet, both enabled again.
+ */
+static boolean IrqGovernorTest_Throttle(void)
+{
+    IrqGovernor_SourceType uart;
+    IrqGovernor_SourceType can;
+    IrqGovernor_SourceStatsType stats;
+    IrqGovernor_LoadType load;
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    IsrStats_Init();
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+
+    IRQGOVERNORTEST_CHECK(IrqGovernor_Init(IRQGOVERNORTEST_WINDOW_TICKS, IRQGOVERNORTEST_RELEASE));
+    uart = IrqGovernor_Register(IRQGOVERNORTEST_UART_VECTOR, IRQGOVERNORTEST_UART_IRQ, IRQGOVERNORTEST_UART_BUDGET);
+    can = IrqGovernor_Register(IRQGOVERNORTEST_CAN_VECTOR, IRQGOVERNORTEST_CAN_IRQ, IRQGOVERNORTEST_CAN_BUDGET);
+    IRQGOVERNORTEST_CHECK((uart != IRQGOVERNOR_INVALID_SOURCE) && (can != IRQGOVERNOR_INVALID_SOURCE));
+    IRQGOVERNORTEST_CHECK(IrqGovernor_Register(ISRSTATS_MAX_VECTORS, 0, 0) == IRQGOVERNOR_INVALID_SOURCE);
+    NVIC_EnableIRQ(IRQGOVERNORTEST_UART_IRQ);
+    NVIC_EnableIRQ(IRQGOVERNORTEST_CAN_IRQ);
+    RegSim_ClearCounters();
+
+    IrqGovernorTest_Window(40000, 48000, 0);
+    IRQGOVERNORTEST_CHECK((RegSim_GetWriteCount(REGSIM_NVIC_DIS0) == 1) && (RegSim_GetWriteCount(IRQGOVERNORTEST_DIS1) == 1));
+    IRQGOVERNORTEST_CHECK(!IrqGovernorTest_IsEnabled(IRQGOVERNORTEST_UART_IRQ));
+    IRQGOVERNORTEST_CHECK(!IrqGovernorTest_IsEnabled(IRQGOVERNORTEST_CAN_IRQ));
+    IRQGOVERNORTEST_CHECK(IrqGovernor_GetSourceStats(uart, &stats));
+    IRQGOVERNORTEST_CHECK(stats.throttled && (stats.throttles == 1) && (stats.share == 250));
+    IRQGOVERNORTEST_CHECK(IrqGovernor_GetSourceStats(can, &stats));
+    IRQGOVERNORTEST_CHECK(stats.throttled && (stats.share == 300));
+    IrqGovernor_GetLoad(&load);
+    IRQGOVERNORTEST_CHECK((load.load == 550) && (load.windows == 1));
+
+    /* Held for IRQGOVERNOR_HOLD_WINDOWS windows whatever the load */
+    IrqGovernorTest_Window(0, 0, 0);
+    IRQGOVERNORTEST_CHECK(IRQGOVERNOR_HOLD_WINDOWS == 2);
+    IRQGOVERNORTEST_CHECK((RegSim_GetWriteCount(REGSIM_NVIC_EN0) == 0) && (RegSim_GetWriteCount(IRQGOVERNORTEST_EN1) == 0));
+
+    /* Held long enough, but the total load is over the release */
+    IrqGovernorTest_Window(0, 0, 32000);
+    IRQGOVERNORTEST_CHECK((RegSim_GetWriteCount(REGSIM_NVIC_EN0) == 0) && (RegSim_GetWriteCount(IRQGOVERNORTEST_EN1) == 0));
+    IrqGovernor_GetLoad(&load);
+    IRQGOVERNORTEST_CHECK(load.load == 200);
+
+    IrqGovernorTest_Window(0, 0, 0);
+    IRQGOVERNORTEST_CHECK((RegSim_GetWriteCount(REGSIM_NVIC_EN0) == 1) && (RegSim_GetWriteCount(IRQGOVERNORTEST_EN1) == 1));
+    IRQGOVERNORTEST_CHECK(IrqGovernorTest_IsEnabled(IRQGOVERNORTEST_UART_IRQ));
+    IRQGOVERNORTEST_CHECK(IrqGovernorTest_IsEnabled(IRQGOVERNORTEST_CAN_IRQ));
+    IRQGOVERNORTEST_CHECK(IrqGovernor_GetSourceStats(uart, &stats));
+    IRQGOVERNORTEST_CHECK(!stats.throttled && (stats.throttledWindows == 3) && (stats.peakShare == 250));
+    IrqGovernor_GetLoad(&load);
+    IRQGOVERNORTEST_CHECK((load.peakLoad == 550) && (load.windows == 4));
+
+    /* Within budget: no further store */
+    IrqGovernorTest_Window(16000, 32000, 0);
+    IRQGOVERNORTEST_CHECK((RegSim_GetWriteCount(REGSIM_NVIC_DIS0) == 1) && (RegSim_GetWriteCount(IRQGOVERNORTEST_DIS1) == 1));
+
+    IrqGovernor_Stop();
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*
+ * The UART handler preempted by the CAN handler: the nested time is the
+ * CAN's only, so the UART stays within its budget and is not masked.
+ */
+static boolean IrqGovernorTest_Nested(void)
+{
+    IrqGovernor_SourceType uart;
+    IrqGovernor_SourceType can;
+    IrqGovernor_SourceStatsType stats;
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    IsrStats_Init();
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1);
+
+    IRQGOVERNORTEST_CHECK(IrqGovernor_Init(IRQGOVERNORTEST_WINDOW_TICKS, IRQGOVERNORTEST_RELEASE));
+    uart = IrqGovernor_Register(IRQGOVERNORTEST_UART_VECTOR, IRQGOVERNORTEST_UART_IRQ, IRQGOVERNORTEST_UART_BUDGET);
+    can = IrqGovernor_Register(IRQGOVERNORTEST_CAN_VECTOR, IRQGOVERNORTEST_CAN_IRQ, 500);
+    NVIC_EnableIRQ(IRQGOVERNORTEST_UART_IRQ);
+    NVIC_EnableIRQ(IRQGOVERNORTEST_CAN_IRQ);
+    RegSim_ClearCounters();
+
+    /* UART 8000 cycles of its own (50 permille) around 40000 of CAN (250) */
+    IsrStats_Enter(IRQGOVERNORTEST_UART_VECTOR, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(4000);
+    IrqGovernorTest_Handler(IRQGOVERNORTEST_CAN_VECTOR, 40000);
+    RegSim_SysTickAdvance(4000);
+    IsrStats_Exit(IRQGOVERNORTEST_UART_VECTOR);
+    RegSim_SysTickAdvance(IRQGOVERNORTEST_WINDOW_CYCLES - 48000);
+
+    IRQGOVERNORTEST_CHECK(IrqGovernor_GetSourceStats(uart, &stats));
+    IRQGOVERNORTEST_CHECK(!stats.throttled && (stats.share == 50));
+    IRQGOVERNORTEST_CHECK(IrqGovernor_GetSourceStats(can, &stats));
+    IRQGOVERNORTEST_CHECK(!stats.throttled && (stats.share == 250));
+    IRQGOVERNORTEST_CHECK(RegSim_GetWriteCount(REGSIM_NVIC_DIS0) == 0);
+
+    IrqGovernor_Stop();
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!IrqGovernorTest_Throttle() || !IrqGovernorTest_Nested())
+    {
+        return 1;
+    }
+
+    printf("IrqGovernorTest: all checks passed\n");
+    return 0;
+}
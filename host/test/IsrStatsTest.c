@@ -0,0 +1,222 @@
+/******************************************************************************
+ *
+ * Module: IsrStatsTest
+ *
+ * File Name: IsrStatsTest.c
+ *
+ * Description: Host test of the interrupt instrumentation, built with
+ *              ISRSTATS_ENABLE=1 on the RegSim backend (DWT time stamps).
+ *              The handlers are played by the test: it calls the hooks and
+ *              advances the simulated time in between. Checks the run time
+ *              of nested handlers, the latency statistics and histogram,
+ *              SysTick_Handler preempting an instrumented handler and a
+ *              nesting deeper than ISRSTATS_MAX_NESTING. Exits with 1 on the
+ *              first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "IsrStats.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define ISRSTATSTEST_CHECK(Condition)                                                 \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* Slots of the handlers played by the test (slot 0 is SysTick_Handler) */
+#define ISRSTATSTEST_LOW                     1
+#define ISRSTATSTEST_MID                     2
+#define ISRSTATSTEST_HIGH                    3
+
+#define ISRSTATSTEST_CALLBACK_READS          500
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void IsrStatsTest_Start(void)
+{
+    RegSim_Reset();
+    IsrStats_Init();
+}
+
+/*
+ * Low runs 100 cycles, mid preempts it for 40 (of which high takes 15),
+ * then low runs 10 more: low 110, mid 25, high 15.
+ */
+static boolean IsrStatsTest_Nesting(void)
+{
+    IsrStats_SummaryType summary;
+
+    IsrStatsTest_Start();
+    IsrStats_Enter(ISRSTATSTEST_LOW, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(100);
+    IsrStats_Enter(ISRSTATSTEST_MID, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(20);
+    IsrStats_Enter(ISRSTATSTEST_HIGH, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(15);
+    IsrStats_Exit(ISRSTATSTEST_HIGH);
+    RegSim_SysTickAdvance(5);
+    IsrStats_Exit(ISRSTATSTEST_MID);
+    RegSim_SysTickAdvance(10);
+    IsrStats_Exit(ISRSTATSTEST_LOW);
+
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_LOW) == 110);
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_MID) == 25);
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_HIGH) == 15);
+
+    /* A second, unpreempted run of low: 50 cycles */
+    IsrStats_Enter(ISRSTATSTEST_LOW, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(50);
+    IsrStats_Exit(ISRSTATSTEST_LOW);
+
+    ISRSTATSTEST_CHECK(IsrStats_GetSummary(ISRSTATSTEST_LOW, &summary));
+    ISRSTATSTEST_CHECK((summary.count == 2) && (summary.latencyCount == 0));
+    ISRSTATSTEST_CHECK((summary.runMin == 50) && (summary.runMax == 110) && (summary.runMean == 80));
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_LOW) == 160);
+    ISRSTATSTEST_CHECK(!IsrStats_GetSummary(ISRSTATS_MAX_VECTORS, &summary));
+    return TRUE;
+}
+
+/* Latencies 0, 20 (marked request) and 300: bins 0, 5 and 9 */
+static boolean IsrStatsTest_Latency(void)
+{
+    IsrStats_SummaryType summary;
+
+    IsrStatsTest_Start();
+    IsrStats_Enter(ISRSTATSTEST_MID, 0);
+    IsrStats_Exit(ISRSTATSTEST_MID);
+
+    IsrStats_MarkRequest(ISRSTATSTEST_MID);
+    RegSim_SysTickAdvance(20);
+    IsrStats_Enter(ISRSTATSTEST_MID, ISRSTATS_NO_LATENCY);
+    IsrStats_Exit(ISRSTATSTEST_MID);
+
+    IsrStats_Enter(ISRSTATSTEST_MID, 300);
+    IsrStats_Exit(ISRSTATSTEST_MID);
+
+    /* The mark is used once */
+    IsrStats_Enter(ISRSTATSTEST_MID, ISRSTATS_NO_LATENCY);
+    IsrStats_Exit(ISRSTATSTEST_MID);
+
+    ISRSTATSTEST_CHECK(IsrStats_GetSummary(ISRSTATSTEST_MID, &summary));
+    ISRSTATSTEST_CHECK((summary.count == 4) && (summary.latencyCount == 3));
+    ISRSTATSTEST_CHECK((summary.latencyMin == 0) && (summary.latencyMax == 300));
+    ISRSTATSTEST_CHECK(summary.latencyMean == 106);
+    ISRSTATSTEST_CHECK((summary.histogram[0] == 1) && (summary.histogram[5] == 1) && (summary.histogram[9] == 1));
+
+    IsrStats_Reset(ISRSTATSTEST_MID);
+    ISRSTATSTEST_CHECK(IsrStats_GetSummary(ISRSTATSTEST_MID, &summary));
+    ISRSTATSTEST_CHECK((summary.count == 0) && (summary.histogram[5] == 0));
+    return TRUE;
+}
+
+/* Counted register reads, one cycle each, done by the SysTick callback */
+static void IsrStatsTest_BusyCallBack(void)
+{
+    uint32 index;
+
+    for (index = 0; index < ISRSTATSTEST_CALLBACK_READS; index++)
+    {
+        (void)RegSim_Read(REGSIM_DWT_CYCCNT);
+    }
+}
+
+/*
+ * SysTick_Handler (slot 0) preempts low three times while every register
+ * access costs a cycle: low keeps its 3 ticks of own time, the handler time
+ * is charged to SysTick only, and the two add up to the time low was in.
+ */
+static boolean IsrStatsTest_SysTickNested(void)
+{
+    IsrStats_SummaryType systick;
+    uint32 start;
+    uint32 elapsed;
+
+    IsrStatsTest_Start();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SysTick_Init(1);
+    SysTick_SetCallBack(IsrStatsTest_BusyCallBack);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+    RegSim_SetCyclesPerAccess(1);
+
+    start = RegSim_Peek(REGSIM_DWT_CYCCNT);
+    IsrStats_Enter(ISRSTATSTEST_LOW, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(3 * 16000UL);
+    IsrStats_Exit(ISRSTATSTEST_LOW);
+    elapsed = RegSim_Peek(REGSIM_DWT_CYCCNT) - start;
+    RegSim_SetCyclesPerAccess(0);
+
+    ISRSTATSTEST_CHECK(IsrStats_GetSummary(ISRSTATS_SYSTICK_VECTOR, &systick));
+    ISRSTATSTEST_CHECK(systick.count == 3);
+    ISRSTATSTEST_CHECK(systick.latencyMax < 16);
+    ISRSTATSTEST_CHECK(systick.runMin >= ISRSTATSTEST_CALLBACK_READS);
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_LOW) <= (3 * 16000UL) + 8);
+    ISRSTATSTEST_CHECK((IsrStats_GetRunCycles(ISRSTATSTEST_LOW) + IsrStats_GetRunCycles(ISRSTATS_SYSTICK_VECTOR)) <= elapsed);
+    ISRSTATSTEST_CHECK((IsrStats_GetRunCycles(ISRSTATSTEST_LOW) + IsrStats_GetRunCycles(ISRSTATS_SYSTICK_VECTOR)) + 8 > elapsed);
+
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*
+ * Handlers nested beyond ISRSTATS_MAX_NESTING are counted, their time
+ * stays in the deepest handler with a frame, and the stack unwinds back
+ * to a clean state.
+ */
+static boolean IsrStatsTest_TooDeep(void)
+{
+    IsrStats_SummaryType summary;
+    uint8 level;
+
+    IsrStatsTest_Start();
+    for (level = 0; level < ISRSTATS_MAX_NESTING; level++)
+    {
+        IsrStats_Enter(ISRSTATSTEST_MID, ISRSTATS_NO_LATENCY);
+    }
+    IsrStats_Enter(ISRSTATSTEST_HIGH, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(30);
+    IsrStats_Exit(ISRSTATSTEST_HIGH);
+    for (level = 0; level < ISRSTATS_MAX_NESTING; level++)
+    {
+        IsrStats_Exit(ISRSTATSTEST_MID);
+    }
+
+    ISRSTATSTEST_CHECK(IsrStats_GetSummary(ISRSTATSTEST_HIGH, &summary));
+    ISRSTATSTEST_CHECK((summary.count == 1) && (summary.runMax == 0));
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_MID) == 30);
+
+    /* An exit without an entry is ignored */
+    IsrStats_Exit(ISRSTATSTEST_LOW);
+    IsrStats_Enter(ISRSTATSTEST_LOW, ISRSTATS_NO_LATENCY);
+    RegSim_SysTickAdvance(7);
+    IsrStats_Exit(ISRSTATSTEST_LOW);
+    ISRSTATSTEST_CHECK(IsrStats_GetRunCycles(ISRSTATSTEST_LOW) == 7);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!IsrStatsTest_Nesting() || !IsrStatsTest_Latency() || !IsrStatsTest_SysTickNested() ||
+        !IsrStatsTest_TooDeep())
+    {
+        return 1;
+    }
+
+    printf("IsrStatsTest: all checks passed\n");
+    return 0;
+}
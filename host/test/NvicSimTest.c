@@ -0,0 +1,202 @@
+/******************************************************************************
+ *
+ * Module: NvicSimTest
+ *
+ * File Name: NvicSimTest.c
+ *
+ * Description: Host test of the NVIC arbitration simulator against hand
+ *              computed timelines (entry 12, tail-chain 6 and exit 10
+ *              cycles): preemption by a higher group, tail-chaining, late
+ *              arrival during stacking, requests lost on a pending source,
+ *              and the NvicSim_Analyze bound against the simulated worst
+ *              case. Exits with 1 on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "NVIC.h"
+#include "NvicSim.h"
+#include "RegSim.h"
+
+#define NVICSIMTEST_CHECK(Condition)                                                  \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Low (priority 5, cost 100) requested at 0, high (priority 1, cost 20) at
+ * 50, both priorities set through the driver. Low starts at 12, high
+ * preempts: stacking 50-62, runs 62-82, unstacking 82-92, then low ends its
+ * last 62 cycles at 154.
+ */
+static boolean NvicSimTest_Preemption(void)
+{
+    static const NvicSim_SourceConfigType s_Sources[] =
+    {
+        {NVICSIM_VECTOR_IRQ(1), NVICSIM_PRIORITY_FROM_REGISTERS, 0, 0, 0, 100, 0},
+        {NVICSIM_VECTOR_IRQ(2), NVICSIM_PRIORITY_FROM_REGISTERS, 0, 50, 0, 20, 0},
+    };
+    NvicSim_SummaryType low;
+    NvicSim_SummaryType high;
+
+    RegSim_Reset();
+    NVIC_SetPriorityIRQ(1, 5);
+    NVIC_SetPriorityIRQ(2, 1);
+    NVICSIMTEST_CHECK(NvicSim_Init(s_Sources, 2, 1));
+    NvicSim_Run(1000);
+    NVICSIMTEST_CHECK(NvicSim_GetSummary(0, &low) && NvicSim_GetSummary(1, &high));
+
+    NVICSIMTEST_CHECK((high.latencyMax == 12) && (high.responseMax == 32));
+    NVICSIMTEST_CHECK((low.latencyMax == 12) && (low.responseMax == 154));
+    NVICSIMTEST_CHECK((low.preemptions == 1) && (high.preemptions == 0));
+    NVICSIMTEST_CHECK((low.completed == 1) && (high.completed == 1));
+    return TRUE;
+}
+
+/*
+ * A (priority 2, cost 100) at 0 and B (priority 3, cost 50) at 10: B cannot
+ * preempt, it is tail-chained when A ends at 112 and starts at 118.
+ */
+static boolean NvicSimTest_TailChain(void)
+{
+    static const NvicSim_SourceConfigType s_Sources[] =
+    {
+        {NVICSIM_VECTOR_IRQ(1), 2, 0, 0, 0, 100, 0},
+        {NVICSIM_VECTOR_IRQ(2), 3, 0, 10, 0, 50, 0},
+    };
+    NvicSim_SummaryType a;
+    NvicSim_SummaryType b;
+
+    RegSim_Reset();
+    NVICSIMTEST_CHECK(NvicSim_Init(s_Sources, 2, 1));
+    NvicSim_Run(1000);
+    NVICSIMTEST_CHECK(NvicSim_GetSummary(0, &a) && NvicSim_GetSummary(1, &b));
+
+    NVICSIMTEST_CHECK((a.responseMax == 112) && (a.preemptions == 0));
+    NVICSIMTEST_CHECK((b.latencyMax == 108) && (b.responseMax == 158));
+    return TRUE;
+}
+
+/*
+ * Low (priority 5) at 0 starts the stacking, high (priority 1, cost 20)
+ * comes at 5 and takes the vector at 12 (latency 7, less than a full
+ * entry). Low is tail-chained at 38 and ends at 138, never preempted.
+ */
+static boolean NvicSimTest_LateArrival(void)
+{
+    static const NvicSim_SourceConfigType s_Sources[] =
+    {
+        {NVICSIM_VECTOR_IRQ(1), 5, 0, 0, 0, 100, 0},
+        {NVICSIM_VECTOR_IRQ(2), 1, 0, 5, 0, 20, 0},
+    };
+    NvicSim_SummaryType low;
+    NvicSim_SummaryType high;
+
+    RegSim_Reset();
+    NVICSIMTEST_CHECK(NvicSim_Init(s_Sources, 2, 1));
+    NvicSim_Run(1000);
+    NVICSIMTEST_CHECK(NvicSim_GetSummary(0, &low) && NvicSim_GetSummary(1, &high));
+
+    NVICSIMTEST_CHECK((high.latencyMax == 7) && (high.responseMax == 27));
+    NVICSIMTEST_CHECK((low.latencyMax == 38) && (low.responseMax == 138));
+    NVICSIMTEST_CHECK(low.preemptions == 0);
+    return TRUE;
+}
+
+/*
+ * A 300-cycle handler at priority 1 runs 12-312 while the source at
+ * priority 4 requests at 10, 110, 210 and 310: its pend bit stays set, so
+ * three requests are lost. It runs once, 318-328, over its 100-cycle
+ * deadline (the period).
+ */
+static boolean NvicSimTest_Overrun(void)
+{
+    static const NvicSim_SourceConfigType s_Sources[] =
+    {
+        {NVICSIM_VECTOR_IRQ(1), 4, 100, 10, 0, 10, 0},
+        {NVICSIM_VECTOR_IRQ(2), 1, 0, 0, 0, 300, 0},
+    };
+    NvicSim_SummaryType source;
+
+    RegSim_Reset();
+    NVICSIMTEST_CHECK(NvicSim_Init(s_Sources, 2, 1));
+    NvicSim_Run(350);
+    NVICSIMTEST_CHECK(NvicSim_GetSummary(0, &source));
+
+    NVICSIMTEST_CHECK((source.requests == 4) && (source.overruns == 3));
+    NVICSIMTEST_CHECK((source.completed == 1) && (source.misses == 1));
+    NVICSIMTEST_CHECK((source.latencyMax == 308) && (source.responseMax == 318));
+    return TRUE;
+}
+
+/*
+ * Three periodic sources released together at 0. For the lowest one the
+ * analysis gives R = 500 + 22 + 1 * (100 + 22) + 1 * (300 + 22) = 966; the
+ * simulation runs them 12-112, 118-418 and 424-924 (tail-chained), so the
+ * worst simulated response is 924. With jitter the simulated worst case
+ * must stay within the bound too.
+ */
+static boolean NvicSimTest_Analyze(void)
+{
+    static const NvicSim_SourceConfigType s_Sources[] =
+    {
+        {NVICSIM_VECTOR_IRQ(1), 1, 1000, 0, 0, 100, 0},
+        {NVICSIM_VECTOR_IRQ(2), 3, 2000, 0, 0, 300, 0},
+        {NVICSIM_VECTOR_IRQ(3), 5, 5000, 0, 0, 500, 0},
+    };
+    NvicSim_SourceConfigType jittered[3];
+    NvicSim_AnalysisType analysis;
+    NvicSim_SummaryType low;
+    uint8 index;
+
+    RegSim_Reset();
+    NVICSIMTEST_CHECK(NvicSim_Init(s_Sources, 3, 1));
+    NvicSim_Run(100000);
+    NVICSIMTEST_CHECK(NvicSim_GetSummary(2, &low) && NvicSim_Analyze(2, &analysis));
+
+    NVICSIMTEST_CHECK((analysis.bound == 966) && (analysis.blocking == 0) && analysis.schedulable);
+    NVICSIMTEST_CHECK((low.responseMax == 924) && (low.misses == 0));
+
+    for (index = 0; index < 3; index++)
+    {
+        jittered[index] = s_Sources[index];
+        jittered[index].jitter = 400;
+    }
+    for (index = 0; index < 3; index++)
+    {
+        NVICSIMTEST_CHECK(NvicSim_Init(jittered, 3, 7));
+        NvicSim_Run(10000000);
+        NVICSIMTEST_CHECK(NvicSim_GetSummary(index, &low) && NvicSim_Analyze(index, &analysis));
+        NVICSIMTEST_CHECK((analysis.bound != NVICSIM_UNBOUNDED) && (low.completed != 0));
+        NVICSIMTEST_CHECK(low.responseMax <= analysis.bound);
+    }
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!NvicSimTest_Preemption() || !NvicSimTest_TailChain() || !NvicSimTest_LateArrival() ||
+        !NvicSimTest_Overrun() || !NvicSimTest_Analyze())
+    {
+        return 1;
+    }
+
+    printf("NvicSimTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,210 @@
+/******************************************************************************
+ *
+ * Module: ProfilerTest
+ *
+ * File Name: ProfilerTest.c
+ *
+ * Description: Host test of the stopwatch profiler, built with
+ *              PROFILER_ENABLE=1 on the RegSim backend, with the DWT time
+ *              stamps (the default) and with the SysTick ones
+ *              (PROFILER_USE_DWT=0). The sections are timed around
+ *              simulated time. Checks the min, max, mean and total of a
+ *              site, nested sections (PROFILER_START/STOP and
+ *              Profiler_Scope), the overhead taken off each section, and a
+ *              section across a wrap of the time source (the 32-bit DWT
+ *              counter, or several SysTick periods). Exits with 1 on the
+ *              first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "Profiler.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define PROFILERTEST_CHECK(Condition)                                                 \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz */
+#define PROFILERTEST_TICK_CYCLES             16000UL
+
+static uint8 g_ProfilerTestDumped;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* SysTick running, every register access free unless a_CyclesPerAccess */
+static void ProfilerTest_Start(uint32 a_CyclesPerAccess)
+{
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+    RegSim_SetCyclesPerAccess(a_CyclesPerAccess);
+    Profiler_Init();
+}
+
+static void ProfilerTest_Stop(void)
+{
+    RegSim_SetCyclesPerAccess(0);
+    SysTick_DeInit();
+}
+
+static void ProfilerTest_Section(Profiler_SiteType a_Site, uint32 a_Cycles)
+{
+    PROFILER_START(start);
+    RegSim_SysTickAdvance(a_Cycles);
+    (void)PROFILER_STOP(a_Site, start);
+}
+
+static void ProfilerTest_DumpCallBack(Profiler_SiteType a_Site, const Profiler_SummaryType *a_Summary)
+{
+    (void)a_Site;
+    (void)a_Summary;
+    g_ProfilerTestDumped++;
+}
+
+/* Sections of 10, 50 and 30 cycles: min 10, max 50, mean 30 */
+static boolean ProfilerTest_Statistics(void)
+{
+    Profiler_SiteType site;
+    Profiler_SiteType idle;
+    Profiler_SummaryType summary;
+    uint8 index;
+
+    ProfilerTest_Start(0);
+    site = Profiler_Register("site");
+    idle = Profiler_Register("idle");
+    PROFILERTEST_CHECK((site == 0) && (idle == 1));
+
+    ProfilerTest_Section(site, 10);
+    ProfilerTest_Section(site, 50);
+    ProfilerTest_Section(site, 30);
+    PROFILERTEST_CHECK(Profiler_GetSummary(site, &summary));
+    PROFILERTEST_CHECK((summary.count == 3) && (summary.total == 90));
+    PROFILERTEST_CHECK((summary.min == 10) && (summary.max == 50) && (summary.mean == 30));
+
+    /* Only the timed site is dumped, a cleared site keeps its name */
+    g_ProfilerTestDumped = 0;
+    Profiler_Dump(ProfilerTest_DumpCallBack);
+    PROFILERTEST_CHECK(g_ProfilerTestDumped == 1);
+    Profiler_Reset(site);
+    PROFILERTEST_CHECK(Profiler_GetSummary(site, &summary));
+    PROFILERTEST_CHECK((summary.count == 0) && (summary.min == 0) && (summary.mean == 0));
+    PROFILERTEST_CHECK(summary.name[0] == 's');
+
+    for (index = 2; index < PROFILER_MAX_SITES; index++)
+    {
+        PROFILERTEST_CHECK(Profiler_Register("fill") == index);
+    }
+    PROFILERTEST_CHECK(Profiler_Register("full") == PROFILER_INVALID_SITE);
+    PROFILERTEST_CHECK(!Profiler_GetSummary(PROFILER_MAX_SITES, &summary));
+
+    ProfilerTest_Stop();
+    return TRUE;
+}
+
+/* Outer 100 cycles around an inner 30, the inner one timed twice by scope */
+static boolean ProfilerTest_Nesting(void)
+{
+    Profiler_SiteType outer;
+    Profiler_SiteType inner;
+    Profiler_SummaryType summary;
+
+    ProfilerTest_Start(0);
+    outer = Profiler_Register("outer");
+    inner = Profiler_Register("inner");
+
+    PROFILER_START(start);
+    RegSim_SysTickAdvance(50);
+    ProfilerTest_Section(inner, 30);
+    RegSim_SysTickAdvance(10);
+    {
+        Profiler_Scope scope(inner);
+        RegSim_SysTickAdvance(6);
+    }
+    RegSim_SysTickAdvance(4);
+    PROFILERTEST_CHECK(PROFILER_STOP(outer, start) == 100);
+
+    PROFILERTEST_CHECK(Profiler_GetSummary(inner, &summary));
+    PROFILERTEST_CHECK((summary.count == 2) && (summary.min == 6) && (summary.max == 30));
+    PROFILERTEST_CHECK(Profiler_GetSummary(outer, &summary));
+    PROFILERTEST_CHECK((summary.count == 1) && (summary.total == 100));
+
+    ProfilerTest_Stop();
+    return TRUE;
+}
+
+/*
+ * Each register access costs a cycle: the stopwatch calls take time, which
+ * Profiler_Init measures and each section has taken off.
+ */
+static boolean ProfilerTest_Overhead(void)
+{
+    Profiler_SiteType site;
+
+    ProfilerTest_Start(1);
+    site = Profiler_Register("site");
+
+    PROFILER_START(empty);
+    PROFILERTEST_CHECK(PROFILER_STOP(site, empty) == 0);
+
+    PROFILER_START(start);
+    RegSim_SysTickAdvance(200);
+    PROFILERTEST_CHECK(PROFILER_STOP(site, start) == 200);
+
+    ProfilerTest_Stop();
+    return TRUE;
+}
+
+/* A section across the wrap of the time source */
+static boolean ProfilerTest_Wrap(void)
+{
+    Profiler_SiteType site;
+    Profiler_SummaryType summary;
+
+    ProfilerTest_Start(0);
+    site = Profiler_Register("site");
+
+#if PROFILER_USE_DWT
+    /* The 32-bit cycle counter wraps 0x80 cycles into the section */
+    RegSim_Poke(REGSIM_DWT_CYCCNT, 0xFFFFFF80UL);
+    ProfilerTest_Section(site, 0x300);
+    PROFILERTEST_CHECK(RegSim_Peek(REGSIM_DWT_CYCCNT) == 0x280);
+    PROFILERTEST_CHECK(Profiler_GetSummary(site, &summary) && (summary.max == 0x300));
+#else
+    /* The down-counter wraps three times and is reloaded in between */
+    ProfilerTest_Section(site, (3 * PROFILERTEST_TICK_CYCLES) + 500);
+    PROFILERTEST_CHECK(RegSim_GetSysTickIsrCount() == 3);
+    PROFILERTEST_CHECK(Profiler_GetSummary(site, &summary) && (summary.max == (3 * PROFILERTEST_TICK_CYCLES) + 500));
+#endif
+
+    ProfilerTest_Stop();
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!ProfilerTest_Statistics() || !ProfilerTest_Nesting() || !ProfilerTest_Overhead() || !ProfilerTest_Wrap())
+    {
+        return 1;
+    }
+
+    printf("ProfilerTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+ *
+ * Module: SchedTest
+ *
+ * File Name: SchedTest.c
+ *
+ * Description: Host test of the run-to-completion scheduler on the RegSim
+ *              backend, PendSV taken by the simulator. Checks periodic
+ *              activations from the SysTick software timers, a higher task
+ *              activated from a lower one running first and nested, a lower
+ *              task activated from a higher one waiting for it, the
+ *              priority reported by Sched_GetCurrentPriority during the
+ *              dispatch and the saturation of the activation count. Exits
+ *              with 1 on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "Sched.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define SCHEDTEST_CHECK(Condition)                                                    \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz */
+#define SCHEDTEST_TICK_CYCLES                16000UL
+
+#define SCHEDTEST_LOW                        1
+#define SCHEDTEST_HIGH                       3
+
+/* Activations kept pending per task (SCHED_MAX_ACTIVATIONS in Sched.c) */
+#define SCHEDTEST_MAX_ACTIVATIONS            255
+
+#define SCHEDTEST_LOG_SIZE                   16
+
+/* What the tasks do when run, set by each scenario */
+typedef enum
+{
+    SCHEDTEST_JUST_LOG,
+    SCHEDTEST_ACTIVATE_OTHER,
+    SCHEDTEST_FLOOD_LOW
+} SchedTest_ActionType;
+
+/* Events: 'L'/'l' low task start/end, 'H'/'h' high task start/end */
+static char g_SchedTestLog[SCHEDTEST_LOG_SIZE];
+static uint8 g_SchedTestLogLength;
+static Sched_PriorityType g_SchedTestSeen[SCHEDTEST_LOG_SIZE];
+static SchedTest_ActionType g_SchedTestAction;
+static uint32 g_SchedTestLowRuns;
+static uint32 g_SchedTestFloodAccepted;
+static boolean g_SchedTestFloodRefused;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Logs an event with the priority reported by the scheduler at that point */
+static void SchedTest_Log(char a_Event)
+{
+    if (g_SchedTestLogLength < SCHEDTEST_LOG_SIZE)
+    {
+        g_SchedTestLog[g_SchedTestLogLength] = a_Event;
+        g_SchedTestSeen[g_SchedTestLogLength] = Sched_GetCurrentPriority();
+        g_SchedTestLogLength++;
+    }
+}
+
+static void SchedTest_LowTask(void *a_Context)
+{
+    (void)a_Context;
+    g_SchedTestLowRuns++;
+    SchedTest_Log('L');
+    if (g_SchedTestAction == SCHEDTEST_ACTIVATE_OTHER)
+    {
+        g_SchedTestAction = SCHEDTEST_JUST_LOG;
+        (void)Sched_Activate(SCHEDTEST_HIGH); // Preempts this task before the next line
+    }
+    SchedTest_Log('l');
+}
+
+static void SchedTest_HighTask(void *a_Context)
+{
+    uint16 index;
+
+    (void)a_Context;
+    SchedTest_Log('H');
+    if (g_SchedTestAction == SCHEDTEST_ACTIVATE_OTHER)
+    {
+        g_SchedTestAction = SCHEDTEST_JUST_LOG;
+        (void)Sched_Activate(SCHEDTEST_LOW); // Runs once this task is done
+    }
+    else if (g_SchedTestAction == SCHEDTEST_FLOOD_LOW)
+    {
+        g_SchedTestAction = SCHEDTEST_JUST_LOG;
+        for (index = 0; index <= SCHEDTEST_MAX_ACTIVATIONS; index++)
+        {
+            if (Sched_Activate(SCHEDTEST_LOW))
+            {
+                g_SchedTestFloodAccepted++;
+            }
+            else
+            {
+                g_SchedTestFloodRefused = TRUE;
+            }
+        }
+    }
+    SchedTest_Log('h');
+}
+
+static void SchedTest_Start(SchedTest_ActionType a_Action)
+{
+    g_SchedTestLogLength = 0;
+    g_SchedTestAction = a_Action;
+    g_SchedTestLowRuns = 0;
+    g_SchedTestFloodAccepted = 0;
+    g_SchedTestFloodRefused = FALSE;
+}
+
+static boolean SchedTest_LogIs(const char *a_Expected)
+{
+    uint8 index;
+
+    for (index = 0; index < g_SchedTestLogLength; index++)
+    {
+        if (a_Expected[index] != g_SchedTestLog[index])
+        {
+            return FALSE;
+        }
+    }
+    return (boolean)(a_Expected[index] == '\0');
+}
+
+/* Set-up, task table and the errors of the API */
+static boolean SchedTest_Init(void)
+{
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    Sched_Init();
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+
+    SCHEDTEST_CHECK((RegSim_Peek(REGSIM_NVIC_SYSTEM_PRI3) & 0x00E00000) == ((uint32)SCHED_PENDSV_PRIORITY << 21));
+    SCHEDTEST_CHECK(Sched_CreateTask(SCHEDTEST_LOW, SchedTest_LowTask, NULL_PTR));
+    SCHEDTEST_CHECK(Sched_CreateTask(SCHEDTEST_HIGH, SchedTest_HighTask, NULL_PTR));
+    SCHEDTEST_CHECK(!Sched_CreateTask(SCHEDTEST_HIGH, SchedTest_HighTask, NULL_PTR));
+    SCHEDTEST_CHECK(!Sched_CreateTask(SCHED_IDLE_PRIORITY, SchedTest_HighTask, NULL_PTR));
+    SCHEDTEST_CHECK(!Sched_CreateTask(SCHED_MAX_PRIORITY + 1, SchedTest_HighTask, NULL_PTR));
+    SCHEDTEST_CHECK(!Sched_Activate(2)); // No task at this level
+    SCHEDTEST_CHECK(!Sched_StartPeriodic(2, 5));
+    SCHEDTEST_CHECK(Sched_GetCurrentPriority() == SCHED_IDLE_PRIORITY);
+    return TRUE;
+}
+
+/* The low task every 5 ticks and the high one every 10: both due at tick 10, high first */
+static boolean SchedTest_Periodic(void)
+{
+    SchedTest_Start(SCHEDTEST_JUST_LOG);
+    SCHEDTEST_CHECK(Sched_StartPeriodic(SCHEDTEST_LOW, 5));
+    SCHEDTEST_CHECK(Sched_StartPeriodic(SCHEDTEST_HIGH, 10));
+
+    RegSim_SysTickAdvance(5 * SCHEDTEST_TICK_CYCLES);
+    SCHEDTEST_CHECK(SchedTest_LogIs("Ll"));
+    RegSim_SysTickAdvance(5 * SCHEDTEST_TICK_CYCLES);
+    SCHEDTEST_CHECK(SchedTest_LogIs("LlHhLl"));
+    SCHEDTEST_CHECK((g_SchedTestSeen[0] == SCHEDTEST_LOW) && (g_SchedTestSeen[2] == SCHEDTEST_HIGH));
+
+    Sched_StopPeriodic(SCHEDTEST_LOW);
+    Sched_StopPeriodic(SCHEDTEST_HIGH);
+    RegSim_SysTickAdvance(20 * SCHEDTEST_TICK_CYCLES);
+    SCHEDTEST_CHECK(g_SchedTestLogLength == 6);
+    SCHEDTEST_CHECK(Sched_GetCurrentPriority() == SCHED_IDLE_PRIORITY);
+    return TRUE;
+}
+
+/* High activated inside low runs at once, nested; low resumes at its own priority */
+static boolean SchedTest_Preemption(void)
+{
+    SchedTest_Start(SCHEDTEST_ACTIVATE_OTHER);
+    SCHEDTEST_CHECK(Sched_Activate(SCHEDTEST_LOW));
+    SCHEDTEST_CHECK(SchedTest_LogIs("LHhl"));
+    SCHEDTEST_CHECK((g_SchedTestSeen[0] == SCHEDTEST_LOW) && (g_SchedTestSeen[1] == SCHEDTEST_HIGH));
+    SCHEDTEST_CHECK((g_SchedTestSeen[2] == SCHEDTEST_HIGH) && (g_SchedTestSeen[3] == SCHEDTEST_LOW));
+    SCHEDTEST_CHECK(Sched_GetCurrentPriority() == SCHED_IDLE_PRIORITY);
+
+    /* Low activated inside high waits for high to complete */
+    SchedTest_Start(SCHEDTEST_ACTIVATE_OTHER);
+    SCHEDTEST_CHECK(Sched_Activate(SCHEDTEST_HIGH));
+    SCHEDTEST_CHECK(SchedTest_LogIs("HhLl"));
+    SCHEDTEST_CHECK(g_SchedTestSeen[2] == SCHEDTEST_LOW);
+    return TRUE;
+}
+
+/* Activations pile up while a higher task runs, up to the saturation */
+static boolean SchedTest_Saturation(void)
+{
+    SchedTest_Start(SCHEDTEST_FLOOD_LOW);
+    SCHEDTEST_CHECK(Sched_Activate(SCHEDTEST_HIGH));
+    SCHEDTEST_CHECK((g_SchedTestFloodAccepted == SCHEDTEST_MAX_ACTIVATIONS) && g_SchedTestFloodRefused);
+    SCHEDTEST_CHECK(g_SchedTestLowRuns == SCHEDTEST_MAX_ACTIVATIONS);
+
+    /* The count is back to 0: accepted again, run once */
+    g_SchedTestLowRuns = 0;
+    SCHEDTEST_CHECK(Sched_Activate(SCHEDTEST_LOW));
+    SCHEDTEST_CHECK(g_SchedTestLowRuns == 1);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!SchedTest_Init() || !SchedTest_Periodic() || !SchedTest_Preemption() || !SchedTest_Saturation())
+    {
+        return 1;
+    }
+
+    printf("SchedTest: all checks passed\n");
+    return 0;
+}
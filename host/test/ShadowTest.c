@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * Module: ShadowTest
+ *
+ * File Name: ShadowTest.c
+ *
+ * Description: Host test of the RAM shadow of the NVIC registers, built
+ *              with NVIC_SHADOW_ENABLE=1 on the RegSim backend. Runs the
+ *              calls that update the Enable and priority registers and
+ *              checks after each group that NVIC_ShadowVerify finds the
+ *              shadow equal to the registers, that the reads are served
+ *              from RAM, and that a register changed behind the driver is
+ *              caught and resynchronized. Exits with 1 on the first failed
+ *              check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "NVIC.h"
+#include "RegSim.h"
+
+#define SHADOWTEST_CHECK(Condition)                                                   \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static boolean ShadowTest_EnableDisable(void)
+{
+    RegSim_Reset();
+    NVIC_ShadowResync();
+    NVIC_EnableIRQ(0);
+    NVIC_EnableIRQ(31);
+    NVIC_EnableIRQ(32);
+    NVIC_EnableIRQ(127);
+    NVIC_DisableIRQ(31);
+    SHADOWTEST_CHECK(NVIC_ShadowVerify());
+
+    RegSim_ClearCounters();
+    SHADOWTEST_CHECK(NVIC_IsIRQEnabled(0) && !NVIC_IsIRQEnabled(31) && NVIC_IsIRQEnabled(127));
+    SHADOWTEST_CHECK(RegSim_GetTotalReads() == 0);
+    return TRUE;
+}
+
+static boolean ShadowTest_Priorities(void)
+{
+    static const NVIC_PriorityWordType s_Words[] =
+    {
+        {2, NVIC_PRI_WORD(1, 2, 3, 4)},
+        {31, NVIC_PRI_WORD(7, 6, 5, 4)},
+    };
+    static const NVIC_ExceptionPriorityConfigType s_Exceptions[] =
+    {
+        {EXCEPTION_PEND_SV_TYPE, 7},
+        {EXCEPTION_MEM_FAULT_TYPE, 1},
+    };
+
+    RegSim_Reset();
+    NVIC_ShadowResync();
+    NVIC_SetPriorityIRQ(5, 2);
+    NVIC_SetPriorityIRQ(6, 5);
+    NVIC_SetPriorityIRQ(100, 6);
+    NVIC_WritePriorityWords(s_Words, 2);
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 3);
+    NVIC_SetPriorityException(EXCEPTION_SVC_TYPE, 4);
+    NVIC_SetPriorityExceptionTable(s_Exceptions, 2);
+    SHADOWTEST_CHECK(NVIC_ShadowVerify());
+
+    RegSim_ClearCounters();
+    SHADOWTEST_CHECK((NVIC_GetPriorityIRQ(5) == 2) && (NVIC_GetPriorityIRQ(6) == 5) && (NVIC_GetPriorityIRQ(100) == 6));
+    SHADOWTEST_CHECK((NVIC_GetPriorityIRQ(9) == 2) && (NVIC_GetPriorityIRQ(124) == 7));
+    SHADOWTEST_CHECK(NVIC_GetPriorityException(EXCEPTION_SYSTICK_TYPE) == 3);
+    SHADOWTEST_CHECK(NVIC_GetPriorityException(EXCEPTION_PEND_SV_TYPE) == 7);
+    SHADOWTEST_CHECK(RegSim_GetTotalReads() == 0);
+    return TRUE;
+}
+
+/* A restored context is taken by the shadow too, a later change keeps both in step */
+static boolean ShadowTest_RestoreContext(void)
+{
+    NVIC_ContextType context;
+
+    RegSim_Reset();
+    NVIC_ShadowResync();
+    NVIC_EnableIRQ(7);
+    NVIC_EnableIRQ(70);
+    NVIC_SetPriorityIRQ(7, 4);
+    NVIC_SetPriorityIRQ(70, 1);
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 2);
+    NVIC_SaveContext(&context);
+
+    NVIC_DisableIRQ(7);
+    NVIC_EnableIRQ(8);
+    NVIC_SetPriorityIRQ(7, 0);
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 6);
+    SHADOWTEST_CHECK(NVIC_ShadowVerify());
+
+    SHADOWTEST_CHECK(NVIC_RestoreContext(&context));
+    SHADOWTEST_CHECK(NVIC_ShadowVerify());
+    SHADOWTEST_CHECK(NVIC_IsIRQEnabled(7) && !NVIC_IsIRQEnabled(8) && NVIC_IsIRQEnabled(70));
+    SHADOWTEST_CHECK((NVIC_GetPriorityIRQ(7) == 4) && (NVIC_GetPriorityException(EXCEPTION_SYSTICK_TYPE) == 2));
+
+    NVIC_SetPriorityIRQ(71, 3);
+    NVIC_DisableIRQ(70);
+    SHADOWTEST_CHECK(NVIC_ShadowVerify());
+    return TRUE;
+}
+
+/* A register written behind the driver is caught, the resync repairs the shadow */
+static boolean ShadowTest_Mismatch(void)
+{
+    RegSim_Reset();
+    NVIC_ShadowResync();
+    NVIC_SetPriorityIRQ(5, 2);
+    RegSim_Poke((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + 1), 0x0000E000);
+    SHADOWTEST_CHECK(!NVIC_ShadowVerify());
+
+    NVIC_ShadowResync();
+    SHADOWTEST_CHECK(NVIC_ShadowVerify());
+    SHADOWTEST_CHECK(NVIC_GetPriorityIRQ(5) == 7);
+
+    RegSim_Poke(REGSIM_NVIC_EN0, 1UL << 3);
+    SHADOWTEST_CHECK(!NVIC_ShadowVerify());
+    NVIC_ShadowResync();
+    SHADOWTEST_CHECK(NVIC_ShadowVerify() && NVIC_IsIRQEnabled(3));
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!ShadowTest_EnableDisable() || !ShadowTest_Priorities() || !ShadowTest_RestoreContext() ||
+        !ShadowTest_Mismatch())
+    {
+        return 1;
+    }
+
+    printf("ShadowTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *
+ * Module: SwTimerTest
+ *
+ * File Name: SwTimerTest.c
+ *
+ * Description: Host test of the software timers on the RegSim backend, as
+ *              a fresh application uses them: no SwTimer_Init call, the
+ *              first SwTimer_Create builds the pool. Checks one-shot and
+ *              periodic expiries on the periodic SysTick, stop, the pool
+ *              size and a Timeout on top of the timers. Exits with 1 on the
+ *              first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "SwTimer.h"
+#include "SysTick.h"
+#include "Timeout.h"
+#include "RegSim.h"
+
+#define SWTIMERTEST_CHECK(Condition)                                                  \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz */
+#define SWTIMERTEST_TICK_CYCLES              16000UL
+
+static uint32 g_SwTimerTestExpiries[2];
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void SwTimerTest_CallBack(void *a_Context)
+{
+    g_SwTimerTestExpiries[*(const uint8 *)a_Context]++;
+}
+
+static void SwTimerTest_Ticks(uint32 a_Ticks)
+{
+    RegSim_SysTickAdvance(a_Ticks * SWTIMERTEST_TICK_CYCLES);
+}
+
+/* The first create works without any set-up call */
+static boolean SwTimerTest_Expiries(void)
+{
+    static const uint8 s_OneShot = 0;
+    static const uint8 s_Periodic = 1;
+    SwTimer_IdType oneShot = SwTimer_Create(SwTimerTest_CallBack, (void *)&s_OneShot);
+    SwTimer_IdType periodic = SwTimer_Create(SwTimerTest_CallBack, (void *)&s_Periodic);
+
+    SWTIMERTEST_CHECK(oneShot != SWTIMER_INVALID_ID);
+    SWTIMERTEST_CHECK((periodic != SWTIMER_INVALID_ID) && (periodic != oneShot));
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+
+    SWTIMERTEST_CHECK(SwTimer_Start(oneShot, 5, SWTIMER_ONE_SHOT));
+    SWTIMERTEST_CHECK(SwTimer_Start(periodic, 3, SWTIMER_PERIODIC));
+    SWTIMERTEST_CHECK(!SwTimer_Start(periodic, 0, SWTIMER_PERIODIC));
+    SWTIMERTEST_CHECK(SwTimer_GetRemaining(oneShot) == 5);
+
+    SwTimerTest_Ticks(4);
+    SWTIMERTEST_CHECK((g_SwTimerTestExpiries[0] == 0) && (g_SwTimerTestExpiries[1] == 1));
+    SwTimerTest_Ticks(1);
+    SWTIMERTEST_CHECK(g_SwTimerTestExpiries[0] == 1);
+    SWTIMERTEST_CHECK(!SwTimer_IsRunning(oneShot) && SwTimer_IsRunning(periodic));
+
+    SwTimerTest_Ticks(10);
+    SWTIMERTEST_CHECK((g_SwTimerTestExpiries[0] == 1) && (g_SwTimerTestExpiries[1] == 5));
+
+    SwTimer_Stop(periodic);
+    SwTimerTest_Ticks(10);
+    SWTIMERTEST_CHECK(g_SwTimerTestExpiries[1] == 5);
+    SWTIMERTEST_CHECK(SwTimer_GetTickCount() == 25);
+
+    SwTimer_Delete(oneShot);
+    SwTimer_Delete(periodic);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/* SWTIMER_MAX_TIMERS timers, then SWTIMER_INVALID_ID until one is deleted */
+static boolean SwTimerTest_Pool(void)
+{
+    SwTimer_IdType ids[SWTIMER_MAX_TIMERS];
+    uint16 index;
+
+    for (index = 0; index < SWTIMER_MAX_TIMERS; index++)
+    {
+        ids[index] = SwTimer_Create(NULL_PTR, NULL_PTR);
+        SWTIMERTEST_CHECK(ids[index] != SWTIMER_INVALID_ID);
+    }
+    SWTIMERTEST_CHECK(SwTimer_Create(NULL_PTR, NULL_PTR) == SWTIMER_INVALID_ID);
+
+    SwTimer_Delete(ids[7]);
+    SWTIMERTEST_CHECK(SwTimer_Create(NULL_PTR, NULL_PTR) == ids[7]);
+
+    for (index = 0; index < SWTIMER_MAX_TIMERS; index++)
+    {
+        SwTimer_Delete(ids[index]);
+    }
+    return TRUE;
+}
+
+/* The modules built on the timers need no set-up call either */
+static boolean SwTimerTest_Timeout(void)
+{
+    Timeout_Type timeout;
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1);
+
+    SWTIMERTEST_CHECK(Timeout_Create(&timeout, NULL_PTR, NULL_PTR));
+    SWTIMERTEST_CHECK(Timeout_Start(&timeout, 2));
+    SwTimerTest_Ticks(2);
+    SWTIMERTEST_CHECK(Timeout_IsExpired(&timeout));
+
+    Timeout_Delete(&timeout);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!SwTimerTest_Expiries() || !SwTimerTest_Pool() || !SwTimerTest_Timeout())
+    {
+        return 1;
+    }
+
+    printf("SwTimerTest: all checks passed\n");
+    return 0;
+}
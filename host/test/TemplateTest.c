@@ -0,0 +1,235 @@
+/******************************************************************************
+ *
+ * Module: TemplateTest
+ *
+ * File Name: TemplateTest.c
+ *
+ * Description: Host test of the C++ front-end (NVIC.hpp and SysTick.hpp) on
+ *              the RegSim backend. Each group of template calls is run on a
+ *              reset register file, then the equivalent C calls are run on
+ *              another, and the whole register files must be equal: enable
+ *              and disable, IRQ and exception priorities written next to
+ *              other priorities, pend and unpend up to IRQ 138, and
+ *              SysTick::init against SysTick_SetCoreClock and SysTick_Init.
+ *              Also built with NVIC_SHADOW_ENABLE=1, where the shadow must
+ *              match the registers after the template calls. Exits with 1
+ *              on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "NVIC.hpp"
+#include "SysTick.hpp"
+#include "RegSim.h"
+
+#define TEMPLATETEST_CHECK(Condition)                                                 \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* Priorities already set in the words written by the byte stores */
+#define TEMPLATETEST_PRI1                    0x00A0C000UL
+#define TEMPLATETEST_PRI10                   0xE0002000UL
+#define TEMPLATETEST_PRI34                   0x0000C020UL
+#define TEMPLATETEST_SYSTEM_PRI3             0x00400000UL
+
+typedef struct
+{
+    uint32 registers[REGSIM_REGISTERS_COUNT];
+    uint32 writes;
+    uint32 reads;
+} TemplateTest_SnapshotType;
+
+static TemplateTest_SnapshotType g_TemplateTestTemplates;
+static TemplateTest_SnapshotType g_TemplateTestDriver;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/* Reset register file, with neighbour priorities in the words under test */
+static void TemplateTest_Start(void)
+{
+    RegSim_Reset();
+    RegSim_Poke((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + 1), TEMPLATETEST_PRI1);
+    RegSim_Poke((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + 10), TEMPLATETEST_PRI10);
+    RegSim_Poke((RegSim_RegisterType)(REGSIM_NVIC_PRI0 + 34), TEMPLATETEST_PRI34);
+    RegSim_Poke(REGSIM_NVIC_SYSTEM_PRI3, TEMPLATETEST_SYSTEM_PRI3);
+#if NVIC_SHADOW_ENABLE
+    NVIC_ShadowResync();
+#endif
+    RegSim_ClearCounters();
+}
+
+static void TemplateTest_Snapshot(TemplateTest_SnapshotType *a_Snapshot)
+{
+    uint32 index;
+
+    for (index = 0; index < REGSIM_REGISTERS_COUNT; index++)
+    {
+        a_Snapshot->registers[index] = RegSim_Peek((RegSim_RegisterType)index);
+    }
+    a_Snapshot->writes = RegSim_GetTotalWrites();
+    a_Snapshot->reads = RegSim_GetTotalReads();
+}
+
+/* Register files left by the template and the C calls are the same */
+static boolean TemplateTest_Same(void)
+{
+    uint32 index;
+
+    for (index = 0; index < REGSIM_REGISTERS_COUNT; index++)
+    {
+        if (g_TemplateTestTemplates.registers[index] != g_TemplateTestDriver.registers[index])
+        {
+            printf("register %u: templates 0x%08X, C API 0x%08X\n", (unsigned)index,
+                   (unsigned)g_TemplateTestTemplates.registers[index], (unsigned)g_TemplateTestDriver.registers[index]);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* IRQ 5 (EN0), 40 (EN1) and 138 (EN4 bit 10), 40 disabled again */
+static boolean TemplateTest_EnableDisable(void)
+{
+    TemplateTest_Start();
+    Nvic::enable<5>();
+    Nvic::enable<40>();
+    Nvic::enable<138>();
+    Nvic::disable<40>();
+    TemplateTest_Snapshot(&g_TemplateTestTemplates);
+#if NVIC_SHADOW_ENABLE
+    TEMPLATETEST_CHECK(NVIC_ShadowVerify());
+#endif
+    TEMPLATETEST_CHECK(Nvic::isEnabled<5>() && !Nvic::isEnabled<40>() && Nvic::isEnabled<138>());
+
+    TemplateTest_Start();
+    NVIC_EnableIRQ(5);
+    NVIC_EnableIRQ(40);
+    NVIC_EnableIRQ(138);
+    NVIC_DisableIRQ(40);
+    TemplateTest_Snapshot(&g_TemplateTestDriver);
+
+    TEMPLATETEST_CHECK(TemplateTest_Same());
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.writes == 4);
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.reads == 0);
+    return TRUE;
+}
+
+/* Byte stores next to other priorities, against the read-modify-writes */
+static boolean TemplateTest_Priorities(void)
+{
+    TemplateTest_Start();
+    Nvic::setPriority<5, 3>();
+    Nvic::setPriority<40, 6>();
+    Nvic::setPriority<138, 4>();
+    Nvic::setExceptionPriority<EXCEPTION_SYSTICK_TYPE, 2>();
+    Nvic::setExceptionPriority<EXCEPTION_PEND_SV_TYPE, 7>();
+    Nvic::setExceptionPriority<EXCEPTION_SVC_TYPE, 5>();
+    TemplateTest_Snapshot(&g_TemplateTestTemplates);
+#if NVIC_SHADOW_ENABLE
+    TEMPLATETEST_CHECK(NVIC_ShadowVerify());
+#endif
+
+    TemplateTest_Start();
+    NVIC_SetPriorityIRQ(5, 3);
+    NVIC_SetPriorityIRQ(40, 6);
+    NVIC_SetPriorityIRQ(138, 4);
+    NVIC_SetPriorityException(EXCEPTION_SYSTICK_TYPE, 2);
+    NVIC_SetPriorityException(EXCEPTION_PEND_SV_TYPE, 7);
+    NVIC_SetPriorityException(EXCEPTION_SVC_TYPE, 5);
+    TemplateTest_Snapshot(&g_TemplateTestDriver);
+
+    TEMPLATETEST_CHECK(TemplateTest_Same());
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.registers[REGSIM_NVIC_PRI0 + 1] == 0x00A06000UL);
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.registers[REGSIM_NVIC_PRI0 + 34] == 0x0080C020UL);
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.registers[REGSIM_NVIC_SYSTEM_PRI3] == 0x40E00000UL);
+#if !NVIC_SHADOW_ENABLE
+    TEMPLATETEST_CHECK((g_TemplateTestTemplates.writes == 6) && (g_TemplateTestTemplates.reads == 0));
+#endif
+    return TRUE;
+}
+
+/* IRQ 7, 100 and 138 pended, 100 unpended again */
+static boolean TemplateTest_Pending(void)
+{
+    TemplateTest_Start();
+    Nvic::setPending<7>();
+    Nvic::setPending<100>();
+    Nvic::setPending<138>();
+    Nvic::clearPending<100>();
+    TemplateTest_Snapshot(&g_TemplateTestTemplates);
+    TEMPLATETEST_CHECK(Nvic::isPending<7>() && !Nvic::isPending<100>() && Nvic::isPending<138>());
+    TEMPLATETEST_CHECK(!Nvic::isActive<7>());
+
+    TemplateTest_Start();
+    NVIC_SetPending(7);
+    NVIC_SetPending(100);
+    NVIC_SetPending(138);
+    NVIC_ClearPending(100);
+    TemplateTest_Snapshot(&g_TemplateTestDriver);
+
+    TEMPLATETEST_CHECK(TemplateTest_Same());
+    TEMPLATETEST_CHECK((g_TemplateTestTemplates.writes == 4) && (g_TemplateTestTemplates.reads == 0));
+    return TRUE;
+}
+
+/* 1 ms at 16MHz and 2 ms at 80MHz, converted at compile time */
+static boolean TemplateTest_SysTickInit(void)
+{
+    TemplateTest_Start();
+    SysTick::init<16000000UL, 1>();
+    TemplateTest_Snapshot(&g_TemplateTestTemplates);
+    SysTick_DeInit();
+
+    TemplateTest_Start();
+    (void)SysTick_SetCoreClock(16000000UL);
+    SysTick_Init(1);
+    TemplateTest_Snapshot(&g_TemplateTestDriver);
+    SysTick_DeInit();
+
+    TEMPLATETEST_CHECK(TemplateTest_Same());
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.registers[REGSIM_SYSTICK_RELOAD] == 15999);
+
+    TemplateTest_Start();
+    SysTick::init<80000000UL, 2>();
+    TemplateTest_Snapshot(&g_TemplateTestTemplates);
+    SysTick_DeInit();
+
+    TemplateTest_Start();
+    (void)SysTick_SetCoreClock(80000000UL);
+    SysTick_Init(2);
+    TemplateTest_Snapshot(&g_TemplateTestDriver);
+    SysTick_DeInit();
+
+    TEMPLATETEST_CHECK(TemplateTest_Same());
+    TEMPLATETEST_CHECK(g_TemplateTestTemplates.registers[REGSIM_SYSTICK_RELOAD] == 159999);
+    TEMPLATETEST_CHECK(SysTick::cycles(80000000UL, 2000) == 160000);
+    (void)SysTick_SetCoreClock(16000000UL);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!TemplateTest_EnableDisable() || !TemplateTest_Priorities() || !TemplateTest_Pending() ||
+        !TemplateTest_SysTickInit())
+    {
+        return 1;
+    }
+
+    printf("TemplateTest: all checks passed\n");
+    return 0;
+}
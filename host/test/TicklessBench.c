@@ -0,0 +1,127 @@
+/******************************************************************************
+ *
+ * Module: TicklessBench
+ *
+ * File Name: TicklessBench.c
+ *
+ * Description: Host benchmark of the tickless SysTick: for sparse and dense
+ *              software timer loads, prints the SysTick interrupts taken in
+ *              10 s of simulated time by the periodic and the tickless
+ *              SysTick, and the ISR entries avoided. Fails if a mode misses
+ *              an expiry, or if tickless mode wakes more than once per
+ *              distinct deadline (plus the wakes a gap longer than the
+ *              24-bit counter needs and a few at start-up).
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "Bench.h"
+
+/* Simulated time of each load, in 1 ms ticks */
+#define TICKLESSBENCH_TICKS                  10000UL
+
+#define TICKLESSBENCH_MAX_TIMERS             4
+
+/* Longest tickless period: the 24-bit counter range */
+#define TICKLESSBENCH_MAX_LOAD_CYCLES        0x01000000UL
+
+/* Wakes allowed above the ideal count, for the first periods */
+#define TICKLESSBENCH_MAX_EXTRA_ISRS         2
+
+typedef struct
+{
+    const char *name;
+    uint8 timers;
+    uint32 intervals[TICKLESSBENCH_MAX_TIMERS];   /* In 1 ms ticks */
+} TicklessBench_LoadType;
+
+static const TicklessBench_LoadType g_TicklessBenchLoads[] =
+{
+    {"idle", 0, {0}},
+    {"1 s heartbeat", 1, {1000}},
+    {"5 s heartbeat", 1, {5000}},
+    {"100 ms + 250 ms + 1 s", 3, {100, 250, 1000}},
+    {"10 ms + 1 s", 2, {10, 1000}},
+    {"1 ms (dense)", 1, {1}},
+};
+
+#define TICKLESSBENCH_LOADS                  (sizeof(g_TicklessBenchLoads) / sizeof(g_TicklessBenchLoads[0]))
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Fewest wakes able to serve the load: one per distinct deadline, plus the
+ * extra wakes of a gap between deadlines too long for one reload, and the
+ * full reloads after the last deadline.
+ */
+static uint32 TicklessBench_IdealIsrs(const TicklessBench_LoadType *a_Load)
+{
+    uint32 wakes = 0;
+    uint32 last = 0;
+    uint64 gap;
+    uint32 tick;
+    uint8 index;
+
+    for (tick = 1; tick <= TICKLESSBENCH_TICKS; tick++)
+    {
+        for (index = 0; index < a_Load->timers; index++)
+        {
+            if ((tick % a_Load->intervals[index]) == 0)
+            {
+                gap = (uint64)(tick - last) * BENCH_TICK_CYCLES;
+                wakes += (uint32)((gap + (TICKLESSBENCH_MAX_LOAD_CYCLES - 1)) / TICKLESSBENCH_MAX_LOAD_CYCLES);
+                last = tick;
+                break;
+            }
+        }
+    }
+
+    gap = (uint64)(TICKLESSBENCH_TICKS - last) * BENCH_TICK_CYCLES;
+    return wakes + (uint32)(gap / TICKLESSBENCH_MAX_LOAD_CYCLES);
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    Bench_IsrResultType result;
+    uint32 ideal;
+    uint32 avoided;
+    int status = 0;
+    uint32 index;
+
+    printf("%-24s %10s %10s %10s %10s %9s\n", "load", "expiries", "periodic", "tickless", "ideal", "avoided");
+    for (index = 0; index < TICKLESSBENCH_LOADS; index++)
+    {
+        Bench_CountIsrEntries(g_TicklessBenchLoads[index].intervals, g_TicklessBenchLoads[index].timers,
+                              TICKLESSBENCH_TICKS, &result);
+        ideal = TicklessBench_IdealIsrs(&g_TicklessBenchLoads[index]);
+        avoided = (result.ticklessIsrs < result.periodicIsrs) ? (result.periodicIsrs - result.ticklessIsrs) : 0;
+        printf("%-24s %10lu %10lu %10lu %10lu %8lu%%\n", g_TicklessBenchLoads[index].name,
+               (unsigned long)result.ticklessExpiries, (unsigned long)result.periodicIsrs,
+               (unsigned long)result.ticklessIsrs, (unsigned long)ideal,
+               (unsigned long)((avoided * 100UL) / result.periodicIsrs));
+
+        if (result.ticklessExpiries != result.periodicExpiries)
+        {
+            printf("%s: expiries %lu (periodic) / %lu (tickless)\n", g_TicklessBenchLoads[index].name,
+                   (unsigned long)result.periodicExpiries, (unsigned long)result.ticklessExpiries);
+            status = 1;
+        }
+        if (result.ticklessIsrs > (ideal + TICKLESSBENCH_MAX_EXTRA_ISRS))
+        {
+            printf("%s: %lu tickless wakes for %lu needed\n", g_TicklessBenchLoads[index].name,
+                   (unsigned long)result.ticklessIsrs, (unsigned long)ideal);
+            status = 1;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,234 @@
+/******************************************************************************
+ *
+ * Module: TimeoutTest
+ *
+ * File Name: TimeoutTest.c
+ *
+ * Description: Host test of the asynchronous timeouts on the RegSim
+ *              backend, WFI modelled by the simulator. Checks the flag and
+ *              the completion function at the expiry, Timeout_Cancel
+ *              keeping both off, Timeout_Sleep returning the ticks left
+ *              when an earlier interrupt ends the sleep (every tick in
+ *              periodic mode, another timer deadline in tickless mode), and
+ *              two tickless timeouts with the same deadline served by a
+ *              single SysTick interrupt. Exits with 1 on the first failed
+ *              check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "Timeout.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define TIMEOUTTEST_CHECK(Condition)                                                  \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz */
+#define TIMEOUTTEST_TICK_CYCLES              16000UL
+
+static uint32 g_TimeoutTestCallBacks;
+static void *g_TimeoutTestContext;
+static uint32 g_TimeoutTestExpiryIsrs;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void TimeoutTest_CallBack(void *a_Context)
+{
+    g_TimeoutTestCallBacks++;
+    g_TimeoutTestContext = a_Context;
+    g_TimeoutTestExpiryIsrs = RegSim_GetSysTickIsrCount();
+}
+
+static void TimeoutTest_Start(boolean a_Tickless)
+{
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    if (a_Tickless)
+    {
+        SysTick_InitTickless(1);
+    }
+    else
+    {
+        SysTick_Init(1);
+    }
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+    if (a_Tickless)
+    {
+        //Accesses take time as on the core, so a counter restarted for a new
+        //deadline has reloaded by the next read instead of still reading 0
+        RegSim_SetCyclesPerAccess(1);
+    }
+    RegSim_ClearCounters();
+    g_TimeoutTestCallBacks = 0;
+    g_TimeoutTestContext = NULL_PTR;
+}
+
+/* Flag and completion function at the 5th tick, not before */
+static boolean TimeoutTest_Expiry(void)
+{
+    Timeout_Type timeout;
+    uint32 context = 0;
+
+    TimeoutTest_Start(FALSE);
+    TIMEOUTTEST_CHECK(Timeout_Create(&timeout, TimeoutTest_CallBack, &context));
+    TIMEOUTTEST_CHECK(!Timeout_Start(&timeout, 0));
+    TIMEOUTTEST_CHECK(Timeout_Start(&timeout, 5));
+
+    RegSim_SysTickAdvance(4 * TIMEOUTTEST_TICK_CYCLES);
+    TIMEOUTTEST_CHECK(!Timeout_IsExpired(&timeout) && (g_TimeoutTestCallBacks == 0));
+    TIMEOUTTEST_CHECK(Timeout_GetRemaining(&timeout) == 1);
+
+    RegSim_SysTickAdvance(TIMEOUTTEST_TICK_CYCLES);
+    TIMEOUTTEST_CHECK(Timeout_IsExpired(&timeout) && (g_TimeoutTestCallBacks == 1));
+    TIMEOUTTEST_CHECK(g_TimeoutTestContext == &context);
+    TIMEOUTTEST_CHECK(Timeout_GetRemaining(&timeout) == 0);
+    TIMEOUTTEST_CHECK(Timeout_Sleep(&timeout) == 0); // Not running: no sleep
+
+    /* One-shot: no second call, a restart clears the flag */
+    RegSim_SysTickAdvance(10 * TIMEOUTTEST_TICK_CYCLES);
+    TIMEOUTTEST_CHECK(g_TimeoutTestCallBacks == 1);
+    TIMEOUTTEST_CHECK(Timeout_Start(&timeout, 3) && !Timeout_IsExpired(&timeout));
+
+    Timeout_Delete(&timeout);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/* Cancelled after 2 of 5 ticks: no flag, no call, nothing left */
+static boolean TimeoutTest_Cancel(void)
+{
+    Timeout_Type timeout;
+
+    TimeoutTest_Start(FALSE);
+    TIMEOUTTEST_CHECK(Timeout_Create(&timeout, TimeoutTest_CallBack, NULL_PTR));
+    TIMEOUTTEST_CHECK(Timeout_Start(&timeout, 5));
+    RegSim_SysTickAdvance(2 * TIMEOUTTEST_TICK_CYCLES);
+    Timeout_Cancel(&timeout);
+    RegSim_SysTickAdvance(10 * TIMEOUTTEST_TICK_CYCLES);
+
+    TIMEOUTTEST_CHECK(!Timeout_IsExpired(&timeout) && (g_TimeoutTestCallBacks == 0));
+    TIMEOUTTEST_CHECK(Timeout_GetRemaining(&timeout) == 0);
+    TIMEOUTTEST_CHECK(Timeout_Sleep(&timeout) == 0);
+
+    Timeout_Delete(&timeout);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/* Periodic mode: every tick ends the sleep, with the ticks left returned */
+static boolean TimeoutTest_SleepPeriodic(void)
+{
+    Timeout_Type timeout;
+    uint32 remaining;
+    uint32 sleeps = 0;
+
+    TimeoutTest_Start(FALSE);
+    TIMEOUTTEST_CHECK(Timeout_Create(&timeout, NULL_PTR, NULL_PTR));
+    TIMEOUTTEST_CHECK(Timeout_Start(&timeout, 5));
+
+    remaining = Timeout_Sleep(&timeout);
+    TIMEOUTTEST_CHECK((remaining == 4) && (RegSim_GetSysTickIsrCount() == 1));
+    do
+    {
+        sleeps++;
+    } while (Timeout_Sleep(&timeout) != 0);
+    TIMEOUTTEST_CHECK((sleeps == 4) && Timeout_IsExpired(&timeout));
+    TIMEOUTTEST_CHECK(RegSim_GetSysTickIsrCount() == 5);
+
+    Timeout_Delete(&timeout);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*
+ * Tickless mode: a 100-tick timeout sleeping while a 30-tick one runs is
+ * woken at tick 30 with 70 ticks left, then sleeps to its deadline. The
+ * period restarted for the 30-tick deadline is run once more by the
+ * hardware before the reload for the deadline is taken, hence up to one
+ * wake-up in between.
+ */
+static boolean TimeoutTest_SleepTickless(void)
+{
+    Timeout_Type timeout;
+    Timeout_Type other;
+    uint32 remaining;
+
+    TimeoutTest_Start(TRUE);
+    TIMEOUTTEST_CHECK(Timeout_Create(&timeout, TimeoutTest_CallBack, &timeout));
+    TIMEOUTTEST_CHECK(Timeout_Create(&other, NULL_PTR, NULL_PTR));
+    TIMEOUTTEST_CHECK(Timeout_Start(&timeout, 100));
+    TIMEOUTTEST_CHECK(Timeout_Start(&other, 30));
+
+    TIMEOUTTEST_CHECK(Timeout_Sleep(&timeout) == 70);
+    TIMEOUTTEST_CHECK(Timeout_IsExpired(&other) && !Timeout_IsExpired(&timeout));
+    TIMEOUTTEST_CHECK(RegSim_GetSysTickIsrCount() == 1);
+
+    do
+    {
+        remaining = Timeout_Sleep(&timeout);
+        TIMEOUTTEST_CHECK(remaining < 70);
+    } while (remaining != 0);
+    TIMEOUTTEST_CHECK(Timeout_IsExpired(&timeout) && (g_TimeoutTestCallBacks == 1));
+    TIMEOUTTEST_CHECK(RegSim_GetSysTickIsrCount() <= 3);
+
+    Timeout_Delete(&timeout);
+    Timeout_Delete(&other);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/* Tickless mode: two timeouts due at the same tick take one SysTick interrupt */
+static boolean TimeoutTest_SharedDeadline(void)
+{
+    Timeout_Type first;
+    Timeout_Type second;
+
+    TimeoutTest_Start(TRUE);
+    TIMEOUTTEST_CHECK(Timeout_Create(&first, TimeoutTest_CallBack, &first));
+    TIMEOUTTEST_CHECK(Timeout_Create(&second, TimeoutTest_CallBack, &second));
+    TIMEOUTTEST_CHECK(Timeout_Start(&first, 200));
+    RegSim_SysTickAdvance(50 * TIMEOUTTEST_TICK_CYCLES);
+    TIMEOUTTEST_CHECK(Timeout_Start(&second, 150));
+    TIMEOUTTEST_CHECK(RegSim_GetSysTickIsrCount() == 0);
+
+    while (Timeout_Sleep(&first) != 0)
+    {
+    }
+    TIMEOUTTEST_CHECK(Timeout_IsExpired(&first) && Timeout_IsExpired(&second));
+    TIMEOUTTEST_CHECK((g_TimeoutTestCallBacks == 2) && (g_TimeoutTestExpiryIsrs == 1));
+    TIMEOUTTEST_CHECK(RegSim_GetSysTickIsrCount() == 1);
+
+    Timeout_Delete(&first);
+    Timeout_Delete(&second);
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!TimeoutTest_Expiry() || !TimeoutTest_Cancel() || !TimeoutTest_SleepPeriodic() ||
+        !TimeoutTest_SleepTickless() || !TimeoutTest_SharedDeadline())
+    {
+        return 1;
+    }
+
+    printf("TimeoutTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,292 @@
+/******************************************************************************
+ *
+ * Module: TraceTest
+ *
+ * File Name: TraceTest.c
+ *
+ * Description: Host test of the interrupt trace recorder, built with
+ *              TRACE_ENABLE=1 on the RegSim backend (DWT time stamps). The
+ *              IRQ handlers are played by the test, SysTick_Handler records
+ *              itself. Checks the records of nested handlers, ticks and
+ *              markers in the snapshot (order, stamps, nothing recorded
+ *              while frozen), the lost count once the ring wraps, and the
+ *              B/E pairs of the Chrome trace written by tracedecode from the
+ *              dump. The path of tracedecode is the first argument. Exits
+ *              with 1 on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Trace.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define TRACETEST_CHECK(Condition)                                                    \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz */
+#define TRACETEST_CLOCK_HZ                   16000000UL
+#define TRACETEST_TICK_CYCLES                16000UL
+
+#define TRACETEST_UART_VECTOR                TRACE_IRQ_VECTOR(5)
+#define TRACETEST_CAN_VECTOR                 TRACE_IRQ_VECTOR(39)
+
+#define TRACETEST_FLOOD_MARKERS              300
+
+#define TRACETEST_DUMP                       "TraceTest.bin"
+#define TRACETEST_JSON                       "TraceTest.json"
+
+/* Events of the decoded trace, one letter each ('B', 'E' or 'i') */
+#define TRACETEST_MAX_EVENTS                 (TRACE_BUFFER_RECORDS + 8)
+
+static const char *g_TraceTestDecoder;
+static Trace_HeaderType g_TraceTestHeader;
+static Trace_RecordType g_TraceTestRecords[TRACE_BUFFER_RECORDS];
+
+static char g_TraceTestPhases[TRACETEST_MAX_EVENTS + 1];
+static char g_TraceTestNames[TRACETEST_MAX_EVENTS][32];
+static double g_TraceTestTimes[TRACETEST_MAX_EVENTS];
+static uint32 g_TraceTestEvents;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static boolean TraceTest_Is(uint32 a_Index, uint8 a_Event, uint8 a_Vector, uint16 a_Data)
+{
+    uint32 info = g_TraceTestRecords[a_Index].info;
+
+    return (TRACE_INFO_EVENT(info) == a_Event) && (TRACE_INFO_VECTOR(info) == a_Vector) &&
+           (TRACE_INFO_DATA(info) == a_Data);
+}
+
+/* Writes the snapshot as the target would dump it and runs tracedecode on it */
+static boolean TraceTest_Decode(void)
+{
+    char command[512];
+    char line[256];
+    const char *field;
+    FILE *file;
+    size_t length;
+
+    file = fopen(TRACETEST_DUMP, "wb");
+    if (file == NULL_PTR)
+    {
+        return FALSE;
+    }
+    (void)fwrite(&g_TraceTestHeader, sizeof(g_TraceTestHeader), 1, file);
+    (void)fwrite(g_TraceTestRecords, sizeof(Trace_RecordType), g_TraceTestHeader.count, file);
+    fclose(file);
+
+    snprintf(command, sizeof(command), "\"%s\" %s %s", g_TraceTestDecoder, TRACETEST_DUMP, TRACETEST_JSON);
+    if (system(command) != 0)
+    {
+        return FALSE;
+    }
+
+    file = fopen(TRACETEST_JSON, "r");
+    if (file == NULL_PTR)
+    {
+        return FALSE;
+    }
+
+    //One event per line: keep its phase, name and time stamp
+    g_TraceTestEvents = 0;
+    while ((fgets(line, sizeof(line), file) != NULL_PTR) && (g_TraceTestEvents < TRACETEST_MAX_EVENTS))
+    {
+        field = strstr(line, "\"ph\": \"");
+        if (field == NULL_PTR)
+        {
+            continue;
+        }
+        g_TraceTestPhases[g_TraceTestEvents] = field[7];
+
+        g_TraceTestNames[g_TraceTestEvents][0] = '\0';
+        field = strstr(line, "\"name\": \"");
+        if (field != NULL_PTR)
+        {
+            field += 9;
+            length = strcspn(field, "\"");
+            if (length >= sizeof(g_TraceTestNames[0]))
+            {
+                length = sizeof(g_TraceTestNames[0]) - 1;
+            }
+            memcpy(g_TraceTestNames[g_TraceTestEvents], field, length);
+            g_TraceTestNames[g_TraceTestEvents][length] = '\0';
+        }
+
+        field = strstr(line, "\"ts\": ");
+        g_TraceTestTimes[g_TraceTestEvents] = (field != NULL_PTR) ? atof(field + 6) : -1.0;
+        g_TraceTestEvents++;
+    }
+    g_TraceTestPhases[g_TraceTestEvents] = '\0';
+    fclose(file);
+    return TRUE;
+}
+
+/* Every E closes a B opened before it, and all of them are closed */
+static boolean TraceTest_Balanced(void)
+{
+    uint32 index;
+    uint32 depth = 0;
+
+    for (index = 0; index < g_TraceTestEvents; index++)
+    {
+        if (g_TraceTestPhases[index] == 'B')
+        {
+            depth++;
+        }
+        else if (g_TraceTestPhases[index] == 'E')
+        {
+            if (depth == 0)
+            {
+                return FALSE;
+            }
+            depth--;
+        }
+    }
+    return (boolean)(depth == 0);
+}
+
+/*
+ * Marker 1, the UART handler (100 cycles) preempted by the CAN handler
+ * (50), a tick, the UART handler preempted by a tick, marker 2, then the
+ * ring is frozen: marker 3 and the next tick are not recorded.
+ */
+static boolean TraceTest_Timeline(void)
+{
+    uint32 count;
+
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    Trace_Init(TRACETEST_CLOCK_HZ);
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+
+    TRACE_MARKER(1, 7);
+    TRACE_ISR_ENTER(TRACETEST_UART_VECTOR);
+    RegSim_SysTickAdvance(100);
+    TRACE_ISR_ENTER(TRACETEST_CAN_VECTOR);
+    RegSim_SysTickAdvance(50);
+    TRACE_ISR_EXIT(TRACETEST_CAN_VECTOR);
+    RegSim_SysTickAdvance(10);
+    TRACE_ISR_EXIT(TRACETEST_UART_VECTOR);
+    RegSim_SysTickAdvance(TRACETEST_TICK_CYCLES);
+
+    TRACE_ISR_ENTER(TRACETEST_UART_VECTOR);
+    RegSim_SysTickAdvance(TRACETEST_TICK_CYCLES);
+    TRACE_ISR_EXIT(TRACETEST_UART_VECTOR);
+    TRACE_MARKER(2, 9);
+
+    Trace_Freeze();
+    TRACETEST_CHECK(Trace_IsFrozen());
+    TRACE_MARKER(3, 0);
+    RegSim_SysTickAdvance(TRACETEST_TICK_CYCLES);
+
+    count = Trace_Snapshot(&g_TraceTestHeader, g_TraceTestRecords, TRACE_BUFFER_RECORDS);
+    TRACETEST_CHECK(Trace_IsFrozen()); // Left frozen by the copy
+    TRACETEST_CHECK((count == 14) && (g_TraceTestHeader.count == 14) && (g_TraceTestHeader.lost == 0));
+    TRACETEST_CHECK((g_TraceTestHeader.magic == TRACE_MAGIC) && (g_TraceTestHeader.clockHz == TRACETEST_CLOCK_HZ));
+
+    TRACETEST_CHECK(TraceTest_Is(0, TRACE_EVENT_MARKER, 1, 7));
+    TRACETEST_CHECK(TraceTest_Is(1, TRACE_EVENT_ISR_ENTER, TRACETEST_UART_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(2, TRACE_EVENT_ISR_ENTER, TRACETEST_CAN_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(3, TRACE_EVENT_ISR_EXIT, TRACETEST_CAN_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(4, TRACE_EVENT_ISR_EXIT, TRACETEST_UART_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(5, TRACE_EVENT_ISR_ENTER, TRACE_SYSTICK_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(6, TRACE_EVENT_TICK, TRACE_SYSTICK_VECTOR, 1));
+    TRACETEST_CHECK(TraceTest_Is(7, TRACE_EVENT_ISR_EXIT, TRACE_SYSTICK_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(8, TRACE_EVENT_ISR_ENTER, TRACETEST_UART_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(9, TRACE_EVENT_ISR_ENTER, TRACE_SYSTICK_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(12, TRACE_EVENT_ISR_EXIT, TRACETEST_UART_VECTOR, 0));
+    TRACETEST_CHECK(TraceTest_Is(13, TRACE_EVENT_MARKER, 2, 9));
+
+    TRACETEST_CHECK(g_TraceTestRecords[2].timeStamp - g_TraceTestRecords[1].timeStamp == 100);
+    TRACETEST_CHECK(g_TraceTestRecords[3].timeStamp - g_TraceTestRecords[2].timeStamp == 50);
+    TRACETEST_CHECK(g_TraceTestRecords[4].timeStamp - g_TraceTestRecords[3].timeStamp == 10);
+    TRACETEST_CHECK(g_TraceTestRecords[12].timeStamp - g_TraceTestRecords[8].timeStamp == TRACETEST_TICK_CYCLES);
+
+    /* The Chrome trace: nested slices, the ticks and markers as instants */
+    TRACETEST_CHECK(TraceTest_Decode());
+    TRACETEST_CHECK(strcmp(g_TraceTestPhases, "iBBEEBiEBBiEEi") == 0);
+    TRACETEST_CHECK(TraceTest_Balanced());
+    TRACETEST_CHECK((strcmp(g_TraceTestNames[1], "IRQ 5") == 0) && (strcmp(g_TraceTestNames[2], "IRQ 39") == 0));
+    TRACETEST_CHECK((strcmp(g_TraceTestNames[5], "SysTick") == 0) && (strcmp(g_TraceTestNames[6], "Tick") == 0));
+    TRACETEST_CHECK(strcmp(g_TraceTestNames[13], "Marker 2") == 0);
+    TRACETEST_CHECK(g_TraceTestTimes[2] - g_TraceTestTimes[1] == 6.25); // 100 cycles at 16MHz
+    TRACETEST_CHECK(g_TraceTestTimes[12] - g_TraceTestTimes[8] == 1000.0);
+
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*
+ * The UART handler runs while 300 markers overflow the ring: its entry is
+ * overwritten, the decoder drops the exit left without an entry.
+ */
+static boolean TraceTest_Wrap(void)
+{
+    uint32 count;
+    uint16 marker;
+
+    RegSim_Reset();
+    Trace_Init(TRACETEST_CLOCK_HZ);
+    TRACE_ISR_ENTER(TRACETEST_UART_VECTOR);
+    for (marker = 0; marker < TRACETEST_FLOOD_MARKERS; marker++)
+    {
+        TRACE_MARKER(1, marker);
+        RegSim_SysTickAdvance(10);
+    }
+    TRACE_ISR_EXIT(TRACETEST_UART_VECTOR);
+    Trace_Freeze();
+
+    count = Trace_Snapshot(&g_TraceTestHeader, g_TraceTestRecords, TRACE_BUFFER_RECORDS);
+    TRACETEST_CHECK(count == TRACE_BUFFER_RECORDS);
+    TRACETEST_CHECK(g_TraceTestHeader.lost == (TRACETEST_FLOOD_MARKERS + 2) - TRACE_BUFFER_RECORDS);
+    TRACETEST_CHECK(TraceTest_Is(0, TRACE_EVENT_MARKER, 1, (TRACETEST_FLOOD_MARKERS + 1) - TRACE_BUFFER_RECORDS));
+    TRACETEST_CHECK(TraceTest_Is(count - 1, TRACE_EVENT_ISR_EXIT, TRACETEST_UART_VECTOR, 0));
+
+    TRACETEST_CHECK(TraceTest_Decode());
+    TRACETEST_CHECK(g_TraceTestEvents == TRACE_BUFFER_RECORDS - 1);
+    TRACETEST_CHECK((strchr(g_TraceTestPhases, 'B') == NULL_PTR) && (strchr(g_TraceTestPhases, 'E') == NULL_PTR));
+
+    /* A snapshot smaller than the ring takes the newest records */
+    count = Trace_Snapshot(&g_TraceTestHeader, g_TraceTestRecords, 4);
+    TRACETEST_CHECK((count == 4) && TraceTest_Is(2, TRACE_EVENT_MARKER, 1, TRACETEST_FLOOD_MARKERS - 1));
+    TRACETEST_CHECK(g_TraceTestHeader.lost == (TRACETEST_FLOOD_MARKERS + 2) - 4);
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        printf("usage: %s tracedecode\n", argv[0]);
+        return 1;
+    }
+    g_TraceTestDecoder = argv[1];
+
+    if (!TraceTest_Timeline() || !TraceTest_Wrap())
+    {
+        return 1;
+    }
+
+    printf("TraceTest: all checks passed\n");
+    return 0;
+}
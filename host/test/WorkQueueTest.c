@@ -0,0 +1,247 @@
+/******************************************************************************
+ *
+ * Module: WorkQueueTest
+ *
+ * File Name: WorkQueueTest.c
+ *
+ * Description: Host test of the deferred work queues on the RegSim backend.
+ *              Checks a full ring dropping and counting the extra items,
+ *              the items run oldest first after the ring indexes wrap,
+ *              WorkQueue_Drain stopping at its batch limit on every ring
+ *              and leaving items posted during the drain for the next
+ *              call, and the SysTick deferred function posted to
+ *              WORKQUEUE_SYSTICK_QUEUE by the handler and run only by the
+ *              drain. Exits with 1 on the first failed check.
+ *
+ * Author: Saraa Gomaa
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "WorkQueue.h"
+#include "SysTick.h"
+#include "RegSim.h"
+
+#define WORKQUEUETEST_CHECK(Condition)                                                \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Condition))                                                             \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);      \
+            return FALSE;                                                             \
+        }                                                                             \
+    } while (0)
+
+/* 1 ms tick at 16MHz */
+#define WORKQUEUETEST_TICK_CYCLES            16000UL
+
+/* Ring used by the tests that do not involve SysTick */
+#define WORKQUEUETEST_QUEUE                  1
+
+#define WORKQUEUETEST_ITEMS                  (2 * WORKQUEUE_CAPACITY)
+
+static uint32 g_WorkQueueTestValues[WORKQUEUETEST_ITEMS];
+static uint32 g_WorkQueueTestLog[WORKQUEUETEST_ITEMS];
+static uint32 g_WorkQueueTestRuns;
+static uint32 g_WorkQueueTestIsrsAtRun;
+
+/*******************************************************************************
+ *                       Private Function Definitions                          *
+ *******************************************************************************/
+
+static void WorkQueueTest_Item(void *a_Argument)
+{
+    if (g_WorkQueueTestRuns < WORKQUEUETEST_ITEMS)
+    {
+        g_WorkQueueTestLog[g_WorkQueueTestRuns] = *(uint32 *)a_Argument;
+    }
+    g_WorkQueueTestRuns++;
+    g_WorkQueueTestIsrsAtRun = RegSim_GetSysTickIsrCount();
+}
+
+/* Posts itself once more while being drained */
+static void WorkQueueTest_Repost(void *a_Argument)
+{
+    WorkQueueTest_Item(a_Argument);
+    if (g_WorkQueueTestRuns == 1)
+    {
+        (void)WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Repost, a_Argument);
+    }
+}
+
+static void WorkQueueTest_Start(void)
+{
+    uint32 index;
+
+    WorkQueue_Init();
+    for (index = 0; index < WORKQUEUETEST_ITEMS; index++)
+    {
+        g_WorkQueueTestValues[index] = index;
+        g_WorkQueueTestLog[index] = 0;
+    }
+    g_WorkQueueTestRuns = 0;
+}
+
+/* Items a_First to a_First + a_Count - 1 were run in that order */
+static boolean WorkQueueTest_RanInOrder(uint32 a_First, uint32 a_Count)
+{
+    uint32 index;
+
+    if (g_WorkQueueTestRuns != a_Count)
+    {
+        return FALSE;
+    }
+    for (index = 0; index < a_Count; index++)
+    {
+        if (g_WorkQueueTestLog[index] != (a_First + index))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* A full ring drops and counts every further item, the other ring is untouched */
+static boolean WorkQueueTest_Full(void)
+{
+    uint32 index;
+
+    WorkQueueTest_Start();
+    for (index = 0; index < WORKQUEUE_CAPACITY; index++)
+    {
+        WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    }
+    WORKQUEUETEST_CHECK(!WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    WORKQUEUETEST_CHECK(!WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == WORKQUEUE_CAPACITY);
+    WORKQUEUETEST_CHECK(WorkQueue_GetOverflowCount(WORKQUEUETEST_QUEUE) == 2);
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUE_SYSTICK_QUEUE) == 0);
+    WORKQUEUETEST_CHECK(WorkQueue_GetOverflowCount(WORKQUEUE_SYSTICK_QUEUE) == 0);
+
+    /* No such ring */
+    WORKQUEUETEST_CHECK(!WorkQueue_Post(WORKQUEUE_COUNT, WorkQueueTest_Item, &g_WorkQueueTestValues[0]));
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUE_COUNT) == 0);
+    WORKQUEUETEST_CHECK(WorkQueue_GetOverflowCount(WORKQUEUE_COUNT) == 0);
+
+    /* The dropped items are not run, a freed slot takes a new one */
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == WORKQUEUE_CAPACITY);
+    WORKQUEUETEST_CHECK(WorkQueueTest_RanInOrder(0, WORKQUEUE_CAPACITY));
+    WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[0]));
+    WORKQUEUETEST_CHECK(WorkQueue_GetOverflowCount(WORKQUEUETEST_QUEUE) == 2);
+
+    WorkQueue_Init();
+    WORKQUEUETEST_CHECK((WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == 0) && (WorkQueue_GetOverflowCount(WORKQUEUETEST_QUEUE) == 0));
+    return TRUE;
+}
+
+/* Ring indexes past the end of the array: a full ring still runs oldest first */
+static boolean WorkQueueTest_WrapAround(void)
+{
+    uint32 index;
+
+    WorkQueueTest_Start();
+    for (index = 0; index < (WORKQUEUE_CAPACITY / 2) + 3; index++)
+    {
+        WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUETEST_QUEUE, NULL_PTR, NULL_PTR));
+    }
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == index); // A NULL_PTR function is skipped but counted
+    WORKQUEUETEST_CHECK(g_WorkQueueTestRuns == 0);
+
+    for (index = 0; index < WORKQUEUE_CAPACITY; index++)
+    {
+        WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    }
+    WORKQUEUETEST_CHECK(!WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == WORKQUEUE_CAPACITY);
+
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == WORKQUEUE_CAPACITY);
+    WORKQUEUETEST_CHECK(WorkQueueTest_RanInOrder(0, WORKQUEUE_CAPACITY));
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == 0);
+    return TRUE;
+}
+
+/* At most a_MaxItems per ring and call, items posted by a run item wait a call */
+static boolean WorkQueueTest_Batch(void)
+{
+    uint32 index;
+
+    WorkQueueTest_Start();
+    for (index = 0; index < 5; index++)
+    {
+        WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUE_SYSTICK_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    }
+    for (index = 10; index < 13; index++)
+    {
+        WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Item, &g_WorkQueueTestValues[index]));
+    }
+
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(2) == 4);
+    WORKQUEUETEST_CHECK((WorkQueue_GetPending(WORKQUEUE_SYSTICK_QUEUE) == 3) && (WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == 1));
+    WORKQUEUETEST_CHECK((g_WorkQueueTestLog[0] == 0) && (g_WorkQueueTestLog[1] == 1));
+    WORKQUEUETEST_CHECK((g_WorkQueueTestLog[2] == 10) && (g_WorkQueueTestLog[3] == 11));
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(2) == 3);
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(2) == 1);
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(2) == 0);
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(0) == 0);
+    WORKQUEUETEST_CHECK((g_WorkQueueTestRuns == 8) && (g_WorkQueueTestLog[7] == 4));
+
+    WorkQueueTest_Start();
+    WORKQUEUETEST_CHECK(WorkQueue_Post(WORKQUEUETEST_QUEUE, WorkQueueTest_Repost, &g_WorkQueueTestValues[7]));
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == 1);
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == 1);
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == 1);
+    WORKQUEUETEST_CHECK((g_WorkQueueTestRuns == 2) && (g_WorkQueueTestLog[1] == 7));
+    return TRUE;
+}
+
+/* The SysTick handler posts the deferred function, the drain runs it */
+static boolean WorkQueueTest_SysTick(void)
+{
+    WorkQueueTest_Start();
+    RegSim_Reset();
+    RegSim_SetSysTickHandler(SysTick_Handler);
+    SysTick_Init(1);
+    RegSim_SysTickAdvance(1); // The counter loads on the first cycle
+    SysTick_SetDeferredCallBack(WorkQueueTest_Item, &g_WorkQueueTestValues[5]);
+
+    RegSim_SysTickAdvance(3 * WORKQUEUETEST_TICK_CYCLES);
+    WORKQUEUETEST_CHECK(RegSim_GetSysTickIsrCount() == 3);
+    WORKQUEUETEST_CHECK(g_WorkQueueTestRuns == 0);
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUE_SYSTICK_QUEUE) == 3);
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUETEST_QUEUE) == 0);
+
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == 3);
+    WORKQUEUETEST_CHECK((g_WorkQueueTestRuns == 3) && (g_WorkQueueTestLog[2] == 5));
+    WORKQUEUETEST_CHECK(g_WorkQueueTestIsrsAtRun == 3);
+
+    /* A main loop too slow for the tick: the ring fills and counts the rest */
+    RegSim_SysTickAdvance((WORKQUEUE_CAPACITY + 4) * WORKQUEUETEST_TICK_CYCLES);
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUE_SYSTICK_QUEUE) == WORKQUEUE_CAPACITY);
+    WORKQUEUETEST_CHECK(WorkQueue_GetOverflowCount(WORKQUEUE_SYSTICK_QUEUE) == 4);
+
+    /* Stopped: the ticks post nothing more */
+    SysTick_SetDeferredCallBack(NULL_PTR, NULL_PTR);
+    WORKQUEUETEST_CHECK(WorkQueue_Drain(WORKQUEUETEST_ITEMS) == WORKQUEUE_CAPACITY);
+    RegSim_SysTickAdvance(2 * WORKQUEUETEST_TICK_CYCLES);
+    WORKQUEUETEST_CHECK(WorkQueue_GetPending(WORKQUEUE_SYSTICK_QUEUE) == 0);
+    WORKQUEUETEST_CHECK(WorkQueue_GetOverflowCount(WORKQUEUE_SYSTICK_QUEUE) == 4);
+
+    SysTick_DeInit();
+    return TRUE;
+}
+
+/*******************************************************************************
+ *                       Function Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+    if (!WorkQueueTest_Full() || !WorkQueueTest_WrapAround() || !WorkQueueTest_Batch() || !WorkQueueTest_SysTick())
+    {
+        return 1;
+    }
+
+    printf("WorkQueueTest: all checks passed\n");
+    return 0;
+}